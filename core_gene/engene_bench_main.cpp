@@ -0,0 +1,553 @@
+#include <EnGene.h>
+#include <core/scene.h>
+#include <core/scene_node_builder.h>
+#include <other_genes/3d_shapes/sphere.h>
+#include <gl_base/error.h>
+#include <gl_base/shader.h>
+#include <gl_base/material.h>
+#include <gl_base/texture.h>
+#include <gl_base/frame_stats.h>
+#include <components/all.h>
+#include <components/light_component.h>
+#include <components/material_component.h>
+#include <3d/lights/point_light.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Deterministic headless benchmark of synthetic scenes.
+//
+//   engene_bench --scenario wide_shared --out wide.json
+//   engene_bench --scenario deep_unique --nodes 2048 --baseline deep.json --threshold 0.1
+//
+// Every frame advances the simulation by exactly one fixed step, and the scene
+// is generated from a fixed seed, so two runs submit identical work. With
+// --baseline the run exits with status 2 if any metric is worse than the
+// baseline by more than --threshold (relative).
+
+#define GPU_QUERY_RING 8    // Frames a GPU timer query may stay in flight
+#define SCENE_SEED 1234u
+
+namespace {
+
+struct Scenario {
+    std::string name = "custom";
+    std::string hierarchy = "wide";  // "wide": siblings under one group, "deep": chains of `depth` nodes
+    int nodes = 1024;
+    int depth = 32;
+    int lights = 4;
+    int materials = 1;               // Unique material + texture pairs
+    bool shared_mesh = true;         // One Geometry for all nodes vs one per node
+    int mesh_detail = 12;            // Sphere stacks and slices
+    int warmup = 30;
+    int frames = 300;
+    int width = 1280;
+    int height = 720;
+};
+
+const std::map<std::string, Scenario>& presets() {
+    static std::map<std::string, Scenario> table = [] {
+        std::map<std::string, Scenario> t;
+        Scenario s;
+
+        s.name = "wide_shared";     s.hierarchy = "wide"; s.nodes = 4096; s.lights = 4;  s.materials = 1;   s.shared_mesh = true;
+        t[s.name] = s;
+        s.name = "wide_unique";     s.hierarchy = "wide"; s.nodes = 4096; s.lights = 4;  s.materials = 1;   s.shared_mesh = false;
+        t[s.name] = s;
+        s.name = "deep_shared";     s.hierarchy = "deep"; s.nodes = 4096; s.lights = 8;  s.materials = 16;  s.shared_mesh = true;
+        t[s.name] = s;
+        s.name = "deep_unique";     s.hierarchy = "deep"; s.nodes = 4096; s.lights = 8;  s.materials = 16;  s.shared_mesh = false;
+        t[s.name] = s;
+        s.name = "many_materials";  s.hierarchy = "wide"; s.nodes = 4096; s.lights = 16; s.materials = 512; s.shared_mesh = true;
+        t[s.name] = s;
+        return t;
+    }();
+    return table;
+}
+
+// Lit, textured shader with all scene lights (no per-object selection)
+const char* BENCH_VERTEX_SHADER = R"(
+    #version 410 core
+    layout (location = 0) in vec3 a_pos;
+    layout (location = 1) in vec3 a_normal;
+    layout (location = 3) in vec2 a_texCoord;
+
+    out vec3 v_fragPos;
+    out vec3 v_normal;
+    out vec2 v_texCoord;
+
+    layout (std140) uniform CameraMatrices {
+        mat4 view;
+        mat4 projection;
+    };
+
+    uniform mat4 u_model;
+
+    void main() {
+        vec4 world = u_model * vec4(a_pos, 1.0);
+        v_fragPos = world.xyz;
+        v_normal = mat3(u_model) * a_normal;
+        v_texCoord = a_texCoord;
+        gl_Position = projection * view * world;
+    }
+)";
+
+const char* BENCH_FRAGMENT_SHADER = R"(
+    #version 410 core
+    #define MAX_SCENE_LIGHTS 16
+
+    struct LightData {
+        vec4 position;
+        vec4 direction;
+        vec4 ambient;
+        vec4 diffuse;
+        vec4 specular;
+        vec4 attenuation;
+        int type;
+        int pad1;
+        int pad2;
+        int pad3;
+    };
+
+    layout (std140) uniform SceneLights {
+        LightData lights[MAX_SCENE_LIGHTS];
+        int active_light_count;
+    } sceneLights;
+
+    uniform vec3  u_material_ambient;
+    uniform vec3  u_material_diffuse;
+    uniform vec3  u_material_specular;
+    uniform float u_material_shininess;
+    uniform sampler2D u_albedo;
+
+    in vec3 v_fragPos;
+    in vec3 v_normal;
+    in vec2 v_texCoord;
+    out vec4 FragColor;
+
+    void main() {
+        vec3 albedo = texture(u_albedo, v_texCoord).rgb;
+        vec3 n = normalize(v_normal);
+        vec3 view_dir = vec3(0.0, 0.0, 1.0);
+        vec3 color = vec3(0.0);
+        for (int i = 0; i < sceneLights.active_light_count; ++i) {
+            LightData light = sceneLights.lights[i];
+            vec3 to_light = light.position.xyz - v_fragPos;
+            float dist = length(to_light);
+            vec3 l = to_light / max(dist, 1e-4);
+            float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * dist +
+                                       light.attenuation.z * dist * dist);
+            float diff = max(dot(n, l), 0.0);
+            float spec = pow(max(dot(view_dir, reflect(-l, n)), 0.0), u_material_shininess);
+            color += light.ambient.rgb * u_material_ambient * albedo;
+            color += (light.diffuse.rgb * diff * u_material_diffuse * albedo +
+                      light.specular.rgb * spec * u_material_specular) * attenuation;
+        }
+        FragColor = vec4(color, 1.0);
+    }
+)";
+
+void printUsage() {
+    std::cout <<
+        "Usage: engene_bench [options]\n"
+        "  --scenario NAME     Preset: wide_shared, wide_unique, deep_shared, deep_unique, many_materials\n"
+        "  --hierarchy wide|deep\n"
+        "  --nodes N           Drawn scene nodes\n"
+        "  --depth D           Chain length for the deep hierarchy\n"
+        "  --lights M          Point lights (at most " << MAX_SCENE_LIGHTS << ")\n"
+        "  --materials K       Unique material/texture pairs\n"
+        "  --mesh shared|unique\n"
+        "  --mesh-detail S     Sphere stacks and slices\n"
+        "  --warmup F          Frames excluded from the metrics\n"
+        "  --frames F          Measured frames\n"
+        "  --size WxH          Render target size\n"
+        "  --out FILE          Write JSON results to FILE (default: stdout)\n"
+        "  --baseline FILE     Compare against a previous JSON result\n"
+        "  --threshold R       Allowed relative regression (default: 0.10)\n"
+        "  --min-delta-ms T    Ignore timing regressions smaller than T ms (default: 0.05)\n";
+}
+
+struct Percentiles {
+    double min = 0.0, avg = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+Percentiles percentiles(std::vector<double> values) {
+    Percentiles p;
+    if (values.empty()) {
+        return p;
+    }
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](double q) {
+        return values[static_cast<size_t>(q * static_cast<double>(values.size() - 1) + 0.5)];
+    };
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    p.min = values.front();
+    p.max = values.back();
+    p.avg = sum / static_cast<double>(values.size());
+    p.p50 = rank(0.50);
+    p.p95 = rank(0.95);
+    p.p99 = rank(0.99);
+    return p;
+}
+
+// Reads the flat "metrics" object written by writeJson()
+bool readBaselineMetrics(const std::string& path, std::map<std::string, double>& metrics) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    size_t pos = text.find("\"metrics\"");
+    if (pos == std::string::npos) return false;
+    pos = text.find('{', pos);
+    size_t end = text.find('}', pos);
+    if (pos == std::string::npos || end == std::string::npos) return false;
+
+    while (true) {
+        size_t key_start = text.find('"', pos);
+        if (key_start == std::string::npos || key_start > end) break;
+        size_t key_end = text.find('"', key_start + 1);
+        size_t colon = text.find(':', key_end);
+        std::string key = text.substr(key_start + 1, key_end - key_start - 1);
+        const char* number_start = text.c_str() + colon + 1;
+        char* number_end = nullptr;
+        metrics[key] = std::strtod(number_start, &number_end);
+        pos = static_cast<size_t>(number_end - text.c_str());
+    }
+    return !metrics.empty();
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    Scenario sc;
+    std::string out_path;
+    std::string baseline_path;
+    double threshold = 0.10;
+    double min_delta_ms = 0.05;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        else if (arg == "--scenario") {
+            std::string name = value();
+            auto it = presets().find(name);
+            if (it == presets().end()) {
+                std::cerr << "Unknown scenario '" << name << "'" << std::endl;
+                return 1;
+            }
+            sc = it->second;
+        }
+        else if (arg == "--hierarchy") sc.hierarchy = value();
+        else if (arg == "--nodes") sc.nodes = std::atoi(value().c_str());
+        else if (arg == "--depth") sc.depth = std::atoi(value().c_str());
+        else if (arg == "--lights") sc.lights = std::atoi(value().c_str());
+        else if (arg == "--materials") sc.materials = std::atoi(value().c_str());
+        else if (arg == "--mesh") sc.shared_mesh = value() != "unique";
+        else if (arg == "--mesh-detail") sc.mesh_detail = std::atoi(value().c_str());
+        else if (arg == "--warmup") sc.warmup = std::atoi(value().c_str());
+        else if (arg == "--frames") sc.frames = std::atoi(value().c_str());
+        else if (arg == "--size") {
+            std::string size = value();
+            if (std::sscanf(size.c_str(), "%dx%d", &sc.width, &sc.height) != 2) {
+                std::cerr << "Invalid --size '" << size << "', expected WxH" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--out") out_path = value();
+        else if (arg == "--baseline") baseline_path = value();
+        else if (arg == "--threshold") threshold = std::atof(value().c_str());
+        else if (arg == "--min-delta-ms") min_delta_ms = std::atof(value().c_str());
+        else {
+            std::cerr << "Unknown option '" << arg << "'" << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    sc.nodes = std::max(sc.nodes, 1);
+    sc.depth = sc.hierarchy == "deep" ? std::max(sc.depth, 1) : 1;
+    sc.lights = std::clamp(sc.lights, 0, MAX_SCENE_LIGHTS);
+    sc.materials = std::max(sc.materials, 1);
+    sc.frames = std::max(sc.frames, 1);
+    sc.warmup = std::max(sc.warmup, 0);
+
+    const int total_frames = sc.warmup + sc.frames;
+    std::vector<double> cpu_ms;
+    std::vector<double> gpu_ms;
+    cpu_ms.reserve(total_frames);
+    gpu_ms.reserve(total_frames);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point last_frame_end;
+    transform::TransformPtr scene_root;
+    GLuint gpu_queries[GPU_QUERY_RING] = {};
+    int gpu_frame = 0;
+
+    auto collect_gpu = [&](int frame) {
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(gpu_queries[frame % GPU_QUERY_RING], GL_QUERY_RESULT, &elapsed_ns);
+        if (frame >= sc.warmup) {
+            gpu_ms.push_back(static_cast<double>(elapsed_ns) * 1e-6);
+        }
+    };
+
+    auto on_init = [&](engene::EnGene& app) {
+        auto shader = app.getBaseShader();
+        shader->configureDynamicUniform<glm::mat4>("u_model", transform::current);
+        shader->configureDynamicUniform<uniform::detail::Sampler>("u_albedo", texture::getSamplerProvider("u_albedo"));
+        light::manager().bindToShader(shader);
+        material::Material::SetDefaultAmbientName("u_material_ambient");
+        material::Material::SetDefaultDiffuseName("u_material_diffuse");
+        material::Material::SetDefaultSpecularName("u_material_specular");
+        material::Material::SetDefaultShininessName("u_material_shininess");
+        material::stack()->configureShaderDefaults(shader);
+
+        std::mt19937 rng(SCENE_SEED);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        // K material/texture pairs (4x4 procedural textures)
+        std::vector<material::MaterialPtr> materials;
+        std::vector<texture::TexturePtr> textures;
+        for (int k = 0; k < sc.materials; ++k) {
+            glm::vec3 color(0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng));
+            materials.push_back(material::Material::Make(color)->setShininess(8.0f + 120.0f * unit(rng)));
+
+            unsigned char pixels[4 * 4 * 4];
+            for (int p = 0; p < 16; ++p) {
+                unsigned char shade = ((p + p / 4) % 2) ? 255 : static_cast<unsigned char>(128 + 127 * unit(rng));
+                pixels[p * 4 + 0] = shade;
+                pixels[p * 4 + 1] = shade;
+                pixels[p * 4 + 2] = shade;
+                pixels[p * 4 + 3] = 255;
+            }
+            textures.push_back(texture::Texture::Make(4, 4, pixels));
+        }
+
+        geometry::GeometryPtr shared_mesh;
+        if (sc.shared_mesh) {
+            shared_mesh = Sphere::Make(sc.mesh_detail, sc.mesh_detail);
+        }
+
+        // Nodes are laid out on a grid of chains; a wide hierarchy is a grid of chains of length 1
+        scene_root = transform::Transform::Make();
+        scene::graph()->addNode("bench").with<component::TransformComponent>(scene_root);
+
+        const int chains = (sc.nodes + sc.depth - 1) / sc.depth;
+        const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(chains))));
+        const float cell = 1.8f / static_cast<float>(columns);
+        const float radius = 0.4f * std::min(cell, 1.8f / (2.2f * static_cast<float>(sc.depth)));
+
+        int node_index = 0;
+        for (int chain = 0; chain < chains && node_index < sc.nodes; ++chain) {
+            float x = -0.9f + (static_cast<float>(chain % columns) + 0.5f) * cell;
+            float y = -0.9f + (static_cast<float>(chain / columns) + 0.5f) * cell;
+            std::string parent = "bench";
+
+            for (int link = 0; link < sc.depth && node_index < sc.nodes; ++link, ++node_index) {
+                std::string name = "n" + std::to_string(node_index);
+                // Chain roots carry the placement and scale; links step along +y in scaled space
+                auto transform = link == 0
+                    ? transform::Transform::Make()->translate(x, y, 0.0f)->scale(radius, radius, radius)
+                    : transform::Transform::Make()->translate(0.0f, 2.2f, 0.0f);
+
+                scene::graph()->buildAt(parent)
+                .addNode(name)
+                    .with<component::TransformComponent>(transform)
+                    .with<component::GeometryComponent>(
+                        sc.shared_mesh ? shared_mesh : Sphere::Make(sc.mesh_detail, sc.mesh_detail),
+                        name + "_mesh"
+                    )
+                    .with<component::MaterialComponent>(materials[node_index % sc.materials])
+                    .with<component::TextureComponent>(textures[node_index % sc.materials], "u_albedo", 0);
+                parent = name;
+            }
+        }
+
+        for (int l = 0; l < sc.lights; ++l) {
+            float angle = 6.2831853f * static_cast<float>(l) / static_cast<float>(std::max(sc.lights, 1));
+            light::PointLightParams params;
+            params.position = glm::vec4(0.8f * std::cos(angle), 0.8f * std::sin(angle), 0.6f, 1.0f);
+            scene::graph()->buildAt("bench")
+            .addNode("light" + std::to_string(l))
+                .with<component::LightComponent>(
+                    light::PointLight::Make(params),
+                    transform::Transform::Make()
+                );
+        }
+        light::manager().apply();
+
+        glGenQueries(GPU_QUERY_RING, gpu_queries);
+        stats::history().setWindowSize(static_cast<size_t>(sc.frames));
+        stats::history().setFrameCallback([&](const stats::FrameStats&) {
+            Clock::time_point now = Clock::now();
+            cpu_ms.push_back(std::chrono::duration<double, std::milli>(now - last_frame_end).count());
+            last_frame_end = now;
+        });
+        last_frame_end = Clock::now();
+    };
+
+    auto on_fixed_update = [&](double fixed_timestep) {
+        // Constant work per step: one root rotation, dirtying every world transform below it
+        scene_root->rotate(static_cast<float>(fixed_timestep * 10.0), 0.0f, 0.0f, 1.0f);
+    };
+
+    auto on_render = [&](double alpha) {
+        if (gpu_frame >= GPU_QUERY_RING) {
+            collect_gpu(gpu_frame - GPU_QUERY_RING);
+        }
+        glBeginQuery(GL_TIME_ELAPSED, gpu_queries[gpu_frame % GPU_QUERY_RING]);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        scene::graph()->draw();
+
+        glEndQuery(GL_TIME_ELAPSED);
+        ++gpu_frame;
+    };
+
+    try {
+        engene::EnGeneConfig config;
+        config.width = sc.width;
+        config.height = sc.height;
+        config.title = "EnGene Benchmark";
+        config.headless = true;
+        config.headlessFrames = total_frames;
+        config.base_vertex_shader_source = BENCH_VERTEX_SHADER;
+        config.base_fragment_shader_source = BENCH_FRAGMENT_SHADER;
+
+        engene::EnGene app(
+            on_init,
+            on_fixed_update,
+            on_render,
+            config
+        );
+
+        app.run();
+
+        // run() ends with glFinish(), so the remaining queries are ready
+        for (int frame = std::max(0, gpu_frame - GPU_QUERY_RING); frame < gpu_frame; ++frame) {
+            collect_gpu(frame);
+        }
+        glDeleteQueries(GPU_QUERY_RING, gpu_queries);
+
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // --- Metrics ---
+    std::vector<double> measured_cpu(cpu_ms.begin() + std::min<size_t>(cpu_ms.size(), sc.warmup), cpu_ms.end());
+    Percentiles cpu = percentiles(measured_cpu);
+    Percentiles gpu = percentiles(gpu_ms);
+
+    std::vector<std::pair<std::string, double>> metrics = {
+        {"cpu_ms_min", cpu.min}, {"cpu_ms_avg", cpu.avg}, {"cpu_ms_p50", cpu.p50},
+        {"cpu_ms_p95", cpu.p95}, {"cpu_ms_p99", cpu.p99}, {"cpu_ms_max", cpu.max},
+        {"gpu_ms_avg", gpu.avg}, {"gpu_ms_p50", gpu.p50}, {"gpu_ms_p95", gpu.p95}, {"gpu_ms_p99", gpu.p99},
+    };
+    const std::pair<const char*, stats::FrameStatsHistory::Counter> counters[] = {
+        {"draw_calls", &stats::FrameStats::draw_calls},
+        {"indices", &stats::FrameStats::indices},
+        {"program_switches", &stats::FrameStats::program_switches},
+        {"texture_binds", &stats::FrameStats::texture_binds},
+        {"fbo_binds", &stats::FrameStats::fbo_binds},
+        {"state_syncs", &stats::FrameStats::state_syncs},
+        {"uniform_uploads", &stats::FrameStats::uniform_uploads},
+        {"ubo_bytes", &stats::FrameStats::ubo_bytes},
+        {"nodes_visited", &stats::FrameStats::nodes_visited},
+        {"nodes_culled", &stats::FrameStats::nodes_culled},
+    };
+    for (const auto& counter : counters) {
+        metrics.emplace_back(counter.first, stats::history().summarize(counter.second).avg);
+    }
+    metrics.emplace_back("arena_high_water_bytes", static_cast<double>(arena::frame().getStats().high_water_mark));
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4)
+         << "{\n"
+         << "  \"scenario\": {\n"
+         << "    \"name\": \"" << sc.name << "\",\n"
+         << "    \"hierarchy\": \"" << sc.hierarchy << "\",\n"
+         << "    \"nodes\": " << sc.nodes << ",\n"
+         << "    \"depth\": " << sc.depth << ",\n"
+         << "    \"lights\": " << sc.lights << ",\n"
+         << "    \"materials\": " << sc.materials << ",\n"
+         << "    \"mesh\": \"" << (sc.shared_mesh ? "shared" : "unique") << "\",\n"
+         << "    \"mesh_detail\": " << sc.mesh_detail << ",\n"
+         << "    \"warmup\": " << sc.warmup << ",\n"
+         << "    \"frames\": " << sc.frames << ",\n"
+         << "    \"width\": " << sc.width << ",\n"
+         << "    \"height\": " << sc.height << "\n"
+         << "  },\n"
+         << "  \"metrics\": {\n";
+    for (size_t i = 0; i < metrics.size(); ++i) {
+        json << "    \"" << metrics[i].first << "\": " << metrics[i].second
+             << (i + 1 < metrics.size() ? ",\n" : "\n");
+    }
+    json << "  }\n}\n";
+
+    if (out_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream out(out_path);
+        out << json.str();
+        if (!out) {
+            std::cerr << "Could not write '" << out_path << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    // --- Baseline comparison: every metric is lower-is-better ---
+    if (!baseline_path.empty()) {
+        std::map<std::string, double> baseline;
+        if (!readBaselineMetrics(baseline_path, baseline)) {
+            std::cerr << "Could not read metrics from baseline '" << baseline_path << "'" << std::endl;
+            return 1;
+        }
+
+        int regressions = 0;
+        for (const auto& [name, value] : metrics) {
+            auto it = baseline.find(name);
+            if (it == baseline.end()) continue;
+            double base = it->second;
+            bool is_timing = name.find("_ms_") != std::string::npos;
+            double allowed = base * (1.0 + threshold);
+            bool regressed = value > allowed && (!is_timing || value - base > min_delta_ms);
+            if (regressed) {
+                ++regressions;
+                std::cerr << "REGRESSION " << name << ": " << base << " -> " << value
+                          << " (+" << (base > 0.0 ? (value / base - 1.0) * 100.0 : 100.0) << "%)" << std::endl;
+            }
+        }
+        if (regressions > 0) {
+            std::cerr << regressions << " metric(s) regressed beyond " << threshold * 100.0 << "%" << std::endl;
+            return 2;
+        }
+        std::cerr << "No regressions against " << baseline_path << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,896 @@
+#define ENGENE_ALLOC_TRACKING 1  // Counts heap allocations per iteration and per frame
+#define ENGENE_ALLOC_TRACKING_IMPLEMENTATION
+#include <EnGene.h>
+#include <gl_base/gl_stub.h>
+#include <core/scene.h>
+#include <core/scene_node_builder.h>
+#include <components/all.h>
+#include <gl_base/shader.h>
+#include <gl_base/material.h>
+#include <gl_base/texture.h>
+#include <gl_base/transform.h>
+#include <other_genes/grid.h>
+#include <other_genes/3d_shapes/sphere.h>
+#include <3d/camera/perspective_camera.h>
+#include <3d/lights/point_light.h>
+#include <ecs/world.h>
+#include <ecs/systems.h>
+#include <core/sim_pipeline.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU microbenchmarks of the scene graph hot paths. GL functions are loaded
+// from gl_base/gl_stub.h, so this runs on machines without a GPU or display.
+//
+//   engene_microbench [--filter SUBSTRING] [--min-time SECONDS] [--json FILE]
+//                     [--require-zero-alloc]
+//
+// Every result reports time, heap allocations and allocated bytes per
+// iteration (core/alloc_tracker.h). --json writes the Google Benchmark JSON
+// layout, so its compare tooling can diff two runs. --require-zero-alloc
+// exits with status 2 if a steady-state frame (Frame_*) allocates, printing
+// the allocations per subsystem.
+
+#define DEFAULT_MIN_TIME 0.2    // Seconds each benchmark runs after calibration
+
+// --- Minimal Google Benchmark-style harness ---
+
+namespace bench {
+
+/**
+ * @brief Keeps the compiler from discarding a value computed inside the loop.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Passed to every benchmark; `for (auto _ : state)` runs the timed loop.
+ */
+class State {
+public:
+    State(uint64_t iterations, int64_t arg) : m_iterations(iterations), m_arg(arg) {}
+
+    int64_t range() const { return m_arg; }
+    uint64_t iterations() const { return m_iterations; }
+
+    struct __attribute__((unused)) Value {};  // Type of `_`; the attribute silences -Wunused-variable
+
+    struct Iterator {
+        State* state;
+        uint64_t remaining;
+        bool operator!=(const Iterator&) const {
+            if (remaining == 0) {
+                state->stop();
+                return false;
+            }
+            return true;
+        }
+        void operator++() { --remaining; }
+        Value operator*() const { return Value(); }
+    };
+
+    Iterator begin() {
+        start();
+        return Iterator{this, m_iterations};
+    }
+    Iterator end() { return Iterator{this, 0}; }
+
+    double seconds() const { return m_seconds; }
+    uint64_t allocations() const { return m_allocations; }
+    uint64_t bytes() const { return m_bytes; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t m_iterations;
+    int64_t m_arg;
+    Clock::time_point m_start;
+    uint64_t m_start_allocations = 0;
+    uint64_t m_start_bytes = 0;
+    double m_seconds = 0.0;
+    uint64_t m_allocations = 0;
+    uint64_t m_bytes = 0;
+
+    void start() {
+        allocation::Count count = allocation::tracker().total();
+        m_start_allocations = count.allocations;
+        m_start_bytes = count.bytes;
+        m_start = Clock::now();
+    }
+
+    void stop() {
+        m_seconds = std::chrono::duration<double>(Clock::now() - m_start).count();
+        allocation::Count count = allocation::tracker().total();
+        m_allocations = count.allocations - m_start_allocations;
+        m_bytes = count.bytes - m_start_bytes;
+    }
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(State&)> function;
+    std::vector<int64_t> args;
+
+    Benchmark* Arg(int64_t arg) {
+        args.push_back(arg);
+        return this;
+    }
+};
+
+inline std::vector<Benchmark*>& registry() {
+    static std::vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+inline Benchmark* registerBenchmark(const char* name, std::function<void(State&)> function) {
+    registry().push_back(new Benchmark{name, std::move(function), {}});
+    return registry().back();
+}
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_iter;
+    double allocs_per_iter;
+    double bytes_per_iter;
+};
+
+/**
+ * @brief Grows the iteration count until one run lasts about min_time seconds.
+ */
+inline Result run(const Benchmark& benchmark, int64_t arg, const std::string& name, double min_time) {
+    uint64_t iterations = 1;
+    while (true) {
+        State state(iterations, arg);
+        benchmark.function(state);
+
+        bool last = state.seconds() >= min_time || iterations >= 1000000000ull;
+        if (last) {
+            double n = static_cast<double>(iterations);
+            return Result{name, iterations, state.seconds() * 1e9 / n,
+                          static_cast<double>(state.allocations()) / n,
+                          static_cast<double>(state.bytes()) / n};
+        }
+
+        // Aim 40% past the target so the next run is usually the last
+        double per_iter = state.seconds() / static_cast<double>(iterations);
+        uint64_t predicted = per_iter > 0.0
+            ? static_cast<uint64_t>(min_time * 1.4 / per_iter)
+            : iterations * 100;
+        iterations = std::max(iterations + 1, std::min(predicted, iterations * 100));
+    }
+}
+
+} // namespace bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(fn) \
+    static bench::Benchmark* BENCH_CONCAT(bench_registration_, __LINE__) = bench::registerBenchmark(#fn, fn)
+
+
+// --- Fixtures ---
+
+namespace {
+
+const char* BENCH_VERTEX_SHADER = R"(
+    #version 410 core
+    layout (location = 0) in vec3 a_pos;
+    layout (std140) uniform CameraMatrices { mat4 view; mat4 projection; };
+    uniform mat4 u_model;
+    void main() { gl_Position = projection * view * u_model * vec4(a_pos, 1.0); }
+)";
+
+const char* BENCH_FRAGMENT_SHADER = R"(
+    #version 410 core
+    uniform vec3 u_material_diffuse;
+    out vec4 FragColor;
+    void main() { FragColor = vec4(u_material_diffuse, 1.0); }
+)";
+
+// Textured and lit: exercises sampler providers and the SceneLights block
+const char* FRAME_FRAGMENT_SHADER = R"(
+    #version 410 core
+    struct LightData { vec4 position; vec4 direction; vec4 ambient; vec4 diffuse;
+                       vec4 specular; vec4 attenuation; int type; int pad1; int pad2; int pad3; };
+    layout (std140) uniform SceneLights { LightData lights[16]; int active_light_count; } sceneLights;
+    uniform vec3 u_material_diffuse;
+    uniform sampler2D u_albedo;
+    out vec4 FragColor;
+    void main() {
+        vec3 color = vec3(0.0);
+        for (int i = 0; i < sceneLights.active_light_count; ++i) {
+            color += sceneLights.lights[i].diffuse.rgb * u_material_diffuse;
+        }
+        FragColor = vec4(color * texture(u_albedo, vec2(0.5)).rgb, 1.0);
+    }
+)";
+
+int g_fixture_id = 0;
+
+/**
+ * @brief Subtree of the global scene graph, removed when the fixture goes out of scope.
+ */
+struct SceneFixture {
+    std::string root_name;
+    scene::SceneNodePtr root;
+    transform::TransformPtr root_transform;
+
+    SceneFixture() : root_name("bench_" + std::to_string(g_fixture_id++)) {
+        root_transform = transform::Transform::Make();
+        scene::graph()->addNode(root_name).with<component::TransformComponent>(root_transform);
+        root = scene::graph()->getNodeByName(root_name);
+    }
+
+    ~SceneFixture() {
+        scene::graph()->removeNode(root);
+    }
+
+    std::string nodeName(int64_t i) const { return root_name + "_" + std::to_string(i); }
+
+    /** Builds `count` children of the root, each with a TransformComponent (and optional extras) */
+    template <typename Extra>
+    void addWide(int64_t count, Extra&& extra) {
+        for (int64_t i = 0; i < count; ++i) {
+            auto builder = scene::graph()->buildAt(root_name).addNode(nodeName(i));
+            builder.with<component::TransformComponent>(transform::Transform::Make()->translate(0.01f, 0.0f, 0.0f));
+            extra(builder, i);
+        }
+    }
+
+    /** Builds a chain of `count` nested nodes below the root; returns the leaf's name */
+    template <typename Extra>
+    std::string addDeep(int64_t count, Extra&& extra) {
+        std::string parent = root_name;
+        for (int64_t i = 0; i < count; ++i) {
+            std::string name = nodeName(i);
+            auto builder = scene::graph()->buildAt(parent).addNode(name);
+            builder.with<component::TransformComponent>(transform::Transform::Make()->translate(0.0f, 0.01f, 0.0f));
+            extra(builder, i);
+            parent = name;
+        }
+        return parent;
+    }
+};
+
+auto noExtra = [](scene::SceneNodeBuilder&, int64_t) {};
+
+shader::ShaderPtr benchShader() {
+    static shader::ShaderPtr shader = [] {
+        auto s = shader::Shader::Make();
+        s->AttachVertexShader(BENCH_VERTEX_SHADER);
+        s->AttachFragmentShader(BENCH_FRAGMENT_SHADER);
+        s->configureDynamicUniform<glm::mat4>("u_model", transform::current);
+        material::stack()->configureShaderDefaults(s);
+        scene::graph()->getActiveCamera()->bindToShader(s);
+        s->Bake();
+        return s;
+    }();
+    return shader;
+}
+
+shader::ShaderPtr frameShader() {
+    static shader::ShaderPtr shader = [] {
+        auto s = shader::Shader::Make();
+        s->AttachVertexShader(BENCH_VERTEX_SHADER);
+        s->AttachFragmentShader(FRAME_FRAGMENT_SHADER);
+        s->configureDynamicUniform<glm::mat4>("u_model", transform::current);
+        s->configureDynamicUniform<uniform::detail::Sampler>("u_albedo", texture::getSamplerProvider("u_albedo"));
+        material::stack()->configureShaderDefaults(s);
+        light::manager().bindToShader(s);
+        scene::graph()->getActiveCamera()->bindToShader(s);
+        s->Bake();
+        return s;
+    }();
+    return shader;
+}
+
+// Per-subsystem report of the first allocating Frame_* iteration, for --require-zero-alloc
+std::string g_frame_alloc_report;
+
+} // namespace
+
+
+// --- Benchmarks ---
+
+static void Grid_Make(bench::State& state) {
+    for (auto _ : state) {
+        auto grid = Grid::Make(static_cast<int>(state.range()), static_cast<int>(state.range()));
+        bench::doNotOptimize(grid->GetIndices());
+    }
+}
+BENCHMARK(Grid_Make)->Arg(8)->Arg(64);
+
+static void TransformStack_PushPop(bench::State& state) {
+    glm::mat4 step = glm::translate(glm::mat4(1.0f), glm::vec3(0.1f, 0.0f, 0.0f));
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(); ++i) {
+            transform::stack()->push(step);
+        }
+        bench::doNotOptimize(transform::stack()->top());
+        for (int64_t i = 0; i < state.range(); ++i) {
+            transform::stack()->pop();
+        }
+    }
+}
+BENCHMARK(TransformStack_PushPop)->Arg(1)->Arg(32);
+
+// Batched math from utils/simd_math.h against the glm loop it replaces
+static std::vector<glm::mat4> makeMatrices(int64_t count) {
+    std::vector<glm::mat4> matrices(static_cast<size_t>(count));
+    for (size_t i = 0; i < matrices.size(); ++i) {
+        matrices[i] = glm::translate(glm::mat4(1.0f), glm::vec3(float(i), 1.0f, 2.0f));
+    }
+    return matrices;
+}
+
+static void Mat4_MultiplyGlm(bench::State& state) {
+    const glm::mat4 parent = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, 0.25f, 0.0f));
+    std::vector<glm::mat4> local = makeMatrices(state.range());
+    std::vector<glm::mat4> world(local.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < local.size(); ++i) {
+            world[i] = parent * local[i];
+        }
+        bench::doNotOptimize(world.back());
+    }
+}
+BENCHMARK(Mat4_MultiplyGlm)->Arg(64)->Arg(4096);
+
+static void Mat4_MultiplySimd(bench::State& state) {
+    const glm::mat4 parent = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, 0.25f, 0.0f));
+    std::vector<glm::mat4> local = makeMatrices(state.range());
+    std::vector<glm::mat4> world(local.size());
+    for (auto _ : state) {
+        simd::multiply(parent, local.data(), world.data(), local.size());
+        bench::doNotOptimize(world.back());
+    }
+}
+BENCHMARK(Mat4_MultiplySimd)->Arg(64)->Arg(4096);
+
+static void Vec4_TransformGlm(bench::State& state) {
+    const glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, 0.25f, 0.0f));
+    std::vector<glm::vec4> points(static_cast<size_t>(state.range()), glm::vec4(1.0f, 2.0f, 3.0f, 1.0f));
+    std::vector<glm::vec4> out(points.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            out[i] = m * points[i];
+        }
+        bench::doNotOptimize(out.back());
+    }
+}
+BENCHMARK(Vec4_TransformGlm)->Arg(4096);
+
+static void Vec4_TransformSimd(bench::State& state) {
+    const glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, 0.25f, 0.0f));
+    std::vector<glm::vec4> points(static_cast<size_t>(state.range()), glm::vec4(1.0f, 2.0f, 3.0f, 1.0f));
+    std::vector<glm::vec4> out(points.size());
+    for (auto _ : state) {
+        simd::transform(m, points.data(), out.data(), points.size());
+        bench::doNotOptimize(out.back());
+    }
+}
+BENCHMARK(Vec4_TransformSimd)->Arg(4096);
+
+// Node with range() TransformComponents followed by a MaterialComponent (the worst case for get<T>())
+static scene::SceneNodePtr makeComponentNode(SceneFixture& fixture, int64_t transforms) {
+    auto builder = scene::graph()->buildAt(fixture.root_name).addNode(fixture.nodeName(0));
+    for (int64_t i = 0; i < transforms; ++i) {
+        builder.with<component::TransformComponent>(transform::Transform::Make());
+    }
+    builder.with<component::MaterialComponent>(material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f)));
+    return scene::graph()->getNodeByName(fixture.nodeName(0));
+}
+
+static void ComponentCollection_Get(bench::State& state) {
+    SceneFixture fixture;
+    auto node = makeComponentNode(fixture, state.range());
+    for (auto _ : state) {
+        bench::doNotOptimize(node->payload().get<component::MaterialComponent>());
+    }
+}
+BENCHMARK(ComponentCollection_Get)->Arg(1)->Arg(8);
+
+static void ComponentCollection_GetAll(bench::State& state) {
+    SceneFixture fixture;
+    auto node = makeComponentNode(fixture, state.range());
+    for (auto _ : state) {
+        for (component::TransformComponent& transform_comp : node->payload().getAll<component::TransformComponent>()) {
+            bench::doNotOptimize(&transform_comp);
+        }
+    }
+}
+BENCHMARK(ComponentCollection_GetAll)->Arg(1)->Arg(8);
+
+static void ComponentCollection_ApplyUnapply(bench::State& state) {
+    SceneFixture fixture;
+    auto node = makeComponentNode(fixture, state.range());
+    for (auto _ : state) {
+        node->payload().apply();
+        node->payload().unapply();
+    }
+}
+BENCHMARK(ComponentCollection_ApplyUnapply)->Arg(1)->Arg(8);
+
+// range() pushes into a reserved arena vector, one frame per iteration
+static void FrameArena_Vector(bench::State& state) {
+    for (auto _ : state) {
+        arena::frame().beginFrame();
+        arena::FrameVector<glm::mat4> matrices;
+        matrices.reserve(static_cast<size_t>(state.range()));
+        for (int64_t i = 0; i < state.range(); ++i) {
+            matrices.emplace_back(1.0f);
+        }
+        bench::doNotOptimize(matrices.data());
+    }
+}
+BENCHMARK(FrameArena_Vector)->Arg(64)->Arg(4096);
+
+static void MaterialStack_PushPop(bench::State& state) {
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    for (auto _ : state) {
+        material::stack()->push(material);
+        material::stack()->pop();
+    }
+}
+BENCHMARK(MaterialStack_PushPop);
+
+static void MaterialStack_GetValue(bench::State& state) {
+    material::stack()->push(material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f)));
+    const std::string& name = material::Material::s_diffuse_name;
+    for (auto _ : state) {
+        bench::doNotOptimize(material::stack()->getValue<glm::vec3>(name));
+    }
+    material::stack()->pop();
+}
+BENCHMARK(MaterialStack_GetValue);
+
+// Leaf at depth range(); the root transform changes every iteration, so the cache is always dirty
+static void ObservedTransform_GetWorldTransform(bench::State& state) {
+    SceneFixture fixture;
+    auto observed = component::ObservedTransformComponent::Make(transform::Transform::Make());
+    std::string leaf = fixture.addDeep(state.range(), noExtra);
+    scene::graph()->buildAt(leaf).addNode(fixture.nodeName(-1));
+    auto observer_node = scene::graph()->getNodeByName(fixture.nodeName(-1));
+    observer_node->payload().addComponent(observed, observer_node);
+
+    for (auto _ : state) {
+        fixture.root_transform->translate(0.0f, 0.0f, 0.0f);
+        bench::doNotOptimize(observed->getWorldTransform());
+    }
+}
+BENCHMARK(ObservedTransform_GetWorldTransform)->Arg(1)->Arg(16);
+
+// range() observed children under one root; moving the root and reading every world transform
+static void ObservedTransform_MoveRoot(bench::State& state) {
+    SceneFixture fixture;
+    fixture.addWide(state.range(), [](scene::SceneNodeBuilder& builder, int64_t) {
+        builder.with<component::ObservedTransformComponent>(transform::Transform::Make());
+    });
+    std::vector<component::ObservedTransformComponentPtr> observed;
+    for (int64_t i = 0; i < state.range(); ++i) {
+        observed.push_back(scene::graph()->getNodeByName(fixture.nodeName(i))->payload().get<component::ObservedTransformComponent>());
+    }
+
+    for (auto _ : state) {
+        fixture.root_transform->translate(0.0f, 0.0f, 0.0f);
+        for (const auto& component : observed) {
+            bench::doNotOptimize(component->getWorldTransform());
+        }
+    }
+}
+BENCHMARK(ObservedTransform_MoveRoot)->Arg(64)->Arg(4096);
+
+// range() children whose position, rotation and scale are all set every frame, then one world transform pass
+template <bool TRS>
+static void animateChildren(bench::State& state) {
+    SceneFixture fixture;
+    std::vector<transform::TransformPtr> transforms;
+    for (int64_t i = 0; i < state.range(); ++i) {
+        transforms.push_back(TRS ? transform::Transform::MakeTRS() : transform::Transform::Make());
+        scene::graph()->buildAt(fixture.root_name).addNode(fixture.nodeName(i))
+            .with<component::TransformComponent>(transforms.back());
+    }
+
+    float time = 0.0f;
+    for (auto _ : state) {
+        time += 0.01f;
+        for (const auto& t : transforms) {
+            if (TRS) {
+                t->setPosition(glm::vec3(time, 0.0f, 0.0f))
+                  .setRotation(glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f)))
+                  .setScaling(glm::vec3(1.0f + time));
+            } else {
+                t->setTranslate(time, 0.0f, 0.0f)->rotate(glm::degrees(time), 0.0f, 1.0f, 0.0f)->scale(1.0f + time, 1.0f + time, 1.0f + time);
+            }
+        }
+        scene::updateWorldTransforms(*fixture.root);
+    }
+}
+
+static void Transform_AnimateMatrix(bench::State& state) { animateChildren<false>(state); }
+BENCHMARK(Transform_AnimateMatrix)->Arg(4096);
+
+static void Transform_AnimateTRS(bench::State& state) { animateChildren<true>(state); }
+BENCHMARK(Transform_AnimateTRS)->Arg(4096);
+
+// range() interpolated children moved by one fixed update, then rendered at two alphas (a 2x display rate)
+static void Transform_Interpolate(bench::State& state) {
+    SceneFixture fixture;
+    std::vector<transform::TransformPtr> transforms;
+    for (int64_t i = 0; i < state.range(); ++i) {
+        transforms.push_back(transform::Transform::MakeTRS());
+        transforms.back()->setInterpolated(true);
+        scene::graph()->buildAt(fixture.root_name).addNode(fixture.nodeName(i))
+            .with<component::TransformComponent>(transforms.back());
+    }
+
+    float time = 0.0f;
+    for (auto _ : state) {
+        time += 0.01f;
+        transform::interpolation().beginStep();
+        for (const auto& t : transforms) {
+            t->setPosition(glm::vec3(time, 0.0f, 0.0f)).setRotation(glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f)));
+        }
+        for (float alpha : {0.25f, 0.75f}) {
+            transform::interpolation().setAlpha(alpha);
+            scene::updateWorldTransforms(*fixture.root);
+        }
+    }
+    for (const auto& t : transforms) {
+        t->setInterpolated(false);
+    }
+}
+BENCHMARK(Transform_Interpolate)->Arg(4096);
+
+namespace {
+struct NullObserver : IObserver {
+    void onNotify(const ISubject*) override {}
+};
+}
+
+// Unsubscribing and resubscribing the oldest of range() observers
+static void Observer_RemoveAdd(bench::State& state) {
+    auto subject = transform::Transform::Make();
+    std::vector<NullObserver> observers(static_cast<size_t>(state.range()));
+    for (NullObserver& o : observers) {
+        subject->addObserver(&o);
+    }
+    for (auto _ : state) {
+        subject->removeObserver(&observers.front());
+        subject->addObserver(&observers.front());
+    }
+}
+BENCHMARK(Observer_RemoveAdd)->Arg(16)->Arg(4096);
+
+// An arcball-style drag: the camera node is moved 5 times per frame, then the view matrix is read
+static void Observer_CameraDrag(bench::State& state) {
+    SceneFixture fixture;
+    auto camera = component::PerspectiveCamera::Make();
+    fixture.root->payload().addComponent(camera, fixture.root);
+    for (auto _ : state) {
+        for (int i = 0; i < 5; ++i) {
+            fixture.root_transform->translate(0.001f, 0.0f, 0.0f);
+        }
+        bench::doNotOptimize(camera->getViewMatrix());
+    }
+}
+BENCHMARK(Observer_CameraDrag);
+
+static void Node_VisitWide(bench::State& state) {
+    SceneFixture fixture;
+    fixture.addWide(state.range(), noExtra);
+    for (auto _ : state) {
+        scene::graph()->drawSubtree(fixture.root);
+    }
+}
+BENCHMARK(Node_VisitWide)->Arg(64)->Arg(4096)->Arg(100000);
+
+static void Node_VisitDeep(bench::State& state) {
+    SceneFixture fixture;
+    fixture.addDeep(state.range(), noExtra);
+    for (auto _ : state) {
+        scene::graph()->drawSubtree(fixture.root);
+    }
+}
+BENCHMARK(Node_VisitDeep)->Arg(64)->Arg(1024);
+
+// World transform pass after a root move: range() children recomputed, split across --workers
+static void Scene_UpdateWorldTransforms(bench::State& state) {
+    SceneFixture fixture;
+    fixture.addWide(state.range(), noExtra);
+    for (auto _ : state) {
+        fixture.root_transform->translate(0.0f, 0.0f, 0.0f);
+        scene::graph()->updateWorldTransforms();
+    }
+}
+BENCHMARK(Scene_UpdateWorldTransforms)->Arg(4096)->Arg(100000);
+
+// Full draw path with stubbed GL: shader uniforms, materials and geometry draws
+static void Scene_DrawLit(bench::State& state) {
+    SceneFixture fixture;
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    fixture.addWide(state.range(), [&](scene::SceneNodeBuilder& builder, int64_t) {
+        builder.with<component::MaterialComponent>(material)
+               .with<component::GeometryComponent>(mesh);
+    });
+
+    shader::stack()->push(benchShader());
+    for (auto _ : state) {
+        uniform::manager().applyPerFrame();
+        scene::graph()->drawSubtree(fixture.root);
+    }
+    shader::stack()->pop();
+}
+BENCHMARK(Scene_DrawLit)->Arg(64)->Arg(1024)->Arg(100000);
+
+// range() entities below one root entity in the ECS backend, each with a mesh and a material
+static ecs::Entity makeEcsCrowd(int64_t count, const geometry::GeometryPtr& mesh, const material::MaterialPtr& material) {
+    ecs::World& world = ecs::world();
+    ecs::Entity root = world.create();
+    for (int64_t i = 0; i < count; ++i) {
+        ecs::Entity entity = world.create(glm::translate(glm::mat4(1.0f), glm::vec3(0.01f, 0.0f, 0.0f)), root);
+        world.add(entity, ecs::GeometryRef{mesh});
+        world.add(entity, ecs::MaterialRef{material});
+    }
+    return root;
+}
+
+// ECS counterpart of Node_VisitWide: world transforms of range() children of a moving root
+static void Ecs_UpdateTransforms(bench::State& state) {
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    ecs::Entity root = makeEcsCrowd(state.range(), mesh, material);
+    for (auto _ : state) {
+        ecs::world().get<ecs::LocalTransform>(root)->matrix[3][0] += 0.001f;
+        ecs::updateTransforms(ecs::world());
+    }
+    ecs::world().clear();
+}
+BENCHMARK(Ecs_UpdateTransforms)->Arg(4096)->Arg(100000)->Arg(1000000);
+
+// ECS counterpart of Scene_DrawLit
+static void Ecs_DrawLit(bench::State& state) {
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    makeEcsCrowd(state.range(), mesh, material);
+
+    shader::stack()->push(benchShader());
+    for (auto _ : state) {
+        arena::frame().beginFrame();
+        uniform::manager().applyPerFrame();
+        ecs::updateTransforms(ecs::world());
+        ecs::drawEntities(ecs::world());
+    }
+    shader::stack()->pop();
+    ecs::world().clear();
+}
+BENCHMARK(Ecs_DrawLit)->Arg(1024)->Arg(100000);
+
+// What the GL thread pays per frame in pipelined mode: replaying the recorded
+// command packets of range() entities (the recording happens elsewhere)
+static void Ecs_ReplaySnapshot(bench::State& state) {
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    makeEcsCrowd(state.range(), mesh, material);
+    ecs::updateTransforms(ecs::world());
+    ecs::RenderSnapshot snapshot;
+    snapshot.extract(ecs::world());
+
+    shader::stack()->push(benchShader());
+    for (auto _ : state) {
+        uniform::manager().applyPerFrame();
+        snapshot.draw();
+    }
+    shader::stack()->pop();
+    snapshot.release();
+    ecs::world().clear();
+}
+BENCHMARK(Ecs_ReplaySnapshot)->Arg(1024)->Arg(100000);
+
+// One ECS frame of range() entities below a moving root: fixed update, transforms
+// and draw, one after the other on the calling thread
+static void Pipeline_Serial(bench::State& state) {
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    ecs::Entity root = makeEcsCrowd(state.range(), mesh, material);
+
+    shader::stack()->push(benchShader());
+    for (auto _ : state) {
+        arena::frame().beginFrame();
+        ecs::world().get<ecs::LocalTransform>(root)->matrix[3][0] += 0.001f;
+        ecs::updateTransforms(ecs::world());
+        uniform::manager().applyPerFrame();
+        ecs::drawEntities(ecs::world());
+    }
+    shader::stack()->pop();
+    ecs::world().clear();
+}
+BENCHMARK(Pipeline_Serial)->Arg(4096)->Arg(100000);
+
+// Pipeline_Serial as EnGeneConfig::pipelined runs it: the next frame is simulated
+// and extracted on the simulation thread while this one draws its snapshot
+static void Pipeline_Overlapped(bench::State& state) {
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    ecs::Entity root = makeEcsCrowd(state.range(), mesh, material);
+
+    shader::stack()->push(benchShader());
+    {
+        pipeline::SimulationThread simulation([root](double) {
+            ecs::world().get<ecs::LocalTransform>(root)->matrix[3][0] += 0.001f;
+        }, 1.0 / 60.0);
+        for (auto _ : state) {
+            arena::frame().beginFrame();
+            simulation.wait();
+            simulation.swap();
+            simulation.start(1);
+            uniform::manager().applyPerFrame();
+            simulation.front().draw();
+        }
+        simulation.wait();
+    }
+    shader::stack()->pop();
+    ecs::world().clear();
+}
+BENCHMARK(Pipeline_Overlapped)->Arg(4096)->Arg(100000);
+
+// One steady-state frame as EnGene runs it: a fixed update dirtying every world
+// transform, lights, per-frame uniforms, a textured and lit draw and the
+// end-of-frame bookkeeping. Expected to allocate nothing.
+static void Frame_SteadyState(bench::State& state) {
+    SceneFixture fixture;
+    auto mesh = Sphere::Make(8, 8);
+    auto material = material::Material::Make(glm::vec3(1.0f, 0.5f, 0.25f));
+    unsigned char pixels[4 * 4 * 4] = {};
+    auto texture = texture::Texture::Make(4, 4, pixels);
+    fixture.addWide(state.range(), [&](scene::SceneNodeBuilder& builder, int64_t) {
+        builder.with<component::MaterialComponent>(material)
+               .with<component::TextureComponent>(texture, "u_albedo", 0)
+               .with<component::GeometryComponent>(mesh);
+    });
+    light::PointLightParams params;
+    params.position = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    scene::graph()->buildAt(fixture.root_name)
+        .addNode(fixture.nodeName(-1))
+        .with<component::LightComponent>(light::PointLight::Make(params), transform::Transform::Make());
+
+    auto frame = [&] {
+        arena::frame().beginFrame();
+        {
+            ENGENE_ALLOC_SCOPE("FixedUpdate");
+            fixture.root_transform->rotate(1.0f, 0.0f, 0.0f, 1.0f);
+        }
+        shader::stack()->push(frameShader());
+        {
+            ENGENE_ALLOC_SCOPE("ApplyPerFrame");
+            light::manager().apply();
+            uniform::manager().applyPerFrame();
+        }
+        {
+            ENGENE_ALLOC_SCOPE("Render");
+            scene::graph()->drawSubtree(fixture.root);
+        }
+        shader::stack()->pop();
+        framebuffer::pool()->nextFrame();
+        gl_state::cache()->nextFrame();
+        stats::history().nextFrame();
+        allocation::tracker().nextFrame();
+    };
+
+    // First frames fill caches and grow the stacks to the scene's depth
+    for (int i = 0; i < 3; ++i) {
+        frame();
+    }
+    for (auto _ : state) {
+        frame();
+        if (allocation::tracker().getLastFrame().allocations > 0 && g_frame_alloc_report.empty()) {
+            g_frame_alloc_report = allocation::tracker().report();
+        }
+    }
+}
+BENCHMARK(Frame_SteadyState)->Arg(64)->Arg(1024);
+
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string json_path;
+    double min_time = DEFAULT_MIN_TIME;
+    bool require_zero_alloc = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) min_time = std::atof(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc) json_path = argv[++i];
+        else if (arg == "--require-zero-alloc") require_zero_alloc = true;
+        else if (arg == "--workers" && i + 1 < argc) jobs::system().setWorkerCount(std::strtoul(argv[++i], nullptr, 10));
+        else {
+            std::cerr << "Usage: engene_microbench [--filter SUBSTRING] [--min-time SECONDS] [--json FILE]"
+                      << " [--require-zero-alloc] [--workers N]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!gl_stub::load()) {
+        std::cerr << "Failed to load the GL stubs" << std::endl;
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    std::printf("Job workers: %zu, SIMD kernels: %s\n\n", jobs::system().getWorkerCount(), simd::kernelName());
+    std::printf("%-44s %14s %12s %12s %12s\n", "Benchmark", "Time (ns)", "Iterations", "Allocs/iter", "Bytes/iter");
+    std::printf("%s\n", std::string(98, '-').c_str());
+
+    try {
+        for (const bench::Benchmark* benchmark : bench::registry()) {
+            std::vector<int64_t> args = benchmark->args;
+            if (args.empty()) args.push_back(0);
+
+            for (int64_t arg : args) {
+                std::string name = benchmark->name;
+                if (!benchmark->args.empty()) name += "/" + std::to_string(arg);
+                if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+                bench::Result r = bench::run(*benchmark, arg, name, min_time);
+                std::printf("%-44s %14.1f %12llu %12.2f %12.1f\n", r.name.c_str(), r.ns_per_iter,
+                            static_cast<unsigned long long>(r.iterations), r.allocs_per_iter, r.bytes_per_iter);
+                results.push_back(r);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        out << "{\n  \"context\": {\"executable\": \"" << argv[0] << "\", \"gl\": \"stub\""
+            << ", \"job_workers\": " << jobs::system().getWorkerCount()
+            << ", \"simd\": \"" << simd::kernelName() << "\"},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const bench::Result& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"run_type\": \"iteration\""
+                << ", \"iterations\": " << r.iterations
+                << ", \"real_time\": " << r.ns_per_iter
+                << ", \"cpu_time\": " << r.ns_per_iter
+                << ", \"time_unit\": \"ns\""
+                << ", \"allocs_per_iter\": " << r.allocs_per_iter
+                << ", \"bytes_per_iter\": " << r.bytes_per_iter << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        if (!out) {
+            std::cerr << "Could not write '" << json_path << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    if (require_zero_alloc) {
+        bool allocated = false;
+        for (const bench::Result& r : results) {
+            if (r.name.rfind("Frame_", 0) == 0 && r.allocs_per_iter > 0.0) {
+                std::cerr << "Steady-state frame allocates: " << r.name << " ("
+                          << r.allocs_per_iter << " allocations per frame)" << std::endl;
+                allocated = true;
+            }
+        }
+        if (allocated) {
+            std::cerr << g_frame_alloc_report << std::endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <EnGene.h>
+#include <core/scene.h>
+#include <core/scene_node_builder.h>
+#include <other_genes/3d_shapes/sphere.h>
+#include <gl_base/error.h>
+#include <gl_base/shader.h>
+#include <components/all.h>
+#include <components/light_component.h>
+#include <3d/lights/point_light.h>
+
+#include <string>
+#include <vector>
+
+// Measures frame time under each GL error checking level on a draw-heavy scene.
+// Build once without NDEBUG (ENGENE_GL_CHECK_LEVEL defaults to 3) so every level
+// can be selected at runtime, and once with -DNDEBUG to see GL_CHECK compiled out.
+
+#define GRID_SIZE 32           // GRID_SIZE * GRID_SIZE lit spheres
+#define FRAMES_PER_LEVEL 300   // Frames averaged for each level
+#define WARMUP_FRAMES 30       // Frames skipped after switching level
+
+
+int main() {
+    std::vector<Error::CheckLevel> levels;
+    for (int level = ENGENE_GL_CHECK_LEVEL; level >= 0; --level) {
+        levels.push_back(static_cast<Error::CheckLevel>(level));
+    }
+    const char* level_names[] = { "Off", "Callback", "Sampled", "Full" };
+
+    size_t level_index = 0;
+    int frame_in_level = 0;
+    double level_time = 0.0;
+    double last_frame_start = 0.0;
+
+    auto on_init = [&](engene::EnGene& app) {
+        app.getBaseShader()->configureDynamicUniform<glm::mat4>("u_model", transform::current);
+        light::manager().bindToShader(app.getBaseShader());
+
+        // Uncapped frame rate so the checking overhead is visible
+        glfwSwapInterval(0);
+
+        scene::graph()->addNode("grid");
+        float spacing = 1.8f / GRID_SIZE;
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                std::string name = "sphere_" + std::to_string(x) + "_" + std::to_string(y);
+                scene::graph()->buildAt("grid")
+                .addNode(name)
+                    .with<component::TransformComponent>(
+                        transform::Transform::Make()
+                        ->translate(-0.9f + (x + 0.5f) * spacing, -0.9f + (y + 0.5f) * spacing, 0.0f)
+                        ->scale(spacing * 0.4f, spacing * 0.4f, spacing * 0.4f)
+                    )
+                    .with<component::GeometryComponent>(
+                        Sphere::Make(),
+                        name
+                    );
+            }
+        }
+
+        light::PointLightParams p;
+        p.position = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        scene::graph()->buildAt("grid")
+        .addNode("light")
+            .with<component::LightComponent>(
+                light::PointLight::Make(p),
+                transform::Transform::Make()
+            );
+        light::manager().apply();
+
+        Error::setCheckLevel(levels[level_index]);
+        last_frame_start = glfwGetTime();
+    };
+
+    auto on_fixed_update = [&](double fixed_timestep) {
+
+    };
+
+    auto on_render = [&](double alpha) {
+        double now = glfwGetTime();
+        double frame_time = now - last_frame_start;
+        last_frame_start = now;
+
+        if (frame_in_level >= WARMUP_FRAMES) {
+            level_time += frame_time;
+        }
+        if (++frame_in_level == WARMUP_FRAMES + FRAMES_PER_LEVEL) {
+            Error::CheckLevel level = levels[level_index];
+            std::cout << "GL check level " << level_names[static_cast<int>(level)] << ": "
+                      << (level_time / FRAMES_PER_LEVEL) * 1000.0 << " ms/frame" << std::endl;
+
+            level_index = (level_index + 1) % levels.size();
+            Error::setCheckLevel(levels[level_index]);
+            frame_in_level = 0;
+            level_time = 0.0;
+        }
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        scene::graph()->draw();
+        GL_CHECK("render");
+    };
+
+    try {
+        engene::EnGeneConfig config;
+        config.width = 1024;
+        config.height = 1024;
+        config.title = "GL Check Level Benchmark";
+        config.base_vertex_shader_source = "shaders/lit_vertex.glsl";
+        config.base_fragment_shader_source = "shaders/lit_fragment.glsl";
+
+        engene::EnGene app(
+            on_init,
+            on_fixed_update,
+            on_render,
+            config
+        );
+
+        app.run();
+
+    } catch (const std::runtime_error& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -9,6 +9,7 @@ in vec2 v_texCoord;
 
 // ========== Definições da cena ==========
 #define MAX_SCENE_LIGHTS 16
+#define MAX_LIGHTS_PER_OBJECT 8
 #define LIGHT_TYPE_INACTIVE    0
 #define LIGHT_TYPE_DIRECTIONAL 1
 #define LIGHT_TYPE_POINT       2
@@ -32,6 +33,12 @@ layout (std140) uniform SceneLights {
     int active_light_count;
 } sceneLights;
 
+// Luzes selecionadas para este objeto (light_count = -1 => usar todas)
+layout (std140) uniform ObjectLights {
+    ivec4 light_indices[(MAX_LIGHTS_PER_OBJECT + 3) / 4];
+    int light_count;
+} objectLights;
+
 layout (std140) uniform CameraPosition {
     vec4 u_viewPos;
 };
@@ -92,9 +99,12 @@ void main()
     vec3 totalLight = vec3(0.0);
 
     // ======================================================
-    // Loop sobre todas as luzes ativas
-    for (int i = 0; i < sceneLights.active_light_count; ++i) {
-        LightData light = sceneLights.lights[i];
+    // Loop sobre as luzes selecionadas para o objeto (ou todas as ativas)
+    bool useSelection = objectLights.light_count >= 0;
+    int lightCount = useSelection ? objectLights.light_count : sceneLights.active_light_count;
+    for (int i = 0; i < lightCount; ++i) {
+        int lightIndex = useSelection ? objectLights.light_indices[i / 4][i % 4] : i;
+        LightData light = sceneLights.lights[lightIndex];
 
         if (light.type == LIGHT_TYPE_INACTIVE)
             continue;
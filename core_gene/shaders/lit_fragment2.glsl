@@ -3,6 +3,9 @@
 // Maximum number of lights - must match C++ light_config.h
 #define MAX_SCENE_LIGHTS 16
 
+// Maximum number of lights selected per object - must match C++ light_config.h
+#define MAX_LIGHTS_PER_OBJECT 8
+
 // Light type enumeration - must match C++ LightType enum
 #define LIGHT_TYPE_INACTIVE 0
 #define LIGHT_TYPE_DIRECTIONAL 1
@@ -28,6 +31,12 @@ layout(std140, binding = 0) uniform SceneLights {
     int padding[3];
 } sceneLights;
 
+// Lights selected for the current object (light_count = -1 means use every active light)
+layout(std140) uniform ObjectLights {
+    ivec4 light_indices[(MAX_LIGHTS_PER_OBJECT + 3) / 4];
+    int light_count;
+} objectLights;
+
 // Material properties
 uniform vec4 materialAmbient;
 uniform vec4 materialDiffuse;
@@ -141,9 +150,12 @@ vec3 calculateSpotLight(LightData light, vec3 fragPos, vec3 normal, vec3 viewDir
 vec3 calculateLighting(vec3 fragPos, vec3 normal, vec3 viewDir) {
     vec3 result = vec3(0.0);
     
-    // Loop through all active lights
-    for (int i = 0; i < sceneLights.active_light_count; i++) {
-        LightData light = sceneLights.lights[i];
+    // Loop through the lights selected for this object, or all active lights
+    bool useSelection = objectLights.light_count >= 0;
+    int lightCount = useSelection ? objectLights.light_count : sceneLights.active_light_count;
+    for (int i = 0; i < lightCount; i++) {
+        int lightIndex = useSelection ? objectLights.light_indices[i / 4][i % 4] : i;
+        LightData light = sceneLights.lights[lightIndex];
         
         // Branch based on light type
         if (light.type == LIGHT_TYPE_DIRECTIONAL) {
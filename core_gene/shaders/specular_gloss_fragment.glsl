@@ -6,6 +6,9 @@ in vec3 v_fragPos;
 in vec3 v_normal;
 in vec2 v_texCoords;
 
+// Must match MAX_LIGHTS_PER_OBJECT in C++ light_config.h
+#define MAX_LIGHTS_PER_OBJECT 8
+
 struct LightData {
     vec4 position;
     vec4 direction;
@@ -24,6 +27,12 @@ layout(std140) uniform SceneLights {
     int active_light_count;
 } sceneLights;
 
+// light_count = -1 means use every active light
+layout(std140) uniform ObjectLights {
+    ivec4 light_indices[(MAX_LIGHTS_PER_OBJECT + 3) / 4];
+    int light_count;
+} objectLights;
+
 layout (std140) uniform CameraPosition {
     vec4 u_viewPos;
 };
@@ -38,32 +47,35 @@ void main()
 
     vec3 result = vec3(0.0);
 
-    for (int i = 0; i < sceneLights.active_light_count; i++)
+    bool useSelection = objectLights.light_count >= 0;
+    int lightCount = useSelection ? objectLights.light_count : sceneLights.active_light_count;
+    for (int i = 0; i < lightCount; i++)
     {
+        LightData light = sceneLights.lights[useSelection ? objectLights.light_indices[i / 4][i % 4] : i];
         vec3 lightDir;
         float attenuation = 1.0;
 
-        if (sceneLights.lights[i].type == 1) // Directional light
+        if (light.type == 1) // Directional light
         {
-            lightDir = normalize(-sceneLights.lights[i].direction.xyz);
+            lightDir = normalize(-light.direction.xyz);
         }
         else // Point light
         {
-            lightDir = normalize(sceneLights.lights[i].position.xyz - v_fragPos);
-            float dist = length(sceneLights.lights[i].position.xyz - v_fragPos);
-            attenuation = 1.0 / (sceneLights.lights[i].attenuation.x + sceneLights.lights[i].attenuation.y * dist + sceneLights.lights[i].attenuation.z * dist * dist);
+            lightDir = normalize(light.position.xyz - v_fragPos);
+            float dist = length(light.position.xyz - v_fragPos);
+            attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * dist + light.attenuation.z * dist * dist);
         }
 
         // Diffuse
         float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = sceneLights.lights[i].diffuse.xyz * diff;
+        vec3 diffuse = light.diffuse.xyz * diff;
 
         // Specular
         vec3 reflectDir = reflect(-lightDir, norm);
         float gloss = texture(u_glossMap, v_texCoords).r;
         float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0 * gloss);
         vec3 specularColor = texture(u_specularMap, v_texCoords).rgb;
-        vec3 specular = sceneLights.lights[i].specular.xyz * spec * specularColor;
+        vec3 specular = light.specular.xyz * spec * specularColor;
 
         result += (diffuse + specular) * attenuation;
     }
@@ -15,6 +15,18 @@ namespace component {
 class Camera;
 using CameraPtr = std::shared_ptr<Camera>;
 
+/**
+ * @enum RenderPath
+ * @brief Shading path used when rendering through this camera.
+ *
+ * Only consulted by renderers that support more than one path (see
+ * deferred::DeferredRenderer). Plain scene::graph()->draw() always renders forward.
+ */
+enum class RenderPath {
+    Forward,   ///< Objects are lit while they are drawn
+    Deferred   ///< Opaque objects fill a G-buffer that is lit in a separate pass
+};
+
 // --- Data Struct for the Camera UBO ---
 
 /**
@@ -41,6 +53,7 @@ private:
 
 protected:
     float m_aspect_ratio;
+    RenderPath m_render_path = RenderPath::Forward;
 
     /**
      * @brief Protected constructor for camera components.
@@ -77,6 +90,13 @@ public:
 
     virtual void setAspectRatio(float ratio) { m_aspect_ratio = ratio; }
     virtual float getAspectRatio() const { return m_aspect_ratio; }
+
+    /**
+     * @brief Selects forward or deferred shading for this camera.
+     * @param path The shading path (default: RenderPath::Forward).
+     */
+    void setRenderPath(RenderPath path) { m_render_path = path; }
+    RenderPath getRenderPath() const { return m_render_path; }
     
     /**
      * @brief Returns a function that provides this camera's matrices.
@@ -153,6 +173,7 @@ public:
     virtual ObservedTransformComponentPtr getTarget() const = 0;
 
     // --- Type Information ---
+    ENGENE_COMPONENT_TYPE(Camera, ObservedTransformComponent)
     const char* getTypeName() const override { return "Camera"; }
     static const char* getTypeNameStatic() { return "Camera"; }
 };
@@ -60,6 +60,8 @@ protected:
     }
 
 public:
+    ENGENE_COMPONENT_TYPE(Camera3D, Camera)
+
     virtual ~Camera3D() = default;
 
     /**
@@ -97,6 +97,12 @@ public:
      * If a target is set, the camera will look at the target's position.
      */
     glm::mat4 getViewMatrix() override {
+        // Runs any pending world-transform pass, which dirties the view if the camera or target moved
+        this->getWorldTransform();
+        if (m_target) {
+            m_target->getWorldTransform();
+        }
+
         if (!m_is_view_matrix_dirty) {
             return m_cached_view_matrix;
         }
@@ -165,6 +171,7 @@ public:
     }
 
     // --- Type Information ---
+    ENGENE_COMPONENT_TYPE(OrthographicCamera, Camera3D)
     const char* getTypeName() const override { return "OrthographicCamera"; }
     static const char* getTypeNameStatic() { return "OrthographicCamera"; }
 };
@@ -69,6 +69,12 @@ public:
     // --- Implementation of Inherited Pure Virtuals ---
 
     glm::mat4 getViewMatrix() override {
+        // Runs any pending world-transform pass, which dirties the view if the camera or target moved
+        this->getWorldTransform();
+        if (m_target) {
+            m_target->getWorldTransform();
+        }
+
         if (!m_is_view_matrix_dirty) {
             return m_cached_view_matrix;
         }
@@ -139,6 +145,7 @@ public:
     // ... other getters/setters ...
 
     // --- Type Information ---
+    ENGENE_COMPONENT_TYPE(PerspectiveCamera, Camera3D)
     const char* getTypeName() const override { return "PerspectiveCamera"; }
     static const char* getTypeNameStatic() { return "PerspectiveCamera"; }
 };
@@ -0,0 +1,539 @@
+#ifndef DEFERRED_RENDERER_H
+#define DEFERRED_RENDERER_H
+#pragma once
+
+#include "../../gl_base/gl_includes.h"
+#include "../../gl_base/error.h"
+#include "../../gl_base/gl_state.h"
+#include "../../gl_base/framebuffer.h"
+#include "../../gl_base/shader.h"
+#include "../../gl_base/texture.h"
+#include "../../gl_base/material.h"
+#include "../../components/light_component.h"
+#include "../../core/scene.h"
+#include "../../core/frame_arena.h"
+#include "../camera/camera.h"
+#include "../../utils/simd_math.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+namespace deferred {
+
+class DeferredRenderer;
+using DeferredRendererPtr = std::shared_ptr<DeferredRenderer>;
+
+/**
+ * @struct DeferredConfig
+ * @brief Settings for the deferred pipeline.
+ */
+struct DeferredConfig {
+    int tile_size = 16;  ///< Edge of a screen tile in pixels for light binning
+};
+
+/**
+ * @struct DeferredStats
+ * @brief Counters of the last deferred frame (for forward/deferred comparisons).
+ */
+struct DeferredStats {
+    int tiles = 0;                ///< Number of screen tiles
+    size_t tile_light_pairs = 0;  ///< Sum over tiles of the lights assigned to them
+    int width = 0;                ///< G-buffer width
+    int height = 0;               ///< G-buffer height
+
+    float averageLightsPerTile() const {
+        return tiles ? static_cast<float>(tile_light_pairs) / static_cast<float>(tiles) : 0.0f;
+    }
+};
+
+/**
+ * @class DeferredRenderer
+ * @brief Tiled deferred shading built on Framebuffer::MakeGBuffer.
+ *
+ * Frame structure when the active camera uses RenderPath::Deferred:
+ * 1. Geometry pass - opaque subtree is drawn with the G-buffer shader.
+ * 2. Light binning - LightManager lights are assigned to screen tiles on the CPU.
+ * 3. Lighting pass - one fullscreen triangle shades each pixel with its tile's
+ *    lights and restores scene depth into the current render target.
+ * 4. Transparent pass - the transparent subtree is forward-rendered on top,
+ *    blended and depth-tested against the opaque depth.
+ *
+ * When the active camera uses RenderPath::Forward, both subtrees are simply
+ * drawn in order, so the same scene can be benchmarked on either path.
+ *
+ * G-buffer layout (16 bytes per pixel):
+ * - gAlbedoSpec   (RGBA8):   diffuse albedo, specular intensity
+ * - gNormalParams (RGBA16F): octahedral normal (xy), shininess / 512, ambient factor
+ * - gDepth        (DEPTH24): world position is reconstructed from it
+ *
+ * @note Opaque nodes should not carry their own ShaderComponent; the G-buffer
+ *       shader replaces forward shaders during the geometry pass.
+ * @note Call light::manager().apply() before render(), as for forward rendering.
+ */
+class DeferredRenderer {
+private:
+    DeferredConfig m_config;
+    DeferredStats m_stats;
+
+    framebuffer::FramebufferPtr m_gbuffer;
+    shader::ShaderPtr m_gbuffer_shader;
+    shader::ShaderPtr m_lighting_shader;
+    framebuffer::RenderStatePtr m_opaque_state;
+    framebuffer::RenderStatePtr m_lighting_state;
+    framebuffer::RenderStatePtr m_transparent_state;
+
+    GLuint m_fullscreen_vao = 0;
+    GLuint m_tile_buffer = 0;
+    int m_tile_count_x = 0;
+    int m_tile_count_y = 0;
+
+    glm::mat4 m_inv_view_projection = glm::mat4(1.0f);
+    glm::vec3 m_view_position = glm::vec3(0.0f);
+
+    static constexpr int TILE_STRIDE = static_cast<int>(light::max_scene_lights) + 1;
+    static constexpr GLuint TILE_BUFFER_BINDING = 0;
+
+    inline static const std::string GBUFFER_VERTEX_SHADER = R"(#version 430 core
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in vec3 a_normal;
+
+layout (std140) uniform CameraMatrices {
+    mat4 view;
+    mat4 projection;
+};
+
+uniform mat4 u_model;
+
+out vec3 v_normal;
+
+void main() {
+    v_normal = mat3(transpose(inverse(u_model))) * a_normal;
+    gl_Position = projection * view * u_model * vec4(a_pos, 1.0);
+}
+)";
+
+    inline static const std::string GBUFFER_FRAGMENT_SHADER = R"(#version 430 core
+in vec3 v_normal;
+
+layout (location = 0) out vec4 g_albedoSpec;
+layout (location = 1) out vec4 g_normalParams;
+
+uniform vec3  u_material_ambient;
+uniform vec3  u_material_diffuse;
+uniform vec3  u_material_specular;
+uniform float u_material_shininess;
+
+vec2 signNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 encodeOctahedral(vec3 n) {
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    return n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * signNotZero(n.xy);
+}
+
+void main() {
+    float specular = max(u_material_specular.r, max(u_material_specular.g, u_material_specular.b));
+    float diffuse_peak = max(max(u_material_diffuse.r, max(u_material_diffuse.g, u_material_diffuse.b)), 1e-4);
+    float ambient_factor = max(u_material_ambient.r, max(u_material_ambient.g, u_material_ambient.b)) / diffuse_peak;
+
+    g_albedoSpec = vec4(u_material_diffuse, clamp(specular, 0.0, 1.0));
+    g_normalParams = vec4(encodeOctahedral(normalize(v_normal)),
+                          u_material_shininess / 512.0,
+                          ambient_factor);
+}
+)";
+
+    inline static const std::string FULLSCREEN_VERTEX_SHADER = R"(#version 430 core
+void main() {
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    inline static const std::string LIGHTING_FRAGMENT_BODY = R"(
+#define LIGHT_TYPE_INACTIVE    0
+#define LIGHT_TYPE_DIRECTIONAL 1
+#define LIGHT_TYPE_POINT       2
+#define LIGHT_TYPE_SPOT        3
+
+out vec4 FragColor;
+
+struct LightData {
+    vec4 position;
+    vec4 direction;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 attenuation; // (const, linear, quad, cutoff cosine)
+    int type;
+    int pad1;
+    int pad2;
+    int pad3;
+};
+
+layout (std140) uniform SceneLights {
+    LightData lights[MAX_SCENE_LIGHTS];
+    int active_light_count;
+} sceneLights;
+
+layout (std430, binding = 0) readonly buffer TileLights {
+    int tile_data[];
+};
+
+uniform sampler2D u_gAlbedoSpec;
+uniform sampler2D u_gNormalParams;
+uniform sampler2D u_gDepth;
+uniform mat4 u_invViewProjection;
+uniform vec3 u_viewPos;
+uniform int  u_tileSize;
+uniform int  u_tileCountX;
+
+vec2 signNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * signNotZero(n.xy);
+    }
+    return normalize(n);
+}
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(u_gDepth, pixel, 0).r;
+    if (depth >= 1.0) {
+        discard; // Background keeps whatever the target already holds
+    }
+    gl_FragDepth = depth;
+
+    vec4 albedoSpec = texelFetch(u_gAlbedoSpec, pixel, 0);
+    vec4 normalParams = texelFetch(u_gNormalParams, pixel, 0);
+    vec3 albedo = albedoSpec.rgb;
+    vec3 norm = decodeOctahedral(normalParams.xy);
+    float shininess = max(normalParams.z * 512.0, 1.0);
+    float ambientFactor = normalParams.w;
+
+    // Position from depth
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(textureSize(u_gDepth, 0));
+    vec4 world = u_invViewProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+    vec3 viewDir = normalize(u_viewPos - fragPos);
+
+    int tile = (pixel.y / u_tileSize) * u_tileCountX + (pixel.x / u_tileSize);
+    int base = tile * (MAX_SCENE_LIGHTS + 1);
+    int count = tile_data[base];
+
+    vec3 totalLight = vec3(0.0);
+    for (int i = 0; i < count; ++i) {
+        LightData light = sceneLights.lights[tile_data[base + 1 + i]];
+
+        vec3 lightDir;
+        float attenuation = 1.0;
+
+        if (light.type == LIGHT_TYPE_DIRECTIONAL) {
+            lightDir = normalize(-light.direction.xyz);
+        } else {
+            vec3 toLight = light.position.xyz - fragPos;
+            float dist = length(toLight);
+            lightDir = toLight / max(dist, 1e-4);
+            attenuation = 1.0 / (light.attenuation.x +
+                                 light.attenuation.y * dist +
+                                 light.attenuation.z * dist * dist);
+            if (light.type == LIGHT_TYPE_SPOT) {
+                float theta = dot(lightDir, normalize(-light.direction.xyz));
+                attenuation *= clamp((theta - light.attenuation.w) / 0.05, 0.0, 1.0);
+            }
+        }
+
+        vec3 halfway = normalize(lightDir + viewDir);
+        float diff = max(dot(norm, lightDir), 0.0);
+        float spec = (diff > 0.0) ? pow(max(dot(norm, halfway), 0.0), shininess) : 0.0;
+
+        vec3 ambient  = light.ambient.xyz * albedo * ambientFactor;
+        vec3 diffuse  = light.diffuse.xyz * diff * albedo;
+        vec3 specular = light.specular.xyz * spec * albedoSpec.a;
+
+        totalLight += (ambient + diffuse + specular) * attenuation;
+    }
+
+    FragColor = vec4(clamp(totalLight, 0.0, 1.0), 1.0);
+}
+)";
+
+    explicit DeferredRenderer(const DeferredConfig& config) : m_config(config) {
+        if (m_config.tile_size <= 0) {
+            std::cerr << "Warning: DeferredRenderer tile size must be positive. Using 16." << std::endl;
+            m_config.tile_size = 16;
+        }
+
+        // Geometry pass shader
+        m_gbuffer_shader = shader::Shader::Make(GBUFFER_VERTEX_SHADER, GBUFFER_FRAGMENT_SHADER);
+        m_gbuffer_shader->configureDynamicUniform<glm::mat4>("u_model", transform::current);
+        material::stack()->configureShaderDefaults(m_gbuffer_shader);
+        component::Camera::bindToShader(m_gbuffer_shader);
+        m_gbuffer_shader->Bake();
+
+        // Lighting pass shader (MAX_SCENE_LIGHTS injected from the C++ configuration)
+        std::string lighting_source = "#version 430 core\n#define MAX_SCENE_LIGHTS " +
+                                      std::to_string(light::max_scene_lights) + "\n" + LIGHTING_FRAGMENT_BODY;
+        m_lighting_shader = shader::Shader::Make(FULLSCREEN_VERTEX_SHADER, lighting_source);
+        m_lighting_shader
+            ->configureStaticUniform<uniform::detail::Sampler>("u_gAlbedoSpec", []() { return uniform::detail::Sampler{0}; })
+            ->configureStaticUniform<uniform::detail::Sampler>("u_gNormalParams", []() { return uniform::detail::Sampler{1}; })
+            ->configureStaticUniform<uniform::detail::Sampler>("u_gDepth", []() { return uniform::detail::Sampler{2}; })
+            ->configureDynamicUniform<glm::mat4>("u_invViewProjection", [this]() { return m_inv_view_projection; })
+            ->configureDynamicUniform<glm::vec3>("u_viewPos", [this]() { return m_view_position; })
+            ->configureDynamicUniform<int>("u_tileSize", [this]() { return m_config.tile_size; })
+            ->configureDynamicUniform<int>("u_tileCountX", [this]() { return m_tile_count_x; });
+        light::manager().bindToShader(m_lighting_shader);
+        m_lighting_shader->Bake();
+
+        // Pass states
+        m_opaque_state = std::make_shared<framebuffer::RenderState>();
+        m_opaque_state->depth().setTest(true);
+        m_opaque_state->depth().setFunction(framebuffer::DepthFunc::Less);
+        m_opaque_state->depth().setWrite(true);
+        m_opaque_state->blend().setEnabled(false);
+
+        m_lighting_state = std::make_shared<framebuffer::RenderState>();
+        m_lighting_state->depth().setTest(true);
+        m_lighting_state->depth().setFunction(framebuffer::DepthFunc::Always);
+        m_lighting_state->depth().setWrite(true);
+        m_lighting_state->blend().setEnabled(false);
+
+        m_transparent_state = std::make_shared<framebuffer::RenderState>();
+        m_transparent_state->depth().setTest(true);
+        m_transparent_state->depth().setFunction(framebuffer::DepthFunc::Less);
+        m_transparent_state->depth().setWrite(false);
+        m_transparent_state->blend().setEnabled(true);
+        m_transparent_state->blend().setFunction(framebuffer::BlendFactor::SrcAlpha,
+                                                 framebuffer::BlendFactor::OneMinusSrcAlpha);
+
+        // Core profile needs a bound VAO even for attribute-less draws
+        glGenVertexArrays(1, &m_fullscreen_vao);
+        glGenBuffers(1, &m_tile_buffer);
+        GL_CHECK("DeferredRenderer resources");
+    }
+
+    /**
+     * @brief Size of the render target the lighting pass writes to.
+     */
+    static void currentTargetSize(int& width, int& height) {
+        auto target = framebuffer::stack()->top();
+        if (target) {
+            width = target->getWidth();
+            height = target->getHeight();
+        } else {
+            framebuffer::stack()->getDefaultSize(width, height);
+        }
+    }
+
+    void ensureGBuffer(int width, int height) {
+        if (m_gbuffer && m_gbuffer->getWidth() == width && m_gbuffer->getHeight() == height) {
+            return;
+        }
+        m_gbuffer = framebuffer::Framebuffer::MakeGBuffer(
+            width, height,
+            {
+                {"gAlbedoSpec", framebuffer::attachment::Format::RGBA8},
+                {"gNormalParams", framebuffer::attachment::Format::RGBA16F}
+            },
+            "gDepth");
+    }
+
+    /**
+     * @brief Computes the screen-space rectangle (in NDC) covered by a sphere.
+     * @return False if the sphere is entirely behind the camera.
+     */
+    static bool projectSphere(const glm::mat4& view, const glm::mat4& projection,
+                              const glm::vec3& center, float radius,
+                              glm::vec2& ndc_min, glm::vec2& ndc_max) {
+        glm::vec3 view_center = simd::transformPoint(view, center);
+        if (view_center.z - radius > 0.0f) {
+            return false;
+        }
+
+        glm::vec4 corners[8];
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 offset((corner & 1) ? radius : -radius,
+                             (corner & 2) ? radius : -radius,
+                             (corner & 4) ? radius : -radius);
+            corners[corner] = glm::vec4(view_center + offset, 1.0f);
+        }
+        simd::transform(projection, corners, corners, 8);
+
+        ndc_min = glm::vec2(1.0f);
+        ndc_max = glm::vec2(-1.0f);
+        for (const glm::vec4& clip : corners) {
+            if (clip.w <= 1e-4f) {
+                // Corner behind the eye: the projection is unbounded, cover the screen
+                ndc_min = glm::vec2(-1.0f);
+                ndc_max = glm::vec2(1.0f);
+                return true;
+            }
+            glm::vec2 ndc = glm::vec2(clip) / clip.w;
+            ndc_min = glm::min(ndc_min, ndc);
+            ndc_max = glm::max(ndc_max, ndc);
+        }
+        ndc_min = glm::clamp(ndc_min, glm::vec2(-1.0f), glm::vec2(1.0f));
+        ndc_max = glm::clamp(ndc_max, glm::vec2(-1.0f), glm::vec2(1.0f));
+        return ndc_min.x < ndc_max.x && ndc_min.y < ndc_max.y;
+    }
+
+    /**
+     * @brief Assigns every active light to the screen tiles its influence covers.
+     */
+    void binLights(component::CameraPtr camera, int width, int height) {
+        glm::mat4 view = camera->getViewMatrix();
+        glm::mat4 projection = camera->getProjectionMatrix();
+        m_inv_view_projection = glm::inverse(projection * view);
+        m_view_position = glm::vec3(simd::affineInverse(view)[3]);
+
+        m_tile_count_x = (width + m_config.tile_size - 1) / m_config.tile_size;
+        m_tile_count_y = (height + m_config.tile_size - 1) / m_config.tile_size;
+        int tile_count = m_tile_count_x * m_tile_count_y;
+        // Rebuilt every frame, so the lists live in the frame arena
+        size_t tile_ints = static_cast<size_t>(tile_count) * TILE_STRIDE;
+        int* tile_data = arena::frame().allocate<int>(tile_ints);
+        std::fill(tile_data, tile_data + tile_ints, 0);
+
+        const auto& scene_data = light::manager().getSceneData();
+        for (int i = 0; i < scene_data.active_light_count; ++i) {
+            const light::LightData& data = scene_data.lights[i];
+            float range = light::manager().getLightRange(static_cast<size_t>(i));
+
+            int x0 = 0, y0 = 0, x1 = m_tile_count_x - 1, y1 = m_tile_count_y - 1;
+            if (data.type != static_cast<int>(light::LightType::DIRECTIONAL) && range >= 0.0f) {
+                glm::vec2 ndc_min, ndc_max;
+                if (!projectSphere(view, projection, glm::vec3(data.position), range, ndc_min, ndc_max)) {
+                    continue;
+                }
+                x0 = static_cast<int>((ndc_min.x * 0.5f + 0.5f) * width) / m_config.tile_size;
+                y0 = static_cast<int>((ndc_min.y * 0.5f + 0.5f) * height) / m_config.tile_size;
+                x1 = std::min(static_cast<int>((ndc_max.x * 0.5f + 0.5f) * width) / m_config.tile_size, m_tile_count_x - 1);
+                y1 = std::min(static_cast<int>((ndc_max.y * 0.5f + 0.5f) * height) / m_config.tile_size, m_tile_count_y - 1);
+            }
+
+            for (int ty = y0; ty <= y1; ++ty) {
+                for (int tx = x0; tx <= x1; ++tx) {
+                    int* tile = &tile_data[static_cast<size_t>(ty * m_tile_count_x + tx) * TILE_STRIDE];
+                    tile[1 + tile[0]] = i;
+                    tile[0]++;
+                }
+            }
+        }
+
+        m_stats.tiles = tile_count;
+        m_stats.tile_light_pairs = 0;
+        for (int t = 0; t < tile_count; ++t) {
+            m_stats.tile_light_pairs += static_cast<size_t>(tile_data[static_cast<size_t>(t) * TILE_STRIDE]);
+        }
+
+        gl_state::cache()->bindBuffer(GL_SHADER_STORAGE_BUFFER, m_tile_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tile_ints * sizeof(int), tile_data, GL_STREAM_DRAW);
+        gl_state::cache()->bindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_BUFFER_BINDING, m_tile_buffer);
+        GL_CHECK("upload deferred tile light lists");
+    }
+
+public:
+    DeferredRenderer(const DeferredRenderer&) = delete;
+    DeferredRenderer& operator=(const DeferredRenderer&) = delete;
+
+    ~DeferredRenderer() {
+        if (m_tile_buffer != 0) {
+            glDeleteBuffers(1, &m_tile_buffer);
+            gl_state::cache()->onBufferDeleted(m_tile_buffer);
+        }
+        if (m_fullscreen_vao != 0) {
+            glDeleteVertexArrays(1, &m_fullscreen_vao);
+            gl_state::cache()->onVertexArrayDeleted(m_fullscreen_vao);
+        }
+    }
+
+    /**
+     * @brief Creates the renderer and compiles its shaders.
+     * @note Requires a current OpenGL 4.3 context (SSBOs in the lighting pass).
+     */
+    static DeferredRendererPtr Make(const DeferredConfig& config = DeferredConfig()) {
+        return DeferredRendererPtr(new DeferredRenderer(config));
+    }
+
+    /**
+     * @brief Renders opaque and transparent subtrees with the active camera's path.
+     *
+     * Output goes to whatever framebuffer is on top of the FramebufferStack,
+     * so the result can feed post-processing as usual.
+     *
+     * @param opaque_root Subtree shaded deferred (or forward, per camera).
+     * @param transparent_root Subtree always forward-rendered afterwards (may be null).
+     */
+    void render(scene::SceneNodePtr opaque_root, scene::SceneNodePtr transparent_root = nullptr) {
+        auto camera = scene::graph()->getActiveCamera();
+        if (!camera || camera->getRenderPath() == component::RenderPath::Forward) {
+            if (opaque_root) scene::graph()->drawSubtree(opaque_root);
+            if (transparent_root) scene::graph()->drawSubtree(transparent_root);
+            return;
+        }
+
+        int width = 0, height = 0;
+        currentTargetSize(width, height);
+        if (width <= 0 || height <= 0) return;
+        ensureGBuffer(width, height);
+        m_stats.width = width;
+        m_stats.height = height;
+
+        // 1. Geometry pass
+        framebuffer::stack()->push(m_gbuffer, m_opaque_state);
+        shader::stack()->push(m_gbuffer_shader);
+        if (opaque_root) scene::graph()->drawSubtree(opaque_root);
+        shader::stack()->pop();
+        framebuffer::stack()->pop();
+
+        // 2. Light binning
+        binLights(camera, width, height);
+
+        // 3. Lighting pass into the current target
+        framebuffer::stack()->push(framebuffer::stack()->top(), m_lighting_state);
+        texture::stack()->push(m_gbuffer->getTexture("gAlbedoSpec"), 0);
+        texture::stack()->push(m_gbuffer->getTexture("gNormalParams"), 1);
+        texture::stack()->push(m_gbuffer->getTexture("gDepth"), 2);
+        shader::stack()->push(m_lighting_shader);
+        shader::stack()->top();
+
+        gl_state::cache()->bindVertexArray(m_fullscreen_vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        GL_CHECK("deferred lighting pass");
+        ++stats::current().draw_calls;
+        stats::current().indices += 3;
+
+        shader::stack()->pop();
+        texture::stack()->pop();
+        texture::stack()->pop();
+        texture::stack()->pop();
+        framebuffer::stack()->pop();
+
+        // 4. Transparent objects, forward-shaded over the lit opaque result
+        if (transparent_root) {
+            framebuffer::stack()->push(framebuffer::stack()->top(), m_transparent_state);
+            scene::graph()->drawSubtree(transparent_root);
+            framebuffer::stack()->pop();
+        }
+    }
+
+    /** @brief Gets the G-buffer (null until the first deferred frame) */
+    framebuffer::FramebufferPtr getGBuffer() const { return m_gbuffer; }
+
+    /** @brief Gets counters of the last deferred frame */
+    const DeferredStats& getStats() const { return m_stats; }
+};
+
+} // namespace deferred
+
+#endif // DEFERRED_RENDERER_H
@@ -7,6 +7,12 @@
     #define MAX_SCENE_LIGHTS 16
 #endif
 
+// Allow users to override how many lights a single draw may receive when
+// per-object light selection is enabled
+#ifndef MAX_LIGHTS_PER_OBJECT
+    #define MAX_LIGHTS_PER_OBJECT 8
+#endif
+
 namespace light {
     /**
      * @brief Maximum number of lights supported by the scene.
@@ -27,6 +33,30 @@ namespace light {
      * @note Default value is 16 if not defined by the user.
      */
     constexpr size_t max_scene_lights = MAX_SCENE_LIGHTS;
+
+    /**
+     * @brief Maximum number of lights selected for a single draw call.
+     * 
+     * When per-object light selection is enabled on the light manager, each
+     * drawable receives the indices of at most this many lights (the most
+     * significant ones for its world bounds) through the ObjectLights UBO.
+     * Shaders then loop over this short list instead of every active light.
+     * 
+     * Users can override this value by defining MAX_LIGHTS_PER_OBJECT before
+     * including EnGene headers:
+     * 
+     * @code
+     * #define MAX_LIGHTS_PER_OBJECT 4
+     * #include <EnGene.h>
+     * @endcode
+     * 
+     * @note This value must match MAX_LIGHTS_PER_OBJECT in your shader code.
+     * @note Default value is 8 if not defined by the user.
+     */
+    constexpr size_t max_lights_per_object = MAX_LIGHTS_PER_OBJECT;
+
+    static_assert(max_lights_per_object > 0 && max_lights_per_object <= max_scene_lights,
+                  "MAX_LIGHTS_PER_OBJECT must be in the range [1, MAX_SCENE_LIGHTS]");
 }
 
 #endif // LIGHT_CONFIG_H
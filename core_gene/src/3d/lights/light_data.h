@@ -192,6 +192,44 @@ struct SceneLights {
     int padding[3];
 };
 
+/**
+ * @brief Per-draw light selection with GPU-compatible layout.
+ * 
+ * This structure holds the indices (into SceneLights::lights) of the lights
+ * selected for the object currently being drawn. It is uploaded to the GPU as
+ * the "ObjectLights" uniform block right before each draw when
+ * per-object light selection is enabled.
+ * 
+ * Indices are packed four per ivec4 because std140 gives every element of a
+ * scalar array a 16-byte stride. In GLSL, index i is read as
+ * `light_indices[i / 4][i % 4]`.
+ * 
+ * @tparam MAX_PER_OBJECT Maximum number of lights selected per draw.
+ *                        This should match MAX_LIGHTS_PER_OBJECT from light_config.h.
+ * 
+ * @note A light_count of -1 means selection is disabled and shaders should
+ *       fall back to iterating every active light in SceneLights.
+ */
+template<size_t MAX_PER_OBJECT>
+struct ObjectLights {
+    /**
+     * @brief Selected light indices, packed four per ivec4.
+     * 
+     * Only the first light_count entries are meaningful.
+     */
+    glm::ivec4 light_indices[(MAX_PER_OBJECT + 3) / 4];
+
+    /**
+     * @brief Number of selected lights, or -1 when selection is disabled.
+     */
+    int light_count;
+
+    /**
+     * @brief Padding to align structure to vec4 boundary.
+     */
+    int padding[3];
+};
+
 } // namespace light
 
 #endif // LIGHT_DATA_H
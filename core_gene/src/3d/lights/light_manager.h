@@ -10,9 +10,14 @@
 #include "spot_light.h"
 #include "../../gl_base/uniforms/ubo.h"
 #include "../../gl_base/uniforms/global_resource_manager.h"
+#include "../../gl_base/gl_state.h"
+#include "../../core/frame_arena.h"
+#include "../../utils/simd_math.h"
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <cmath>
+#include <cstring>
 #include <glm/glm.hpp>
 
 
@@ -25,6 +30,27 @@ using LightComponentPtr = std::shared_ptr<LightComponent>;
 
 namespace light {
 
+/**
+ * @brief Counters describing per-object light selection over one frame.
+ * 
+ * Filled by LightManagerImpl::selectLightsFor() during traversal and rolled
+ * over on every apply() call, so getSelectionStats() always reports the last
+ * complete frame.
+ */
+struct LightSelectionStats {
+    size_t draws = 0;             ///< Number of draws that went through light selection
+    size_t candidate_lights = 0;  ///< Sum over draws of the active lights that were tested
+    size_t selected_lights = 0;   ///< Sum over draws of the lights written to ObjectLights
+
+    /**
+     * @brief Average number of lights each draw ended up evaluating.
+     * @return selected_lights / draws, or 0 if nothing was drawn.
+     */
+    float averageLightsPerDraw() const {
+        return draws ? static_cast<float>(selected_lights) / static_cast<float>(draws) : 0.0f;
+    }
+};
+
 /**
  * @brief Templated implementation of the light manager.
  * 
@@ -72,6 +98,84 @@ private:
      * before uploading to the GPU. It is updated in the apply() method.
      */
     SceneLights<MAX_LIGHTS> m_scene_data;
+
+    /**
+     * @brief Uniform Buffer Object for the "ObjectLights" block at binding point 3.
+     * 
+     * Only holds the fallback (light_count of -1) bound while selection is
+     * disabled. Per-draw selections are written to m_selection_buffer instead.
+     */
+    uniform::UBOPtr<ObjectLights<max_lights_per_object>> m_object_resource;
+
+    /**
+     * @brief CPU-side buffer for the fallback selection.
+     */
+    ObjectLights<max_lights_per_object> m_object_data;
+
+    /**
+     * @brief Selection last written by selectLightsFor(), so a draw selecting
+     *        the same lights as the previous one skips the upload.
+     */
+    ObjectLights<max_lights_per_object> m_bound_selection;
+
+    /**
+     * @brief Stream buffer that per-draw selections are appended to.
+     * 
+     * Each selection gets its own slot and is bound with glBindBufferRange, so
+     * no upload overwrites data that an earlier draw may still be reading.
+     * When the buffer is full its storage is orphaned and writing starts over
+     * at the front.
+     */
+    GLuint m_selection_buffer = 0;
+    size_t m_selection_stride = 0;    ///< sizeof(ObjectLights) rounded up to the UBO offset alignment
+    size_t m_selection_capacity = 0;  ///< Slots in m_selection_buffer
+    size_t m_selection_cursor = 0;    ///< First slot not written since the storage was orphaned
+    GLintptr m_bound_offset = -1;     ///< Offset of the slice bound to binding point 3, or -1
+    GLintptr m_selected_offset = -1;  ///< Offset m_bound_selection was written to, or -1
+
+    static constexpr size_t INITIAL_SELECTION_SLOTS = 1024;
+
+    // Selections staged by stageLightsFor(), in m_selection_stride steps
+    unsigned char* m_batch_data = nullptr;
+    size_t m_batch_size = 0;   ///< Slots staged
+    size_t m_batch_limit = 0;  ///< Slots allocated in the frame arena
+    size_t m_batch_first = 0;  ///< Stream buffer slot the uploaded batch starts at
+
+    /**
+     * @brief World-space influence radius of each packed light.
+     * 
+     * Computed in apply() from the attenuation coefficients. A negative value
+     * means the light has unbounded influence (directional lights).
+     */
+    float m_light_ranges[MAX_LIGHTS];
+
+    /**
+     * @brief Whether per-object light selection is active.
+     */
+    bool m_selection_enabled = false;
+
+    /**
+     * @brief Whether the "select everything" fallback is what the GPU currently holds.
+     */
+    bool m_fallback_uploaded = false;
+
+    /**
+     * @brief Attenuation below which a light no longer counts as influencing an object.
+     */
+    float m_influence_threshold = 1.0f / 256.0f;
+
+    LightSelectionStats m_frame_stats;
+    LightSelectionStats m_last_frame_stats;
+
+    struct SubmittedLight {
+        const Light* light;
+        glm::mat4 world_transform;
+    };
+
+    /**
+     * @brief Lights passed to submitLight() since the last apply().
+     */
+    std::vector<SubmittedLight> m_submitted_lights;
     
     /**
      * @brief Private constructor to enforce singleton pattern.
@@ -96,6 +200,264 @@ private:
         
         // Set the data provider lambda
         m_light_resource->setProvider([this]() { return m_scene_data; });
+
+        // Per-draw selection starts in fallback mode (shaders use every active light)
+        for (size_t i = 0; i < MAX_LIGHTS; ++i) {
+            m_light_ranges[i] = -1.0f;
+        }
+        for (auto& packed : m_object_data.light_indices) {
+            packed = glm::ivec4(0);
+        }
+        m_object_data.light_count = -1;
+
+        m_object_resource = uniform::UBO<ObjectLights<max_lights_per_object>>::Make(
+            "ObjectLights",
+            uniform::UpdateMode::ON_DEMAND,
+            3  // Binding point 3
+        );
+        m_object_resource->setProvider([this]() { return m_object_data; });
+    }
+
+    /**
+     * @brief Packs one light into slot `light_index` of the CPU buffer.
+     * @param light The light to pack.
+     * @param world_transform Transform from the light's local space to world space.
+     * @param light_index Slot in m_scene_data.lights (must be below MAX_LIGHTS).
+     */
+    void packLight(const Light& light, const glm::mat4& world_transform, size_t light_index) {
+        LightData& data = m_scene_data.lights[light_index];
+
+        // Pack common properties
+        data.ambient = light.getAmbient();
+        data.diffuse = light.getDiffuse();
+        data.specular = light.getSpecular();
+        data.type = static_cast<int>(light.getType());
+        
+        // Type-specific packing
+        if (auto dir_light = dynamic_cast<const DirectionalLight*>(&light)) {
+            // Transform direction to world space (w=0 for directions)
+            glm::vec4 world_dir = simd::transform(world_transform, glm::vec4(dir_light->getBaseDirection(), 0.0f));
+            data.direction = glm::normalize(world_dir);
+            data.position = glm::vec4(0.0f);  // Unused for directional
+            data.attenuation = glm::vec4(0.0f);  // Unused for directional
+        }
+        else if (auto spot_light = dynamic_cast<const SpotLight*>(&light)) {
+            // Transform position to world space
+            data.position = simd::transform(world_transform, spot_light->getPosition());
+            // Transform direction to world space and normalize
+            glm::vec4 world_dir = simd::transform(world_transform, glm::vec4(spot_light->getBaseDirection(), 0.0f));
+            data.direction = glm::normalize(world_dir);
+            // Pack constant, linear, quadratic, cutoff_angle
+            data.attenuation = glm::vec4(
+                spot_light->getConstant(),
+                spot_light->getLinear(),
+                spot_light->getQuadratic(),
+                spot_light->getCutoffAngle()
+            );
+        }
+        else if (auto point_light = dynamic_cast<const PointLight*>(&light)) {
+            // Transform position to world space (w=1 for positions)
+            data.position = world_transform * point_light->getPosition();
+            // Pack constant, linear, quadratic into attenuation vec4
+            data.attenuation = glm::vec4(
+                point_light->getConstant(),
+                point_light->getLinear(),
+                point_light->getQuadratic(),
+                0.0f  // cutoff unused for point lights
+            );
+            data.direction = glm::vec4(0.0f);  // Unused for point lights
+        }
+
+        m_light_ranges[light_index] = (data.type == static_cast<int>(LightType::DIRECTIONAL))
+            ? -1.0f
+            : computeInfluenceRange(data.attenuation, lightIntensity(data));
+    }
+
+    /**
+     * @brief Computes the distance at which a light's attenuation drops below the threshold.
+     * 
+     * Solves `quadratic * d^2 + linear * d + constant = intensity / threshold` for d.
+     * 
+     * @param attenuation Packed (constant, linear, quadratic, cutoff) coefficients.
+     * @param intensity Brightest color channel of the light.
+     * @return The influence radius, or a negative value if the light never falls off.
+     */
+    float computeInfluenceRange(const glm::vec4& attenuation, float intensity) const {
+        float c = attenuation.x;
+        float l = attenuation.y;
+        float q = attenuation.z;
+        float limit = intensity / m_influence_threshold;
+
+        if (limit <= c) {
+            return 0.0f;
+        }
+        if (q > 0.0f) {
+            return (-l + std::sqrt(l * l + 4.0f * q * (limit - c))) / (2.0f * q);
+        }
+        if (l > 0.0f) {
+            return (limit - c) / l;
+        }
+        return -1.0f;
+    }
+
+    /**
+     * @brief Brightest color channel of a packed light, used as its intensity.
+     */
+    static float lightIntensity(const LightData& data) {
+        glm::vec3 peak = glm::max(glm::vec3(data.diffuse), glm::vec3(data.specular));
+        peak = glm::max(peak, glm::vec3(data.ambient));
+        return std::max(peak.r, std::max(peak.g, peak.b));
+    }
+    
+    /**
+     * @brief Ranks the active lights for one drawable (see selectLightsFor()).
+     * @param out Receives the selected indices and their count.
+     */
+    void computeSelection(const glm::mat4& model, const glm::vec3& local_center, float local_radius,
+                          ObjectLights<max_lights_per_object>& out) {
+        glm::vec3 center = simd::transformPoint(model, local_center);
+        float scale = std::max(glm::length(glm::vec3(model[0])),
+                      std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+        float radius = local_radius * scale;
+
+        // Fixed-size candidate list, kept sorted by descending score
+        int best_index[max_lights_per_object];
+        float best_score[max_lights_per_object];
+        size_t selected = 0;
+
+        size_t active = static_cast<size_t>(m_scene_data.active_light_count);
+        for (size_t i = 0; i < active; ++i) {
+            const LightData& data = m_scene_data.lights[i];
+            LightType type = static_cast<LightType>(data.type);
+            float attenuation = 1.0f;
+
+            if (type == LightType::POINT || type == LightType::SPOT) {
+                glm::vec3 to_object = center - glm::vec3(data.position);
+                float center_dist = glm::length(to_object);
+                float dist = std::max(center_dist - radius, 0.0f);
+
+                if (m_light_ranges[i] >= 0.0f && dist > m_light_ranges[i]) {
+                    continue;
+                }
+
+                if (type == LightType::SPOT && center_dist > radius) {
+                    // Widen the cone by the angular size of the bounding sphere
+                    float cos_to_object = glm::dot(to_object / center_dist, glm::vec3(data.direction));
+                    float object_angle = std::asin(std::min(radius / center_dist, 1.0f));
+                    float cone_angle = std::acos(glm::clamp(data.attenuation.w, -1.0f, 1.0f));
+                    if (std::acos(glm::clamp(cos_to_object, -1.0f, 1.0f)) > cone_angle + object_angle) {
+                        continue;
+                    }
+                }
+
+                attenuation = 1.0f / (data.attenuation.x + data.attenuation.y * dist + data.attenuation.z * dist * dist);
+            }
+            else if (type != LightType::DIRECTIONAL) {
+                continue;
+            }
+
+            float score = lightIntensity(data) * attenuation;
+
+            // Insertion into the bounded, sorted candidate list
+            size_t slot = selected;
+            while (slot > 0 && best_score[slot - 1] < score) {
+                if (slot < max_lights_per_object) {
+                    best_score[slot] = best_score[slot - 1];
+                    best_index[slot] = best_index[slot - 1];
+                }
+                --slot;
+            }
+            if (slot < max_lights_per_object) {
+                best_score[slot] = score;
+                best_index[slot] = static_cast<int>(i);
+                if (selected < max_lights_per_object) {
+                    ++selected;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < selected; ++i) {
+            out.light_indices[i / 4][static_cast<int>(i % 4)] = best_index[i];
+        }
+        out.light_count = static_cast<int>(selected);
+
+        m_frame_stats.draws++;
+        m_frame_stats.candidate_lights += active;
+        m_frame_stats.selected_lights += selected;
+    }
+
+    static bool sameSelection(const ObjectLights<max_lights_per_object>& a,
+                              const ObjectLights<max_lights_per_object>& b) {
+        if (a.light_count != b.light_count) {
+            return false;
+        }
+        for (int i = 0; i < a.light_count; ++i) {
+            if (a.light_indices[i / 4][i % 4] != b.light_indices[i / 4][i % 4]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Creates the selection stream buffer and works out its slot stride.
+     */
+    void createSelectionBuffer() {
+        if (m_selection_buffer != 0) {
+            return;
+        }
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        size_t align = alignment > 0 ? static_cast<size_t>(alignment) : 256;
+        m_selection_stride = (sizeof(ObjectLights<max_lights_per_object>) + align - 1) / align * align;
+        glGenBuffers(1, &m_selection_buffer);
+    }
+
+    /**
+     * @brief Appends `count` slots to the selection stream buffer.
+     * 
+     * Orphans the storage first if the slots do not fit behind the cursor, so
+     * draws that are still queued keep reading the old storage.
+     * 
+     * @param data Selections, m_selection_stride bytes apart.
+     * @param count Number of slots written.
+     * @param bytes Bytes to copy from data.
+     * @return The first slot written.
+     */
+    size_t uploadSelections(const void* data, size_t count, size_t bytes) {
+        createSelectionBuffer();
+        gl_state::cache()->bindBuffer(GL_UNIFORM_BUFFER, m_selection_buffer);
+        if (m_selection_cursor + count > m_selection_capacity) {
+            if (count > m_selection_capacity) {
+                m_selection_capacity = std::max(count, std::max(m_selection_capacity * 2, INITIAL_SELECTION_SLOTS));
+            }
+            glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_selection_capacity * m_selection_stride),
+                         nullptr, GL_STREAM_DRAW);
+            m_selection_cursor = 0;
+            m_bound_offset = -1;
+            m_selected_offset = -1;
+        }
+        size_t first = m_selection_cursor;
+        glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(first * m_selection_stride),
+                        static_cast<GLsizeiptr>(bytes), data);
+        stats::current().ubo_bytes += bytes;
+        m_selection_cursor += count;
+        return first;
+    }
+
+    /**
+     * @brief Binds one slot of the selection stream buffer as the ObjectLights block.
+     */
+    void bindSelectionSlot(size_t slot) {
+        GLintptr offset = static_cast<GLintptr>(slot * m_selection_stride);
+        if (offset == m_bound_offset) {
+            return;
+        }
+        gl_state::cache()->bindBufferRange(GL_UNIFORM_BUFFER, m_object_resource->getBindingPoint(),
+                                           m_selection_buffer, offset,
+                                           sizeof(ObjectLights<max_lights_per_object>));
+        m_bound_offset = offset;
+        m_fallback_uploaded = false;
     }
     
     // Friend declaration for singleton accessor
@@ -144,6 +506,20 @@ public:
         }
     }
 
+    /**
+     * @brief Adds a light that is not owned by a LightComponent to the next apply().
+     *
+     * Submitted lights are packed after the registered components and forgotten
+     * once apply() has run, so they must be submitted again every frame. The
+     * light must stay alive until then.
+     *
+     * @param light The light to pack.
+     * @param world_transform Transform from the light's local space to world space.
+     */
+    void submitLight(const Light& light, const glm::mat4& world_transform) {
+        m_submitted_lights.push_back(SubmittedLight{&light, world_transform});
+    }
+
     /**
      * @brief Binds the managed light UBO to a specific shader program.
      * 
@@ -170,6 +546,187 @@ public:
         // Add the resource to the shader's binding list (deferred binding)
         // This is consistent with how Camera::bindToShader works
         shader_obj->addResourceBlockToBind(m_light_resource->getName());
+        if (m_object_resource) {
+            shader_obj->addResourceBlockToBind(m_object_resource->getName());
+        }
+    }
+
+    /**
+     * @brief Enables or disables per-object light selection.
+     * 
+     * When enabled, every GeometryComponent calls selectLightsFor() right
+     * before drawing, so shaders reading the ObjectLights block only loop
+     * over the lights that can actually reach the object. When disabled,
+     * ObjectLights reports a light_count of -1 and shaders fall back to
+     * every active light.
+     * 
+     * @param enabled True to select lights per draw.
+     */
+    void setObjectLightSelection(bool enabled) {
+        m_selection_enabled = enabled;
+        m_fallback_uploaded = false;
+    }
+
+    /**
+     * @brief Checks whether per-object light selection is enabled.
+     */
+    bool isObjectLightSelectionEnabled() const { return m_selection_enabled; }
+
+    /**
+     * @brief Sets the attenuation below which a light is considered out of range.
+     * 
+     * Lower values give larger influence volumes (fewer visible cut-offs, more
+     * lights per draw). Takes effect on the next apply().
+     * 
+     * @param threshold Attenuation factor in (0, 1]. Default is 1/256.
+     */
+    void setInfluenceThreshold(float threshold) {
+        if (threshold <= 0.0f) {
+            std::cerr << "Warning: LightManager influence threshold must be positive. Ignoring "
+                      << threshold << "." << std::endl;
+            return;
+        }
+        m_influence_threshold = threshold;
+    }
+
+    /**
+     * @brief Gets the world-space light data packed by the last apply().
+     * 
+     * Used by renderers that do their own light assignment (e.g. the tiled
+     * deferred lighting pass).
+     */
+    const SceneLights<MAX_LIGHTS>& getSceneData() const { return m_scene_data; }
+
+    /**
+     * @brief Gets the influence radius of a packed light.
+     * @param index Index into getSceneData().lights.
+     * @return World-space radius, or a negative value for unbounded lights.
+     */
+    float getLightRange(size_t index) const {
+        return index < MAX_LIGHTS ? m_light_ranges[index] : -1.0f;
+    }
+
+    /**
+     * @brief Gets the per-object selection counters of the last complete frame.
+     */
+    const LightSelectionStats& getSelectionStats() const { return m_last_frame_stats; }
+
+    /**
+     * @brief Selects the most significant lights for one drawable and binds them.
+     * 
+     * The drawable's bounding sphere is transformed to world space and tested
+     * against every active light packed by the last apply():
+     * - Directional lights always pass.
+     * - Point lights pass if the sphere intersects their influence sphere.
+     * - Spot lights additionally require the sphere to intersect their cone.
+     * 
+     * Passing lights are ranked by intensity times attenuation at the
+     * closest point of the sphere, and the top MAX_LIGHTS_PER_OBJECT indices
+     * are written to a fresh slot of the selection stream buffer, which is
+     * then bound as the ObjectLights block. If the previous call selected the
+     * same lights, its slot stays bound and nothing is uploaded.
+     * 
+     * @param model World transform of the drawable.
+     * @param local_center Bounding sphere center in model space.
+     * @param local_radius Bounding sphere radius in model space.
+     * 
+     * @note Called automatically by GeometryComponent when selection is enabled.
+     *       Code drawing many objects in one loop should stage them instead
+     *       (see beginSelectionBatch()).
+     */
+    void selectLightsFor(const glm::mat4& model, const glm::vec3& local_center, float local_radius) {
+        if (!m_selection_enabled) {
+            return;
+        }
+
+        ObjectLights<max_lights_per_object> selection{};
+        computeSelection(model, local_center, local_radius, selection);
+
+        if (m_selected_offset >= 0 && m_bound_offset == m_selected_offset
+                && sameSelection(selection, m_bound_selection)) {
+            return;
+        }
+        m_bound_selection = selection;
+        size_t slot = uploadSelections(&selection, 1, sizeof(selection));
+        bindSelectionSlot(slot);
+        m_selected_offset = m_bound_offset;
+    }
+
+    /**
+     * @brief Starts staging the light selections of up to `max_draws` draws.
+     * 
+     * Batched selection replaces one selectLightsFor() per draw with:
+     * 1. beginSelectionBatch(), then stageLightsFor() for every draw
+     * 2. uploadSelectionBatch(), a single glBufferSubData for the whole batch
+     * 3. bindSelection() with each draw's slot right before drawing it
+     * 
+     * Staged selections live in the frame arena, so a batch must be uploaded
+     * and drawn within the frame that staged it. All four calls do nothing
+     * while selection is disabled.
+     * 
+     * @param max_draws Upper bound on the stageLightsFor() calls that follow.
+     */
+    void beginSelectionBatch(size_t max_draws) {
+        m_batch_size = 0;
+        m_batch_limit = 0;
+        if (!m_selection_enabled || max_draws == 0) {
+            return;
+        }
+        createSelectionBuffer();
+        m_batch_data = static_cast<unsigned char*>(
+            arena::frame().allocate(max_draws * m_selection_stride, alignof(glm::ivec4)));
+        m_batch_limit = max_draws;
+    }
+
+    /**
+     * @brief Selects lights for one draw of the current batch (see selectLightsFor()).
+     * @return The slot to pass to bindSelection(). Consecutive draws selecting
+     *         the same lights share a slot.
+     */
+    uint32_t stageLightsFor(const glm::mat4& model, const glm::vec3& local_center, float local_radius) {
+        if (m_batch_limit == 0) {
+            return 0;
+        }
+
+        ObjectLights<max_lights_per_object> selection{};
+        computeSelection(model, local_center, local_radius, selection);
+
+        if (m_batch_size > 0) {
+            const auto* last = reinterpret_cast<const ObjectLights<max_lights_per_object>*>(
+                m_batch_data + (m_batch_size - 1) * m_selection_stride);
+            if (sameSelection(selection, *last)) {
+                return static_cast<uint32_t>(m_batch_size - 1);
+            }
+        }
+        if (m_batch_size == m_batch_limit) {
+            std::cerr << "Warning: LightManager batch has more draws than beginSelectionBatch() reserved. "
+                      << "Reusing the last selection." << std::endl;
+            return static_cast<uint32_t>(m_batch_size - 1);
+        }
+        std::memcpy(m_batch_data + m_batch_size * m_selection_stride, &selection, sizeof(selection));
+        return static_cast<uint32_t>(m_batch_size++);
+    }
+
+    /**
+     * @brief Uploads every selection staged since beginSelectionBatch() at once.
+     */
+    void uploadSelectionBatch() {
+        m_batch_limit = 0;
+        if (m_batch_size == 0) {
+            return;
+        }
+        size_t bytes = (m_batch_size - 1) * m_selection_stride + sizeof(ObjectLights<max_lights_per_object>);
+        m_batch_first = uploadSelections(m_batch_data, m_batch_size, bytes);
+    }
+
+    /**
+     * @brief Binds the selection a stageLightsFor() call returned, after uploadSelectionBatch().
+     */
+    void bindSelection(uint32_t slot) {
+        if (!m_selection_enabled || slot >= m_batch_size) {
+            return;
+        }
+        bindSelectionSlot(m_batch_first + slot);
     }
     
     /**
@@ -193,6 +750,10 @@ public:
      * @note Lights beyond MAX_LIGHTS are ignored with a warning message.
      */
     void apply() {
+        // Roll per-object selection counters over to the frame that just finished
+        m_last_frame_stats = m_frame_stats;
+        m_frame_stats = LightSelectionStats{};
+
         // Reset active count
         m_scene_data.active_light_count = 0;
         
@@ -235,58 +796,37 @@ public:
             light::LightPtr light = component->getLight();
             if (!light) continue;
             
-            LightData& data = m_scene_data.lights[light_index];
-            glm::mat4 world_transform = component->getWorldTransform();
-            
-            // Pack common properties
-            data.ambient = light->getAmbient();
-            data.diffuse = light->getDiffuse();
-            data.specular = light->getSpecular();
-            data.type = static_cast<int>(light->getType());
-            
-            // Type-specific packing
-            if (auto dir_light = dynamic_cast<DirectionalLight*>(light.get())) {
-                // Transform direction to world space (w=0 for directions)
-                glm::vec4 world_dir = world_transform * glm::vec4(dir_light->getBaseDirection(), 0.0f);
-                data.direction = glm::normalize(world_dir);
-                data.position = glm::vec4(0.0f);  // Unused for directional
-                data.attenuation = glm::vec4(0.0f);  // Unused for directional
-            }
-            else if (auto spot_light = dynamic_cast<SpotLight*>(light.get())) {
-                // Transform position to world space
-                data.position = world_transform * spot_light->getPosition();
-                // Transform direction to world space and normalize
-                glm::vec4 world_dir = world_transform * glm::vec4(spot_light->getBaseDirection(), 0.0f);
-                data.direction = glm::normalize(world_dir);
-                // Pack constant, linear, quadratic, cutoff_angle
-                data.attenuation = glm::vec4(
-                    spot_light->getConstant(),
-                    spot_light->getLinear(),
-                    spot_light->getQuadratic(),
-                    spot_light->getCutoffAngle()
-                );
-            }
-            else if (auto point_light = dynamic_cast<PointLight*>(light.get())) {
-                // Transform position to world space (w=1 for positions)
-                data.position = world_transform * point_light->getPosition();
-                // Pack constant, linear, quadratic into attenuation vec4
-                data.attenuation = glm::vec4(
-                    point_light->getConstant(),
-                    point_light->getLinear(),
-                    point_light->getQuadratic(),
-                    0.0f  // cutoff unused for point lights
-                );
-                data.direction = glm::vec4(0.0f);  // Unused for point lights
-            }
+            packLight(*light, component->getWorldTransform(), light_index);
+            light_index++;
+        }
 
-            
+        // Lights submitted for this frame by code outside the scene graph (e.g. the ECS backend)
+        for (const SubmittedLight& submitted : m_submitted_lights) {
+            if (light_index >= MAX_LIGHTS) {
+                std::cerr << "Warning: Scene has more lights than MAX_SCENE_LIGHTS (" 
+                          << MAX_LIGHTS << "). Extra lights will be ignored." << std::endl;
+                break;
+            }
+            packLight(*submitted.light, submitted.world_transform, light_index);
             light_index++;
         }
+        m_submitted_lights.clear();
         
         m_scene_data.active_light_count = static_cast<int>(light_index);
         
         // Trigger GPU upload
-        uniform::manager().applyShaderResource("SceneLights");
+        m_light_resource->apply();
+
+        // Without selection, tell shaders to use every active light
+        if (!m_selection_enabled && !m_fallback_uploaded) {
+            m_object_data.light_count = -1;
+            m_object_resource->apply();
+            gl_state::cache()->bindBufferBase(GL_UNIFORM_BUFFER, m_object_resource->getBindingPoint(),
+                                              m_object_resource->getBufferId());
+            m_bound_offset = -1;
+            m_selected_offset = -1;
+            m_fallback_uploaded = true;
+        }
     }
 };
 
@@ -8,8 +8,17 @@
 #include "gl_base/shader.h"
 #include "gl_base/transform.h"
 #include "gl_base/error.h"
+#include "gl_base/framebuffer.h"
+#include "gl_base/gl_state.h"
+#include "gl_base/frame_stats.h"
+#include "gl_base/headless_context.h"
 #include "core/EnGene_config.h"
 #include "core/scene.h"
+#include "core/profiler.h"
+#include "core/alloc_tracker.h"
+#include "core/frame_arena.h"
+#include "core/job_system.h"
+#include "core/sim_pipeline.h"
 #include "exceptions/base_exception.h"
 
 #include <iostream>
@@ -26,7 +35,8 @@ public:
      * @brief Constructs the EnGene application engine from a configuration struct.
      *
      * This constructor initializes GLFW, creates a window, sets up an OpenGL context,
-     * and prepares the main loop.
+     * and prepares the main loop. With config.headless, a windowless context and an
+     * internal default framebuffer are created instead.
      *
      * @param on_initialize A function that runs once for setup.
      * @param on_fixed_update A function for simulation logic, called at a fixed rate. It receives the fixed delta time.
@@ -45,6 +55,9 @@ public:
         m_title(config.title),
         m_fixed_timestep(1.0 / static_cast<double>(config.updatesPerSecond)),
         m_max_frame_time(config.maxFrameTime),
+        m_headless(config.headless),
+        m_headless_frames(config.headlessFrames),
+        m_pipelined(config.pipelined),
         m_input_handler(handler ? 
             std::unique_ptr<input::InputHandler>(handler) :
             std::make_unique<input::InputHandler>()
@@ -58,6 +71,10 @@ public:
         }
         
         m_fixed_timestep = 1.0 / static_cast<double>(config.updatesPerSecond);
+
+        if (config.jobWorkers >= 0) {
+            jobs::system().setWorkerCount(static_cast<size_t>(config.jobWorkers));
+        }
         
         initialize_window();
 
@@ -91,11 +108,13 @@ public:
         m_clear_color[3] = config.clearColor[3];
 
         glClearColor(m_clear_color[0], m_clear_color[1], m_clear_color[2], m_clear_color[3]);
-        glEnable(GL_DEPTH_TEST);
+        // Through the FramebufferStack so its state cache matches the GPU
+        framebuffer::stack()->depth().setTest(true);
         GL_CHECK("EnGene::end of constructor");
     }
 
     ~EnGene() {
+        m_simulation.reset();  // Joins the thread and releases the snapshots while the context exists
         if (m_window) {
             glfwTerminate();
         }
@@ -112,10 +131,44 @@ public:
         return m_base_shader;
     }
 
+    /**
+     * @brief Sets a function run on the main thread at every sync point of pipelined mode.
+     *
+     * The simulation thread is idle while it runs, so it may read simulation
+     * results and change the scene graph, cameras, materials, lights and GPU
+     * resources, which the simulation thread must leave alone.
+     */
+    void setSyncCallback(std::function<void()> on_sync) {
+        m_user_sync_func = std::move(on_sync);
+    }
+
+    /**
+     * @brief Checks whether on_fixed_update runs on a simulation thread (EnGeneConfig::pipelined).
+     */
+    bool isPipelined() const {
+        return m_pipelined;
+    }
+
+    /**
+     * @brief The ECS state on_render draws in pipelined mode, extracted one frame ago.
+     * @code
+     * app.getRenderSnapshot().submitLights();  // Instead of ecs::submitLights(ecs::world())
+     * app.getRenderSnapshot().draw();          // Instead of ecs::drawEntities(ecs::world())
+     * @endcode
+     * @throws exception::EnGeneException outside of run() or when not pipelined.
+     */
+    const ecs::RenderSnapshot& getRenderSnapshot() const {
+        if (!m_simulation) {
+            throw exception::EnGeneException("getRenderSnapshot() needs EnGeneConfig::pipelined and a running loop.");
+        }
+        return m_simulation->front();
+    }
+
     /**
      * @brief Starts the main application loop.
      * This function will not return until the user closes the window.
      * Implements a fixed-timestep simulation loop to decouple simulation from rendering framerate.
+     * In headless mode, runs config.headlessFrames frames and returns.
      */
     void run() {
         // Call the user's one-time setup code, passing a reference to this app.
@@ -123,10 +176,25 @@ public:
             m_user_initialize_func(*this);
         }
 
+        if (m_pipelined) {
+            m_simulation = std::make_unique<pipeline::SimulationThread>(m_user_fixed_update_func, m_fixed_timestep);
+        }
+
+        if (m_headless) {
+            run_headless();
+            finish_simulation();
+            return;
+        }
+
         double last_time = glfwGetTime();
         double accumulator = 0.0;
 
         while (!glfwWindowShouldClose(m_window)) {
+            // Transient render data of the frame before last is released here
+            arena::frame().beginFrame();
+#if ENGENE_PROFILING
+            profiling::profiler().beginFrame();
+#endif
             double current_time = glfwGetTime();
             double elapsed_time = current_time - last_time;
             last_time = current_time;
@@ -138,32 +206,50 @@ public:
 
             accumulator += elapsed_time;
 
-            // Performs fixed updates to catch the simulation up to the current time.
-            while (accumulator >= m_fixed_timestep) {
-                if (m_user_fixed_update_func) {
-                    m_user_fixed_update_func(m_fixed_timestep);
+            if (m_simulation) {
+                // The steps of this frame run on the simulation thread while the last one renders
+                int steps = 0;
+                while (accumulator >= m_fixed_timestep) {
+                    accumulator -= m_fixed_timestep;
+                    ++steps;
+                }
+                sync_simulation(steps);
+            } else {
+                // Performs fixed updates to catch the simulation up to the current time.
+                while (accumulator >= m_fixed_timestep) {
+                    ENGENE_PROFILE_SCOPE("FixedUpdate");
+                    ENGENE_ALLOC_SCOPE("FixedUpdate");
+                    transform::interpolation().beginStep();
+                    if (m_user_fixed_update_func) {
+                        m_user_fixed_update_func(m_fixed_timestep);
+                    }
+                    accumulator -= m_fixed_timestep;
                 }
-                accumulator -= m_fixed_timestep;
             }
 
             // This is the percentage of the way we are into the *next* simulation step.
             const double alpha = accumulator / m_fixed_timestep;
 
 
-            // Render the single, most recent state.
-            // All drawing code now belongs in the render callback.
-            shader::stack()->push(m_base_shader);
-            
-            if (m_user_render_func) {
-                uniform::manager().applyPerFrame();
-                m_user_render_func(alpha);
-            }
+            render_frame(alpha);
 
-            shader::stack()->pop();
+            {
+                ENGENE_PROFILE_SCOPE("Swap");
+                glfwSwapBuffers(m_window);
+                glfwPollEvents();
+            }
 
-            glfwSwapBuffers(m_window);
-            glfwPollEvents();
+            end_frame();
         }
+        finish_simulation();
+    }
+
+    /**
+     * @brief Checks whether the engine renders without a window.
+     * @note The rendered image lives in framebuffer::stack()->getDefaultTarget() ("color" texture).
+     */
+    bool isHeadless() const {
+        return m_headless;
     }
 
 private:
@@ -171,21 +257,154 @@ private:
     int m_height;
     std::string m_title;
     GLFWwindow* m_window = nullptr;
+    headless::HeadlessContextPtr m_headless_context; // Owns the context when headless (declared early, destroyed late)
     shader::ShaderPtr m_base_shader;
     std::unique_ptr<input::InputHandler> m_input_handler;
     double m_fixed_timestep; // This is the duration of one simulation step.
     double m_max_frame_time;
+    bool m_headless;
+    int m_headless_frames;
+    bool m_pipelined;
     float m_clear_color[4];
+    std::unique_ptr<pipeline::SimulationThread> m_simulation;  // Only while a pipelined run() is active
 
     // User-provided functions
     std::function<void(EnGene&)> m_user_initialize_func;
     std::function<void(double)> m_user_fixed_update_func; // For physics/simulation
     std::function<void(double)> m_user_render_func;
+    std::function<void()> m_user_sync_func;  // Pipelined mode only
+
+    /**
+     * @brief Renders the state `alpha` of the way from the previous fixed update to the latest.
+     * Interpolated transforms are blended by `alpha`; all drawing code belongs in the render callback.
+     */
+    void render_frame(double alpha) {
+        transform::interpolation().setAlpha(static_cast<float>(alpha));
+        shader::stack()->push(m_base_shader);
+        
+        if (m_user_render_func) {
+            {
+                ENGENE_PROFILE_SCOPE("ApplyPerFrame");
+                ENGENE_ALLOC_SCOPE("ApplyPerFrame");
+                uniform::manager().applyPerFrame();
+            }
+            ENGENE_PROFILE_GPU_SCOPE("Render");
+            ENGENE_ALLOC_SCOPE("Render");
+            m_user_render_func(alpha);
+        }
+
+        shader::stack()->pop();
+    }
+
+    /**
+     * @brief Sync point of pipelined mode: waits for the simulation thread, publishes
+     * its snapshot and starts it on the next `steps` fixed updates.
+     */
+    void sync_simulation(int steps) {
+        {
+            ENGENE_PROFILE_SCOPE("SimulationWait");
+            m_simulation->wait();
+        }
+        ENGENE_PROFILE_SCOPE("Sync");
+        ENGENE_ALLOC_SCOPE("Sync");
+        m_simulation->swap();
+        if (steps > 0) {
+            transform::interpolation().beginStep();
+        }
+        if (m_user_sync_func) {
+            m_user_sync_func();
+        }
+        m_simulation->start(steps);
+    }
+
+    /**
+     * @brief Lets the last pipelined step finish and stops the simulation thread.
+     */
+    void finish_simulation() {
+        if (m_simulation) {
+            m_simulation->wait();
+            m_simulation.reset();
+        }
+    }
+
+    /**
+     * @brief Per-frame bookkeeping after the frame was submitted.
+     */
+    void end_frame() {
+        // Release pooled framebuffers that have been idle for too long
+        framebuffer::pool()->nextFrame();
+        // Roll redundant-state counters over to getStats()
+        gl_state::cache()->nextFrame();
+        // Store this frame's render counters and run the stats callback
+        stats::history().nextFrame();
+#if ENGENE_PROFILING
+        profiling::profiler().endFrame();
+#endif
+#if ENGENE_ALLOC_TRACKING
+        // Close this frame's allocation counts (throws if zero-allocation checking is on)
+        allocation::tracker().nextFrame();
+#endif
+    }
+
+    /**
+     * @brief Fixed-length loop for headless mode.
+     * Every frame advances the simulation by exactly one fixed step, so batch
+     * output does not depend on how fast the machine renders. Pipelined, frame
+     * N shows the state after N - 1 steps while step N runs.
+     */
+    void run_headless() {
+        for (int frame = 0; frame < m_headless_frames; ++frame) {
+            arena::frame().beginFrame();
+#if ENGENE_PROFILING
+            profiling::profiler().beginFrame();
+#endif
+            if (m_simulation) {
+                sync_simulation(1);
+            } else if (m_user_fixed_update_func) {
+                ENGENE_PROFILE_SCOPE("FixedUpdate");
+                ENGENE_ALLOC_SCOPE("FixedUpdate");
+                transform::interpolation().beginStep();
+                m_user_fixed_update_func(m_fixed_timestep);
+            }
+
+            render_frame(1.0);  // The state right after this frame's step
+            {
+                ENGENE_PROFILE_SCOPE("Swap");
+                glFlush();
+            }
+
+            end_frame();
+        }
+        glFinish();
+    }
+
+    /**
+     * @brief Creates a windowless context and the framebuffer that replaces the window.
+     */
+    void initialize_headless() {
+        m_headless_context = headless::HeadlessContext::Make();
+
+        Error::EnableDebugCallback();
+
+        using framebuffer::attachment::Point;
+        using framebuffer::attachment::Format;
+        using framebuffer::attachment::StorageType;
+        auto target = framebuffer::Framebuffer::Make(m_width, m_height, {
+            framebuffer::Framebuffer::AttachmentSpec(Point::Color0, Format::RGBA8, StorageType::Texture, "color"),
+            framebuffer::Framebuffer::AttachmentSpec(Point::DepthStencil, Format::Depth24Stencil8)
+        });
+        framebuffer::stack()->setDefaultTarget(target);
+    }
 
     /**
      * @brief Handles all the boilerplate for setting up GLFW, GLAD, and the window.
      */
     void initialize_window() {
+        if (m_headless) {
+            initialize_headless();
+            return;
+        }
+
         glfwSetErrorCallback(glfw_error_callback);
 
         if (!glfwInit()) {
@@ -5,8 +5,10 @@
 #include "component.h"
 #include "../gl_base/shader.h"
 #include "../gl_base/transform.h"
+#include "../gl_base/gl_state.h"
 #include "../3d/camera/camera.h"
 #include "../gl_base/uniforms/uniform.h"
+#include "../utils/simd_math.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
@@ -59,6 +61,7 @@ public:
         return comp;
     }
 
+    ENGENE_COMPONENT_TYPE(ClipPlaneComponent, Component)
     virtual const char* getTypeName() const override { return "ClipPlaneComponent"; }
 
     void addPlane(float a, float b, float c, float d) {
@@ -103,7 +106,7 @@ public:
         // If no planes, just disable all clip distances and return
         if (m_localPlanes.empty()) {
             for (int i = 0; i < 6; ++i) {  // MAX_CLIP_PLANES = 6
-                glDisable(GL_CLIP_DISTANCE0 + i);
+                gl_state::cache()->setClipDistance(i, false);
             }
             return;
         }
@@ -116,8 +119,8 @@ public:
         if (camera)
             view = camera->getViewMatrix();
 
-        glm::mat4 modelView = view * model;
-        glm::mat4 mit = glm::transpose(glm::inverse(modelView));
+        glm::mat4 modelView = simd::multiply(view, model);
+        glm::mat4 mit = glm::transpose(simd::affineInverse(modelView));
 
         // Transform the planes
         m_transformedPlanes.clear();
@@ -134,12 +137,12 @@ public:
 
         // Enable the clip planes
         for (size_t i = 0; i < m_transformedPlanes.size(); ++i)
-            glEnable(GL_CLIP_DISTANCE0 + static_cast<int>(i));
+            gl_state::cache()->setClipDistance(static_cast<int>(i), true);
     }
 
     virtual void unapply() override {
         for (size_t i = 0; i < m_localPlanes.size(); ++i)
-            glDisable(GL_CLIP_DISTANCE0 + static_cast<int>(i));
+            gl_state::cache()->setClipDistance(static_cast<int>(i), false);
     }
 };
 
@@ -2,10 +2,23 @@
 #define COMPONENT_H
 #pragma once
 
+#include <bitset>
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include "../core/node.h"
 
+/**
+ * @brief Maximum number of component types (built-in and custom) with a type ID.
+ *
+ * Every type that uses ENGENE_COMPONENT_TYPE takes one bit of ComponentTypeMask.
+ */
+#ifndef ENGENE_MAX_COMPONENT_TYPES
+    #define ENGENE_MAX_COMPONENT_TYPES 128
+#endif
+
 class ComponentCollection;
 // Forward-declare SceneNode to avoid circular header includes.
 namespace scene { 
@@ -27,6 +40,84 @@ enum class ComponentPriority : unsigned int {
 class Component;
 using ComponentPtr = std::shared_ptr<Component>;
 
+using ComponentTypeId = uint32_t;
+using ComponentTypeMask = std::bitset<ENGENE_MAX_COMPONENT_TYPES>;
+
+namespace detail {
+
+inline ComponentTypeId nextComponentTypeId() {
+    static ComponentTypeId next = 0;
+    if (next >= ENGENE_MAX_COMPONENT_TYPES) {
+        throw std::runtime_error("Too many component types; raise ENGENE_MAX_COMPONENT_TYPES.");
+    }
+    return next++;
+}
+
+/**
+ * @brief Gets the ID of a component type. IDs are handed out on first use.
+ */
+template <typename T>
+ComponentTypeId componentTypeIdOf() {
+    static const ComponentTypeId id = nextComponentTypeId();
+    return id;
+}
+
+/**
+ * @brief Builds the mask of a component type: its own bit plus the masks of its component bases.
+ */
+template <typename Self, typename... Bases>
+ComponentTypeMask makeComponentTypeMask() {
+    ComponentTypeMask mask;
+    mask.set(componentTypeIdOf<Self>());
+    ((mask |= Bases::StaticTypeMask()), ...);
+    return mask;
+}
+
+/**
+ * @brief Converts `self` to the component base with type ID `id`, or returns nullptr.
+ * Only needed to reach a type through a virtual base, where static_cast cannot go.
+ */
+template <typename Self, typename... Bases>
+void* castComponentTo(Self* self, ComponentTypeId id) {
+    if (id == componentTypeIdOf<Self>()) {
+        return self;
+    }
+    void* result = nullptr;
+    ((result = result ? result : self->Bases::castToType(id)), ...);
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Gives a component class its own type ID and precomputed base-class mask.
+ *
+ * Put it in the public section of every component class, listing the component
+ * classes it derives from. ComponentCollection::get<T>() and getAll<T>() then
+ * find the component with a bit test instead of dynamic_cast:
+ * @code
+ * class PerspectiveCamera : public Camera3D {
+ * public:
+ *     ENGENE_COMPONENT_TYPE(PerspectiveCamera, Camera3D)
+ *     ...
+ * };
+ * @endcode
+ * Classes without it still work; looking them up by their own type falls back to dynamic_cast.
+ */
+#define ENGENE_COMPONENT_TYPE(Self, ...) \
+    using ComponentSelf = Self; \
+    static component::ComponentTypeId StaticTypeId() { \
+        return component::detail::componentTypeIdOf<Self>(); \
+    } \
+    static const component::ComponentTypeMask& StaticTypeMask() { \
+        static const component::ComponentTypeMask mask = component::detail::makeComponentTypeMask<Self, __VA_ARGS__>(); \
+        return mask; \
+    } \
+    const component::ComponentTypeMask& getTypeMask() const override { return StaticTypeMask(); } \
+    void* castToType(component::ComponentTypeId id) override { \
+        return component::detail::castComponentTo<Self, __VA_ARGS__>(this, id); \
+    }
+
 class Component {
 private:
     int id;
@@ -62,6 +153,19 @@ public:
     
     // Static version for ComponentCollection messages
     static const char* getTypeNameStatic() { return "Component"; }
+
+    using ComponentSelf = Component;
+    static ComponentTypeId StaticTypeId() { return detail::componentTypeIdOf<Component>(); }
+    static const ComponentTypeMask& StaticTypeMask() {
+        static const ComponentTypeMask mask = detail::makeComponentTypeMask<Component>();
+        return mask;
+    }
+
+    /// @brief The type IDs of this component's class and all its component bases
+    virtual const ComponentTypeMask& getTypeMask() const { return StaticTypeMask(); }
+
+    /// @brief Pointer to this component as the class with type ID `id`, or nullptr
+    virtual void* castToType(ComponentTypeId id) { return id == StaticTypeId() ? this : nullptr; }
     
     virtual void apply() {}
     virtual void unapply() {}
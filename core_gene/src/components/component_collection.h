@@ -6,39 +6,169 @@
 #include <algorithm>
 #include <memory>
 #include <unordered_map>
-#include <typeindex>
+#include <type_traits>
 #include <iostream>
 #include <stdexcept>
+#include <glm/glm.hpp>
 #include "component.h"
+#include "../core/profiler.h"
+#include "../core/alloc_tracker.h"
+#include "../ecs/entity.h"
 
 namespace scene {
     using SceneNode = node::Node<ComponentCollection>;
     using SceneNodePtr = std::shared_ptr<SceneNode>;
+
+    inline void markTransformDirty(SceneNode& node);
 }
 
 class ComponentCollection {
 private:
-    // For fast lookup of ALL components of a given type.
-    std::unordered_map<std::type_index, std::vector<component::ComponentPtr>> m_type_map;
-    
+    struct Entry {
+        component::ComponentPtr component;
+        const component::ComponentTypeMask* type_mask;  // Static mask of the component's class
+    };
+
     // For fast lookup of NAMED components. Enforces name uniqueness.
     std::unordered_map<std::string, component::ComponentPtr> m_name_map;
     
     // For sorted iteration during apply/unapply. Contains all components.
-    std::vector<component::ComponentPtr> m_components_vector;
+    std::vector<Entry> m_components_vector;
+
+    // Union of the type masks of all components, so a missing type is rejected in O(1)
+    component::ComponentTypeMask m_type_mask;
+
+    // The node's entity in ecs::world(), if its hot data lives in the ECS backend
+    ecs::Entity m_entity;
+
+    // World matrix of the node (parent world * all its TransformComponents), kept by scene::updateWorldTransforms()
+    glm::mat4 m_world_transform{1.0f};
+    bool m_transform_dirty = true;  // The node's own transforms or its parent changed
+    bool m_subtree_dirty = true;    // This node or one of its descendants needs its world matrix recomputed
     
     bool m_is_vector_sorted = false;
 
     void sortComponents() {
         std::sort(m_components_vector.begin(), m_components_vector.end(),
-            [](const component::ComponentPtr& a, const component::ComponentPtr& b) {
-                return a->getPriority() < b->getPriority();
+            [](const Entry& a, const Entry& b) {
+                return a.component->getPriority() < b.component->getPriority();
             }
         );
         m_is_vector_sorted = true;
     }
 
+    void rebuildTypeMask() {
+        m_type_mask.reset();
+        for (const auto& entry : m_components_vector) {
+            m_type_mask |= *entry.type_mask;
+        }
+    }
+
+    // True if T declares its own ID with ENGENE_COMPONENT_TYPE (otherwise lookups use dynamic_cast)
+    template <typename T>
+    static constexpr bool hasTypeId() {
+        return std::is_same<typename T::ComponentSelf, T>::value;
+    }
+
+    template <typename T, typename = void>
+    struct IsStaticDowncast : std::false_type {};
+    template <typename T>
+    struct IsStaticDowncast<T, std::void_t<decltype(static_cast<T*>(std::declval<component::Component*>()))>>
+        : std::true_type {};
+
+    /**
+     * @brief Returns the component of an entry as a T*, or nullptr if it is not a T.
+     */
+    template <typename T>
+    static T* match(const Entry& entry) {
+        if constexpr (hasTypeId<T>()) {
+            if (!entry.type_mask->test(T::StaticTypeId())) {
+                return nullptr;
+            }
+            if constexpr (IsStaticDowncast<T>::value) {
+                return static_cast<T*>(entry.component.get());
+            } else {
+                // T derives from Component through a virtual base
+                return static_cast<T*>(entry.component->castToType(T::StaticTypeId()));
+            }
+        } else {
+            return dynamic_cast<T*>(entry.component.get());
+        }
+    }
+
+    template <typename T>
+    bool mayContain() const {
+        if constexpr (hasTypeId<T>()) {
+            return m_type_mask.test(T::StaticTypeId());
+        } else {
+            return !m_components_vector.empty();
+        }
+    }
+
 public:
+    /**
+     * @class View
+     * @brief Non-owning range over the components of one type, returned by getAll().
+     *
+     * Iterating yields `T&`. The view is invalidated when a component is added
+     * or removed, or when apply(), unapply() or forEach() sorts the collection.
+     */
+    template <typename T>
+    class View {
+    private:
+        const Entry* m_begin;
+        const Entry* m_end;
+
+    public:
+        class iterator {
+        private:
+            const Entry* m_current;
+            const Entry* m_end;
+
+            void skip() {
+                while (m_current != m_end && !match<T>(*m_current)) {
+                    ++m_current;
+                }
+            }
+
+        public:
+            iterator(const Entry* current, const Entry* end) : m_current(current), m_end(end) { skip(); }
+
+            T& operator*() const { return *match<T>(*m_current); }
+            T* operator->() const { return match<T>(*m_current); }
+            iterator& operator++() { ++m_current; skip(); return *this; }
+            bool operator==(const iterator& other) const { return m_current == other.m_current; }
+            bool operator!=(const iterator& other) const { return m_current != other.m_current; }
+        };
+
+        View(const Entry* begin, const Entry* end) : m_begin(begin), m_end(end) {}
+
+        iterator begin() const { return iterator(m_begin, m_end); }
+        iterator end() const { return iterator(m_end, m_end); }
+        bool empty() const { return begin() == end(); }
+
+        size_t size() const {
+            size_t count = 0;
+            for (auto it = begin(); it != end(); ++it) {
+                ++count;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Copies the matching components into a vector of owning pointers.
+         */
+        std::vector<std::shared_ptr<T>> toVector() const {
+            std::vector<std::shared_ptr<T>> result;
+            for (const Entry* entry = m_begin; entry != m_end; ++entry) {
+                if (T* derived = match<T>(*entry)) {
+                    result.push_back(std::shared_ptr<T>(entry->component, derived));
+                }
+            }
+            return result;
+        }
+    };
+
     /**
      * @brief Adds a component to the collection. A node can have multiple components of the same type.
      * @tparam T The concrete component type.
@@ -58,9 +188,14 @@ public:
         }
 
         new_component->setOwner(owner);
-        m_type_map[std::type_index(typeid(*new_component))].push_back(new_component);
-        m_components_vector.push_back(new_component);
+        const component::ComponentTypeMask& type_mask = new_component->getTypeMask();
+        m_components_vector.push_back(Entry{new_component, &type_mask});
+        m_type_mask |= type_mask;
         m_is_vector_sorted = false;
+
+        if (owner) {
+            scene::markTransformDirty(*owner);
+        }
     }
 
     // --- Component Getters ---
@@ -68,30 +203,20 @@ public:
     /**
      * @brief Retrieves the FIRST UNNAMED component of a specific type.
      * Useful for components you often expect to be unique, like a camera.
+     * Finds subclasses too (get<Camera>() returns a PerspectiveCamera), by testing
+     * each component's type mask instead of using RTTI.
      * @tparam T The component type to retrieve.
      * @return A shared_ptr to the component, or nullptr if not found.
      */
     template <typename T>
     std::shared_ptr<T> get() const {
-        // auto map_it = m_type_map.find(std::type_index(typeid(T)));
-        // if (map_it != m_type_map.end()) {
-        //     for (const auto& comp : map_it->second) {
-        //         if (comp->getName().empty()) {
-        //             return std::dynamic_pointer_cast<T>(comp);
-        //         }
-        //     }
-        // }
-        // return nullptr;
-
-        // We must iterate the main vector to check for inheritance.
-        for (const auto& base_ptr : m_components_vector) {
-            // Try to dynamically cast to the requested type T
-            if (auto derived_ptr = std::dynamic_pointer_cast<T>(base_ptr)) {
-                // Cast succeeded, so base_ptr *is* an instance of T or a subclass of T.
-                // Now check if it's unnamed.
-                if (derived_ptr->getName().empty()) {
-                    return derived_ptr;
-                }
+        if (!mayContain<T>()) {
+            return nullptr;
+        }
+        for (const auto& entry : m_components_vector) {
+            T* derived = match<T>(entry);
+            if (derived && entry.component->getName().empty()) {
+                return std::shared_ptr<T>(entry.component, derived);
             }
         }
         return nullptr; // Not found
@@ -104,38 +229,84 @@ public:
     std::shared_ptr<T> get(const std::string& name) const {
         auto map_it = m_name_map.find(name);
         if (map_it != m_name_map.end()) {
-            return std::dynamic_pointer_cast<T>(map_it->second);
+            Entry entry{map_it->second, &map_it->second->getTypeMask()};
+            if (T* derived = match<T>(entry)) {
+                return std::shared_ptr<T>(map_it->second, derived);
+            }
         }
         return nullptr;
     }
 
     /**
-     * @brief Retrieves ALL components of a specific type.
+     * @brief Retrieves ALL components of a specific type, including subclasses.
      * @tparam T The component type to retrieve.
-     * @return A vector of shared_ptrs to the components. The vector will be empty if none are found.
+     * @return A view over the matching components; it allocates nothing and is empty if none are found.
+     * Use View::toVector() to keep them past the next change to the collection.
      */
     template <typename T>
-    std::vector<std::shared_ptr<T>> getAll() const {
-        std::vector<std::shared_ptr<T>> result;
-        // auto map_it = m_type_map.find(std::type_index(typeid(T)));
-        // if (map_it != m_type_map.end()) {
-        //     result.reserve(map_it->second.size());
-        //     for (const auto& base_ptr : map_it->second) {
-        //         if (auto derived_ptr = std::dynamic_pointer_cast<T>(base_ptr)) {
-        //             result.push_back(derived_ptr);
-        //         }
-        //     }
-        // }
-        for (const auto& base_ptr : m_components_vector) {
-            // Try to cast each component to T
-            if (auto derived_ptr = std::dynamic_pointer_cast<T>(base_ptr)) {
-                // Cast succeeded, add it to the list
-                result.push_back(derived_ptr);
+    View<T> getAll() const {
+        if (!mayContain<T>()) {
+            return View<T>(nullptr, nullptr);
+        }
+        const Entry* data = m_components_vector.data();
+        return View<T>(data, data + m_components_vector.size());
+    }
+
+    /**
+     * @brief Calls `fn(T&)` for every component of a specific type, in priority order.
+     * Unlike getAll(), this sorts the collection first; it does not allocate or
+     * touch reference counts, so it is safe to use on per-frame paths.
+     * @tparam T The component type to visit.
+     */
+    template <typename T, typename Fn>
+    void forEach(Fn&& fn) {
+        if (!m_is_vector_sorted) {
+            sortComponents();
+        }
+        if (!mayContain<T>()) {
+            return;
+        }
+        for (const auto& entry : m_components_vector) {
+            if (T* derived = match<T>(entry)) {
+                fn(*derived);
             }
         }
-        return result;
     }
 
+    // --- ECS Entity ---
+
+    /**
+     * @brief Links the node to an entity of ecs::world().
+     * The entity is not destroyed with the node.
+     */
+    void setEntity(ecs::Entity entity) { m_entity = entity; }
+
+    /**
+     * @brief Gets the node's entity, or an invalid entity if it has none.
+     */
+    ecs::Entity getEntity() const { return m_entity; }
+
+    // --- World Transform ---
+
+    /**
+     * @brief Gets the node's world matrix as of the last scene::updateWorldTransforms().
+     */
+    const glm::mat4& getWorldTransform() const { return m_world_transform; }
+
+    void setWorldTransform(const glm::mat4& world) { m_world_transform = world; }
+
+    bool isTransformDirty() const { return m_transform_dirty; }
+    bool isSubtreeDirty() const { return m_subtree_dirty; }
+
+    void markTransformDirty() { m_transform_dirty = true; m_subtree_dirty = true; }
+    void markSubtreeDirty() { m_subtree_dirty = true; }
+    void clearTransformDirty() { m_transform_dirty = false; m_subtree_dirty = false; }
+
+    /**
+     * @brief Called by the node when it is attached to or detached from a parent.
+     */
+    void onParentChanged(scene::SceneNode& node) { scene::markTransformDirty(node); }
+
     // --- Component Removers ---
 
     /**
@@ -145,21 +316,25 @@ public:
     bool removeComponent(const component::ComponentPtr& component_to_remove) {
         if (!component_to_remove) return false;
 
+        // Keep the component alive until we are done, even if the caller's pointer is the entry itself
+        component::ComponentPtr removed = component_to_remove;
+
         // Erase from the main vector
         auto& vec = m_components_vector;
-        auto it = std::remove(vec.begin(), vec.end(), component_to_remove);
+        auto it = std::remove_if(vec.begin(), vec.end(),
+            [&](const Entry& entry) { return entry.component == removed; });
         if (it == vec.end()) return false; // Not found
         vec.erase(it, vec.end());
 
         // Erase from name map if named
-        if (!component_to_remove->getName().empty()) {
-            m_name_map.erase(component_to_remove->getName());
+        if (!removed->getName().empty()) {
+            m_name_map.erase(removed->getName());
         }
 
-        // Erase from type map
-        auto& type_vec = m_type_map.at(std::type_index(typeid(*component_to_remove)));
-        type_vec.erase(std::remove(type_vec.begin(), type_vec.end(), component_to_remove), type_vec.end());
-
+        rebuildTypeMask();
+        if (scene::SceneNodePtr owner = removed->getOwner()) {
+            scene::markTransformDirty(*owner);
+        }
         return true;
     }
 
@@ -181,9 +356,9 @@ public:
      */
     bool removeComponent(int component_id) {
         component::ComponentPtr component_to_remove = nullptr;
-        for (const auto& comp : m_components_vector) {
-            if (comp->getId() == component_id) {
-                component_to_remove = comp;
+        for (const auto& entry : m_components_vector) {
+            if (entry.component->getId() == component_id) {
+                component_to_remove = entry.component;
                 break;
             }
         }
@@ -199,8 +374,11 @@ public:
         if (!m_is_vector_sorted) {
             sortComponents();
         }
-        for (const auto& component : m_components_vector) {
+        for (const auto& entry : m_components_vector) {
+            const component::ComponentPtr& component = entry.component;
             if (print) std::cout << "Component Type: " << component->getTypeName() << std::endl;
+            ENGENE_PROFILE_DETAIL_SCOPE(component->getTypeName(), profiling::Detail::Components);
+            ENGENE_ALLOC_SCOPE(component->getTypeName());
             component->apply();
         }
         if (print) std::cout << std::endl;
@@ -212,9 +390,29 @@ public:
         }
         // IMPORTANT: Unapply in REVERSE order of application.
         for (auto it = m_components_vector.rbegin(); it != m_components_vector.rend(); ++it) {
-            (*it)->unapply();
+            ENGENE_ALLOC_SCOPE(it->component->getTypeName());
+            it->component->unapply();
         }
     }
 };
 
+namespace scene {
+
+/**
+ * @brief Flags a node's world matrix as stale and its ancestors as having a stale descendant.
+ *
+ * Climbs until an ancestor that is already flagged, so a burst of changes
+ * under the same parent costs O(1) each after the first.
+ */
+inline void markTransformDirty(SceneNode& node) {
+    node.payload().markTransformDirty();
+    SceneNode* ancestor = SceneNode::Resolve(node.getParentHandle());
+    while (ancestor && !ancestor->payload().isSubtreeDirty()) {
+        ancestor->payload().markSubtreeDirty();
+        ancestor = SceneNode::Resolve(ancestor->getParentHandle());
+    }
+}
+
+} // namespace scene
+
 #endif
\ No newline at end of file
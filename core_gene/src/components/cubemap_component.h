@@ -103,6 +103,8 @@ public:
         }
     }
 
+    ENGENE_COMPONENT_TYPE(CubemapComponent, Component)
+
     /**
      * @brief Get the type name of this component.
      * @return "CubemapComponent"
@@ -219,6 +219,8 @@ public:
         framebuffer::stack()->pop();
     }
 
+    ENGENE_COMPONENT_TYPE(FramebufferComponent, Component)
+
     /**
      * @brief Gets the component type name.
      * @return The string "FramebufferComponent"
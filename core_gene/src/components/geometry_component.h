@@ -6,6 +6,8 @@
 #include "component.h"
 #include "../gl_base/geometry.h"
 #include "../gl_base/shader.h"
+#include "../gl_base/transform.h"
+#include "light_component.h"
 
 namespace component {
 
@@ -35,6 +37,10 @@ public:
     }
     
     virtual void apply() override {
+        auto& lights = light::manager();
+        if (lights.isObjectLightSelectionEnabled()) {
+            lights.selectLightsFor(transform::stack()->top(), m_geometry->getBoundsCenter(), m_geometry->getBoundsRadius());
+        }
         shader::stack()->top();
         m_geometry->Draw();
     }
@@ -44,6 +50,7 @@ public:
     }
 
     
+    ENGENE_COMPONENT_TYPE(GeometryComponent, Component)
     virtual const char* getTypeName() const override {
         return "GeometryComponent";
     }
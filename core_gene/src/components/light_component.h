@@ -131,6 +131,8 @@ public:
         return comp;
     }
 
+    ENGENE_COMPONENT_TYPE(LightComponent, ObservedTransformComponent)
+
     /**
      * @brief Get the type name of this component.
      * 
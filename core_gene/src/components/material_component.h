@@ -82,6 +82,8 @@ public:
         }
     }
 
+    ENGENE_COMPONENT_TYPE(MaterialComponent, Component)
+
     /**
      * @brief Returns the type name of this component.
      * @return "MaterialComponent"
@@ -4,6 +4,23 @@
 
 #include "transform_component.h"
 #include "../utils/observer_interface.h"
+#include "../core/job_system.h"
+
+/**
+ * @brief Children per job when scene::updateWorldTransforms() splits a wide node (default 256).
+ *
+ * A node whose world matrix changed and that has more children than this hands
+ * ranges of them (with their subtrees) to jobs::system(); smaller nodes are
+ * updated on the current thread.
+ */
+#ifndef ENGENE_TRANSFORM_JOB_CHILDREN
+    #define ENGENE_TRANSFORM_JOB_CHILDREN 256
+#endif
+
+namespace scene {
+inline void updateWorldTransforms(SceneNode& root);
+namespace detail { class WorldTransformPass; }
+}
 
 namespace component {
 
@@ -12,20 +29,22 @@ using ObservedTransformComponentPtr = std::shared_ptr<ObservedTransformComponent
 
 /**
  * @class ObservedTransformComponent
- * @brief A specialized transform component that caches its world transform during
- * scene traversal and notifies final observers of the updated value.
+ * @brief A specialized transform component that exposes its world transform and
+ * notifies final observers when it changes.
+ *
+ * The world transform is written by scene::updateWorldTransforms(), which walks
+ * only the dirty parts of the hierarchy once and then notifies every observed
+ * component whose world transform changed, exactly once. Moving a node does not
+ * notify its descendants directly; it only flags the node dirty.
  *
- * It acts as three things:
+ * It acts as two things:
  * 1. A TransformComponent: To integrate with the scene graph's transform stack.
- * 2. An IObserver: To listen for changes from the raw `transform::Transform` object.
- * 3. An ISubject: To notify final listeners (like cameras) after its cache is updated.
+ * 2. An ISubject: To notify final listeners (like cameras) after its cache is updated.
  */
-class ObservedTransformComponent : public TransformComponent, public IObserver, public ISubject {
+class ObservedTransformComponent : public TransformComponent, public ISubject {
 protected:
     glm::mat4 m_world_transform_cache;
-    bool m_is_dirty;
-    bool m_observers_registered;
-    std::vector<transform::TransformPtr> m_observed_transforms;
+    bool m_is_dirty;  // Only used without an owner, where the cache is the local transform
 
     ObservedTransformComponent(
         transform::TransformPtr t, 
@@ -35,102 +54,12 @@ protected:
     ) :
         TransformComponent(t, priority, min_bound, max_bound),
         m_world_transform_cache(1.0f),
-        m_is_dirty(true),
-        m_observers_registered(false)
-    {
-        // ** CRITICAL **: Subscribe to the raw transform object's notifications.
-        getTransform()->addObserver(this);
-    }
-
-    /**
-     * @brief Registers this component as an observer to all relevant transforms.
-     * This includes:
-     * - All ancestor transforms (from parent nodes up to root)
-     * - Sibling transforms with lower priority (on the same node)
-     */
-    void registerTransformObservers() {
-        // First, unregister from any previously observed transforms
-        unregisterTransformObservers();
-
-        if (!m_owner) {
-            return;
-        }
-
-        // 1. Register sibling transforms with lower priority on the same node
-        auto sibling_transforms = m_owner->payload().getAll<TransformComponent>();
-        for (const auto& transform_comp : sibling_transforms) {
-            if (transform_comp && transform_comp->getTransform() && 
-                transform_comp.get() != this && // Don't observe ourselves
-                transform_comp->getPriority() < this->getPriority()) { // Only lower priority
-                
-                transform_comp->getTransform()->addObserver(this);
-                m_observed_transforms.push_back(transform_comp->getTransform());
-            }
-        }
-
-        // 2. Walk up the scene graph and register as observer to all ancestor transforms
-        scene::SceneNodePtr current_parent = m_owner->getParent();
-        while (current_parent) {
-            auto ancestor_transforms = current_parent->payload().getAll<TransformComponent>();
-            
-            for (const auto& transform_comp : ancestor_transforms) {
-                if (transform_comp && transform_comp->getTransform()) {
-                    transform_comp->getTransform()->addObserver(this);
-                    m_observed_transforms.push_back(transform_comp->getTransform());
-                }
-            }
-            
-            current_parent = current_parent->getParent();
-        }
-    }
-
-    /**
-     * @brief Unregisters this component from all transform observations.
-     */
-    void unregisterTransformObservers() {
-        for (auto& transform : m_observed_transforms) {
-            if (transform) {
-                transform->removeObserver(this);
-            }
-        }
-        m_observed_transforms.clear();
-    }
-
+        m_is_dirty(true)
+    {}
 
-
-    /**
-     * @brief A helper to calculate the combined local transform for a given node.
-     * It fetches all TransformComponents, sorts them by priority, and multiplies their
-     * matrices in the correct order.
-     * @param node The node to process.
-     * @return The combined local transform matrix for the node.
-     */
-    glm::mat4 calculateCombinedLocalTransform(const scene::SceneNodePtr node) {
-        if (!node) return glm::mat4(1.0f);
-
-        auto all_local_transforms = node->payload().getAll<TransformComponent>();
-        std::sort(all_local_transforms.begin(), all_local_transforms.end(),
-            [](const std::shared_ptr<TransformComponent>& a, const std::shared_ptr<TransformComponent>& b) {
-                return a->getPriority() < b->getPriority();
-            }
-        );
-
-        glm::mat4 combined_local_transform(1.0f);
-        for (auto it = all_local_transforms.rbegin(); it != all_local_transforms.rend(); ++it) {
-            combined_local_transform = (*it)->getTransform()->getMatrix() * combined_local_transform;
-        }
-        return combined_local_transform;
-    }
+    friend class scene::detail::WorldTransformPass;
 
 public:
-    ~ObservedTransformComponent() {
-        // Clean up all subscriptions when this component is destroyed.
-        if (getTransform()) {
-            getTransform()->removeObserver(this);
-        }
-        unregisterTransformObservers();
-    }
-
     static ObservedTransformComponentPtr Make(transform::TransformPtr t) {
         return ObservedTransformComponentPtr(new ObservedTransformComponent(t));
     }
@@ -144,106 +73,178 @@ public:
     // Add static typename for better error messages
     static const char* getTypeNameStatic() { return "ObservedTransformComponent"; }
 
-    // --- Layer 1: The First Notification ---
     /**
-     * @brief Called when any observed transform changes (own, sibling, or ancestor).
-     * Since we observe all relevant transforms, we only need to mark ourselves as dirty.
-     * Descendants will be notified directly by their own ancestor observers.
+     * @brief Called when the observed transform changes. Flags the owning node;
+     * the new world transform is published by the next update pass.
      */
     void onNotify(const ISubject* subject) override {
-        m_is_dirty = true;
-    }
-
-    // --- Layer 2: The Traversal Update and Second Notification ---
-    /**
-     * @brief During the scene traversal, this updates the cache and notifies final listeners.
-     * Also registers as observer to relevant transforms on first apply.
-     */
-    void apply() override {
-        // Register transform observers on first apply (when component is attached to scene graph)
-        if (!m_observers_registered && m_owner) {
-            registerTransformObservers();
-            m_observers_registered = true;
-        }
-
-        // First, perform the normal transform stack operation.
-        TransformComponent::apply();
-
-        // Now, check if we need to update our cache.
-        if (m_is_dirty) {
-            // The top of the stack IS our current world transform. Cache it.
-            m_world_transform_cache = transform::stack()->top();
-            m_is_dirty = false;
-
-            // ** CRITICAL **: Notify the final listeners (camera, physics, etc.)
-            // that the new, updated data is available in our cache.
-            notify();
+        TransformComponent::onNotify(subject);
+        if (subject == getTransform().get()) {
+            m_is_dirty = true;
         }
     }
 
     // --- Public Access for Final Listeners ---
+
+    /**
+     * @brief Returns the world transform as of the last update pass, without updating it.
+     */
     const glm::mat4& getCachedWorldTransform() const {
         return m_world_transform_cache;
     }
 
     /**
-     * @brief [ON-DEMAND UPDATE] Calculates and returns the world transform immediately.
-     * This version uses an iterative approach, walking up the scene graph hierarchy
-     * from this component's owner to the root, accumulating transformations at each level.
+     * @brief [ON-DEMAND UPDATE] Returns the up-to-date world transform.
+     * Delivers pending transform notifications; then, if anything in this component's
+     * tree is dirty, runs scene::updateWorldTransforms() from the tree's root first.
+     * Otherwise this only walks up to the root.
      * @return A const reference to the up-to-date world transform matrix.
      */
     const glm::mat4& getWorldTransform() {
-        if (!m_is_dirty) {
-            return m_world_transform_cache;
-        }
-
+        observer::flush();
         if (!m_owner) {
-             // Fallback for a component with no owner: world transform is its local transform.
-            m_world_transform_cache = getTransform()->getMatrix();
-            m_is_dirty = false;
-            notify();
+            // Fallback for a component with no owner: world transform is its local transform.
+            if (m_is_dirty) {
+                m_world_transform_cache = getTransform()->getMatrix();
+                m_is_dirty = false;
+                notify();
+            }
             return m_world_transform_cache;
         }
 
-        // Start with the combined local transform of the node this component is attached to.
-        glm::mat4 final_world_transform = calculateCombinedLocalTransform(m_owner);
-
-        // --- NEW LOGIC: Iteratively walk up the parent hierarchy ---
-        scene::SceneNodePtr current_parent = m_owner->getParent();
-        while (current_parent) {
-            // Get the parent's combined local transform.
-            glm::mat4 parent_local_transform = calculateCombinedLocalTransform(current_parent);
-            
-            // Pre-multiply our result with the parent's transform.
-            final_world_transform = parent_local_transform * final_world_transform;
-            
-            // Move up to the next parent.
-            current_parent = current_parent->getParent();
+        scene::SceneNode* root = m_owner.get();
+        while (scene::SceneNode* parent = scene::SceneNode::Resolve(root->getParentHandle())) {
+            root = parent;
+        }
+        if (root->payload().isSubtreeDirty()) {
+            scene::updateWorldTransforms(*root);
         }
-
-        // Cache the final result.
-        m_world_transform_cache = final_world_transform;
-
-        m_is_dirty = false;
-        notify();
         return m_world_transform_cache;
     }
 
+    ENGENE_COMPONENT_TYPE(ObservedTransformComponent, TransformComponent)
     const char* getTypeName() const override {
         return "ObservedTransformComponent";
     }
 
     /**
-     * @brief Manually refresh transform observers.
-     * Call this if the scene graph hierarchy changes or components are added/removed
-     * after this component is added.
+     * @brief Flags the owning node so the next update pass recomputes this component.
+     * Hierarchy and component changes are tracked automatically; this is only kept
+     * for code written against the observer-registration version.
      */
     void refreshTransformObservers() {
-        unregisterTransformObservers();
-        registerTransformObservers();
+        if (m_owner) {
+            scene::markTransformDirty(*m_owner);
+        }
     }
 };
 
 } // namespace component
 
+namespace scene {
+
+namespace detail {
+
+/**
+ * @brief State of scene::updateWorldTransforms(), shared by nested passes.
+ */
+class WorldTransformPass {
+private:
+    std::vector<component::ObservedTransformComponent*> m_changed;  // Reused across passes
+    std::vector<std::vector<component::ObservedTransformComponent*>> m_changed_by_thread;
+    bool m_notifying = false;
+
+    void propagate(SceneNode& node, const glm::mat4& parent_world, bool parent_changed) {
+        ComponentCollection& payload = node.payload();
+        if (!parent_changed && !payload.isSubtreeDirty()) {
+            return;
+        }
+
+        const bool world_changed = parent_changed || payload.isTransformDirty();
+        if (world_changed) {
+            auto& changed = m_changed_by_thread[jobs::JobSystem::getThreadIndex()];
+            glm::mat4 world = parent_world;
+            payload.forEach<component::TransformComponent>([&](component::TransformComponent& transform_comp) {
+                simd::multiply(world, transform_comp.getMatrix(), world);
+                if (transform_comp.getTypeMask().test(component::ObservedTransformComponent::StaticTypeId())) {
+                    auto& observed = static_cast<component::ObservedTransformComponent&>(transform_comp);
+                    observed.m_world_transform_cache = world;
+                    observed.m_is_dirty = false;
+                    changed.push_back(&observed);
+                }
+            });
+            payload.setWorldTransform(world);
+        }
+        payload.clearTransformDirty();
+
+        // Sibling subtrees are independent, so a wide node splits them into jobs
+        const glm::mat4& world = payload.getWorldTransform();
+        const size_t child_count = static_cast<size_t>(node.getChildCount());
+        jobs::system().parallelFor(child_count, ENGENE_TRANSFORM_JOB_CHILDREN, [&](size_t first, size_t last) {
+            node.forEachChild(first, last, [&](SceneNode& child) {
+                propagate(child, world, world_changed);
+            });
+        });
+    }
+
+public:
+    void run(SceneNode& root) {
+        m_changed_by_thread.resize(jobs::system().getThreadCount());
+
+        SceneNode* parent = SceneNode::Resolve(root.getParentHandle());
+        const glm::mat4 parent_world = parent ? parent->payload().getWorldTransform() : glm::mat4(1.0f);
+        propagate(root, parent_world, false);
+
+        for (auto& changed : m_changed_by_thread) {
+            m_changed.insert(m_changed.end(), changed.begin(), changed.end());
+            changed.clear();
+        }
+
+        // An observer may move transforms and query world transforms while being
+        // notified; the nested pass appends to the list and this loop picks it up.
+        // Observers are always notified on the calling thread.
+        if (m_notifying) {
+            return;
+        }
+        m_notifying = true;
+        for (size_t i = 0; i < m_changed.size(); ++i) {
+            m_changed[i]->notify();
+        }
+        m_changed.clear();
+        m_notifying = false;
+    }
+};
+
+inline WorldTransformPass& worldTransformPass() {
+    static WorldTransformPass pass;
+    return pass;
+}
+
+} // namespace detail
+
+/**
+ * @brief Brings every world matrix under `root` up to date, then notifies observers.
+ *
+ * Visits only dirty subtrees: a clean root returns immediately, and a changed
+ * node recomputes itself and its descendants once, top-down, from its parent's
+ * cached matrix. Each ObservedTransformComponent gets the world transform up to
+ * and including itself (transforms of higher priority on the same node are not
+ * part of it). Once the whole pass is done, every ObservedTransformComponent
+ * whose world transform changed notifies its observers exactly once.
+ *
+ * The children of wide nodes are split across jobs::system() (see
+ * ENGENE_TRANSFORM_JOB_CHILDREN); every node is still written by a single job.
+ *
+ * SceneGraph::draw() runs this every frame; getWorldTransform() runs it on demand.
+ *
+ * @param root The root of the tree (a node without a parent).
+ */
+inline void updateWorldTransforms(SceneNode& root) {
+    ENGENE_PROFILE_SCOPE("World Transforms");
+    observer::flush();  // Deliver pending transform changes, which flag the dirty nodes
+    detail::worldTransformPass().run(root);
+}
+
+} // namespace scene
+
 #endif // OBSERVED_TRANSFORM_COMPONENT_H
\ No newline at end of file
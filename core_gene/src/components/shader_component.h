@@ -41,6 +41,7 @@ public:
         shader::stack()->pop();
     }
 
+    ENGENE_COMPONENT_TYPE(ShaderComponent, Component)
     virtual const char* getTypeName() const override  {
         return "ShaderComponent";
     }
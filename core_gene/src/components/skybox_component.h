@@ -176,6 +176,8 @@ public:
         CubemapComponent::unapply();
     }
     
+    ENGENE_COMPONENT_TYPE(SkyboxComponent, CubemapComponent)
+
     /**
      * @brief Get the type name of this component.
      * @return "SkyboxComponent"
@@ -88,6 +88,7 @@ public:
         }
     }
 
+    ENGENE_COMPONENT_TYPE(TextureComponent, Component)
     virtual const char* getTypeName() const override {
         return "TextureComponent";
     }
@@ -6,13 +6,21 @@
 #include <stdexcept>
 #include "component.h"
 #include "../gl_base/transform.h"
+#include "../utils/observer_interface.h"
 
 namespace component {
 
 class TransformComponent;
 using TransformComponentPtr = std::shared_ptr<TransformComponent>;
 
-class TransformComponent : public Component {
+/**
+ * @class TransformComponent
+ * @brief Pushes a transform onto the transform stack while its node is drawn.
+ *
+ * It observes its own `transform::Transform` and marks the owning node's world
+ * matrix dirty when it changes (see scene::updateWorldTransforms()).
+ */
+class TransformComponent : public Component, public IObserver {
 private:
     transform::TransformPtr m_transform;
     
@@ -32,7 +40,11 @@ protected:
     TransformComponent(transform::TransformPtr t, unsigned int priority, unsigned int min_bound, unsigned int max_bound) :
         Component(validatePriority(priority, min_bound, max_bound)), // Use the new validation
         m_transform(t)
-    {}
+    {
+        if (m_transform) {
+            m_transform->addObserver(this);
+        }
+    }
 
     // A default constructor for standard transforms
     TransformComponent(transform::TransformPtr t) :
@@ -45,6 +57,11 @@ protected:
     {}
 
 public:
+    ~TransformComponent() {
+        if (m_transform) {
+            m_transform->removeObserver(this);
+        }
+    }
 
     static TransformComponentPtr Make(transform::TransformPtr t) {
         return TransformComponentPtr(new TransformComponent(t));
@@ -74,6 +91,16 @@ public:
         transform::stack()->pop();
     }
 
+    /**
+     * @brief Called when the observed transform changes; flags the owning node's world matrix.
+     */
+    virtual void onNotify(const ISubject* subject) override {
+        if (m_owner && subject == m_transform.get()) {
+            scene::markTransformDirty(*m_owner);
+        }
+    }
+
+    ENGENE_COMPONENT_TYPE(TransformComponent, Component)
     virtual const char* getTypeName() const override {
         return "TransformComponent";
     }
@@ -83,7 +110,16 @@ public:
     }
 
     void setTransform(transform::TransformPtr t) {
+        if (m_transform) {
+            m_transform->removeObserver(this);
+        }
         m_transform = t;
+        if (m_transform) {
+            m_transform->addObserver(this);
+        }
+        if (m_owner) {
+            scene::markTransformDirty(*m_owner);
+        }
     }
 
     glm::mat4 getMatrix() {
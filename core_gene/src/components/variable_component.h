@@ -46,6 +46,7 @@ public:
         return comp;
     }
 
+    ENGENE_COMPONENT_TYPE(VariableComponent, Component)
     virtual const char* getTypeName() const override {
         return "VariableComponent";
     }
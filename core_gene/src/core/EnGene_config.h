@@ -21,6 +21,14 @@ struct EnGeneConfig {
     int updatesPerSecond = 60;  // Amount of times the simulation function will be called per second. 
     double maxFrameTime = 0.25; // Max time slice to prevent spiral of death on major lag.
     float clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+    int jobWorkers = -1;        // Worker threads of jobs::system(); -1 keeps ENGENE_JOB_WORKERS, 0 runs jobs inline.
+    bool pipelined = false;     // Runs on_fixed_update on a simulation thread, one frame ahead of on_render (see README).
+
+    // --- Headless Settings ---
+    // Renders into an internal width x height framebuffer without a window.
+    // Requires ENGENE_HEADLESS_EGL or ENGENE_HEADLESS_OSMESA (see gl_base/headless_context.h).
+    bool headless = false;
+    int headlessFrames = 1;     // Frames run() executes in headless mode, one simulation step each.
 
     // --- Shader Settings ---
     // Can be a file path OR the raw GLSL source code.
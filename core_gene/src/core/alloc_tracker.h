@@ -0,0 +1,338 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+    #include <malloc.h>  // _aligned_malloc
+#endif
+#include "../exceptions/base_exception.h"
+
+/**
+ * @file alloc_tracker.h
+ * @brief Debug heap allocation counters, per frame and per subsystem
+ *
+ * With ENGENE_ALLOC_TRACKING, the translation unit that defines
+ * ENGENE_ALLOC_TRACKING_IMPLEMENTATION replaces the global operator new/delete. Every allocation is then counted
+ * and charged to the innermost ENGENE_ALLOC_SCOPE on its thread. EnGene
+ * wraps its run phases in scopes, and the scene graph wraps every component
+ * apply/unapply in a scope named after the component type.
+ *
+ * A steady-state frame is expected to allocate nothing;
+ * tracker().setFailOnAllocation() turns any allocation into an exception at
+ * the end of the frame, with the per-subsystem breakdown in the message.
+ */
+
+/**
+ * @brief Compile-time switch for allocation tracking (default 0).
+ *
+ * Define as 1 before including EnGene headers, in every translation unit.
+ * The operator new/delete replacements are emitted only where
+ * ENGENE_ALLOC_TRACKING_IMPLEMENTATION is also defined, which must be exactly
+ * one translation unit, like stb's *_IMPLEMENTATION macros. Do not enable this
+ * if the program already replaces the global allocation functions.
+ */
+#ifndef ENGENE_ALLOC_TRACKING
+    #define ENGENE_ALLOC_TRACKING 0
+#endif
+
+namespace allocation {
+
+/**
+ * @struct Count
+ * @brief Heap allocations and requested bytes
+ */
+struct Count {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @struct SubsystemCount
+ * @brief Allocations charged to one scope name during a frame
+ */
+struct SubsystemCount {
+    const char* name = nullptr;
+    Count count;
+};
+
+class Tracker;
+Tracker& tracker();
+
+/**
+ * @class Tracker
+ * @brief Counts heap allocations; filled by the replaced operator new
+ *
+ * Usage:
+ * @code
+ * #define ENGENE_ALLOC_TRACKING 1
+ * #define ENGENE_ALLOC_TRACKING_IMPLEMENTATION  // In one .cpp only
+ * #include <EnGene.h>
+ *
+ * // In on_initialize: any allocation after the first 60 frames throws
+ * allocation::tracker().setFailOnAllocation(true, 60);
+ * @endcode
+ *
+ * @note record() never allocates and is safe to call from any thread.
+ * Scopes should be opened on the render thread; allocations on other threads
+ * without a scope are charged to "Untagged".
+ */
+class Tracker {
+public:
+    static constexpr size_t MAX_SUBSYSTEMS = 64;  ///< Distinct scope names (later ones share the last slot)
+    static constexpr int MAX_SCOPE_DEPTH = 32;    ///< Deeper scopes are charged to their ancestor
+
+private:
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    Slot m_slots[MAX_SUBSYSTEMS];
+    std::atomic<size_t> m_slot_count{1};  // Slot 0 is "Untagged"
+    Count m_frame_start[MAX_SUBSYSTEMS];  // Slot totals when the current frame began
+    Count m_last_frame[MAX_SUBSYSTEMS];   // Per-slot counts of the last finished frame
+    Count m_last_frame_total;
+    uint64_t m_frames = 0;
+
+    bool m_fail_on_allocation = false;
+    uint64_t m_fail_after_frames = 0;
+
+    struct ScopeStack {
+        size_t slots[MAX_SCOPE_DEPTH] = {};
+        int depth = 0;
+    };
+
+    static ScopeStack& scopeStack() {
+        thread_local ScopeStack stack;
+        return stack;
+    }
+
+    Tracker() {
+        m_slots[0].name.store("Untagged", std::memory_order_relaxed);
+    }
+
+    friend Tracker& tracker();
+
+    size_t slotFor(const char* name) {
+        size_t count = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const char* slot_name = m_slots[i].name.load(std::memory_order_relaxed);
+            if (slot_name == name || std::strcmp(slot_name, name) == 0) {
+                return i;
+            }
+        }
+        if (count == MAX_SUBSYSTEMS) {
+            return MAX_SUBSYSTEMS - 1;
+        }
+        m_slots[count].name.store(name, std::memory_order_relaxed);
+        m_slot_count.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+public:
+    Tracker(const Tracker&) = delete;
+    Tracker& operator=(const Tracker&) = delete;
+
+    /** @brief Whether this build counts allocations (ENGENE_ALLOC_TRACKING) */
+    static constexpr bool isCompiledIn() { return ENGENE_ALLOC_TRACKING != 0; }
+
+    /** @brief Charges one allocation to the innermost scope of the calling thread */
+    void record(size_t bytes) {
+        const ScopeStack& stack = scopeStack();
+        size_t slot = stack.depth > 0 ? stack.slots[std::min(stack.depth, MAX_SCOPE_DEPTH) - 1] : 0;
+        m_slots[slot].allocations.fetch_add(1, std::memory_order_relaxed);
+        m_slots[slot].bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /** @brief Opens a scope; `name` must outlive the tracker (string literal or interned) */
+    void push(const char* name) {
+        ScopeStack& stack = scopeStack();
+        if (stack.depth < MAX_SCOPE_DEPTH) {
+            stack.slots[stack.depth] = slotFor(name);
+        }
+        ++stack.depth;
+    }
+
+    /** @brief Closes the innermost scope */
+    void pop() {
+        ScopeStack& stack = scopeStack();
+        if (stack.depth > 0) --stack.depth;
+    }
+
+    /** @brief Allocations since startup, all threads */
+    Count total() const {
+        Count sum;
+        size_t count = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            sum.allocations += m_slots[i].allocations.load(std::memory_order_relaxed);
+            sum.bytes += m_slots[i].bytes.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Throws from nextFrame() when a frame allocates.
+     * @param fail Enables or disables the check
+     * @param after_frames Frames to let pass first (warmup, caches and pools filling up)
+     */
+    void setFailOnAllocation(bool fail, uint64_t after_frames = 0) {
+        m_fail_on_allocation = fail;
+        m_fail_after_frames = m_frames + after_frames;
+    }
+
+    /**
+     * @brief Closes the frame: stores its per-subsystem counts.
+     * @throws exception::EnGeneException if setFailOnAllocation() is active and the frame allocated
+     * @note Called by EnGene after every frame.
+     */
+    void nextFrame() {
+        m_last_frame_total = Count();
+        size_t count = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            Count now{m_slots[i].allocations.load(std::memory_order_relaxed),
+                      m_slots[i].bytes.load(std::memory_order_relaxed)};
+            m_last_frame[i] = Count{now.allocations - m_frame_start[i].allocations,
+                                    now.bytes - m_frame_start[i].bytes};
+            m_frame_start[i] = now;
+            m_last_frame_total.allocations += m_last_frame[i].allocations;
+            m_last_frame_total.bytes += m_last_frame[i].bytes;
+        }
+        ++m_frames;
+
+        if (m_fail_on_allocation && m_frames > m_fail_after_frames && m_last_frame_total.allocations > 0) {
+            throw exception::EnGeneException(report());
+        }
+    }
+
+    /** @brief Allocations of the last finished frame */
+    const Count& getLastFrame() const { return m_last_frame_total; }
+
+    /** @brief Subsystems that allocated during the last finished frame */
+    std::vector<SubsystemCount> getLastFrameBreakdown() const {
+        std::vector<SubsystemCount> breakdown;
+        size_t count = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            if (m_last_frame[i].allocations > 0) {
+                breakdown.push_back(SubsystemCount{m_slots[i].name.load(std::memory_order_relaxed), m_last_frame[i]});
+            }
+        }
+        return breakdown;
+    }
+
+    /** @brief Human-readable summary of the last finished frame */
+    std::string report() const {
+        std::ostringstream out;
+        out << "Frame " << m_frames << " allocated " << m_last_frame_total.allocations
+            << " times (" << m_last_frame_total.bytes << " bytes)";
+        for (const SubsystemCount& entry : getLastFrameBreakdown()) {
+            out << "\n  " << entry.name << ": " << entry.count.allocations
+                << " (" << entry.count.bytes << " bytes)";
+        }
+        return out.str();
+    }
+};
+
+/**
+ * @brief Gets the global allocation tracker.
+ * @note Never destroyed; operator delete may run during static destruction.
+ */
+inline Tracker& tracker() {
+    // Constructed in place: creating it must not go through operator new
+    alignas(Tracker) static unsigned char storage[sizeof(Tracker)];
+    static Tracker* instance = new (storage) Tracker();
+    return *instance;
+}
+
+/**
+ * @class Scope
+ * @brief RAII allocation scope; use through ENGENE_ALLOC_SCOPE
+ */
+class Scope {
+public:
+    explicit Scope(const char* name) { tracker().push(name); }
+    ~Scope() { tracker().pop(); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+} // namespace allocation
+
+#define ENGENE_ALLOC_CONCAT_INNER(a, b) a##b
+#define ENGENE_ALLOC_CONCAT(a, b) ENGENE_ALLOC_CONCAT_INNER(a, b)
+
+#if ENGENE_ALLOC_TRACKING
+    /// Charges allocations until the end of the enclosing block to `name`
+    #define ENGENE_ALLOC_SCOPE(name) \
+        allocation::Scope ENGENE_ALLOC_CONCAT(engene_alloc_scope_, __LINE__)(name)
+#else
+    #define ENGENE_ALLOC_SCOPE(name) do { } while (0)
+#endif
+
+// --- Global allocation function replacements (one translation unit) ---
+#if ENGENE_ALLOC_TRACKING && defined(ENGENE_ALLOC_TRACKING_IMPLEMENTATION)
+
+namespace allocation {
+namespace detail {
+
+inline void* trackedAlloc(std::size_t size) {
+    tracker().record(size);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+inline void* trackedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    tracker().record(size);
+    std::size_t alignment = static_cast<std::size_t>(align);
+#if defined(_WIN32)
+    if (void* ptr = _aligned_malloc(size ? size : 1, alignment)) {
+        return ptr;
+    }
+#else
+    std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+    if (void* ptr = std::aligned_alloc(alignment, rounded ? rounded : alignment)) {
+        return ptr;
+    }
+#endif
+    throw std::bad_alloc();
+}
+
+inline void alignedFree(void* ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+} // namespace detail
+} // namespace allocation
+
+void* operator new(std::size_t size) { return allocation::detail::trackedAlloc(size); }
+void* operator new[](std::size_t size) { return allocation::detail::trackedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return allocation::detail::trackedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocation::detail::trackedAlignedAlloc(size, align); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { allocation::detail::alignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { allocation::detail::alignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { allocation::detail::alignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { allocation::detail::alignedFree(ptr); }
+
+#endif // ENGENE_ALLOC_TRACKING_IMPLEMENTATION
+
+#endif // ALLOC_TRACKER_H
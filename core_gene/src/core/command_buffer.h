@@ -0,0 +1,208 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "frame_arena.h"
+#include "profiler.h"
+#include "../gl_base/geometry.h"
+#include "../gl_base/material.h"
+#include "../gl_base/shader.h"
+#include "../gl_base/transform.h"
+#include "../utils/simd_math.h"
+#include "../components/light_component.h"  // Brings in the light manager in the order it needs
+
+/**
+ * @file command_buffer.h
+ * @brief Draw work recorded as compact packets on any thread and replayed on the GL thread
+ *
+ * Deciding what to draw (walking entities, sorting, grouping by material and
+ * mesh) does not need the GL context; issuing it does. A CommandBuffer splits
+ * the two: recording only appends 8-byte packets and copies matrices, so it
+ * can run on another thread, and execute() replays the packets on the thread
+ * that owns the context in one tight loop.
+ *
+ * ecs::RenderSnapshot records into one on EnGene's simulation thread, so in
+ * pipelined mode the next frame is recorded while the current one is submitted.
+ * Only ECS draws are recorded: scene graph components issue GL inline through
+ * the global stacks while the graph is traversed, on the context's thread.
+ *
+ * See README.md for usage examples.
+ */
+
+namespace command {
+
+/**
+ * @enum Op
+ * @brief What a packet does when replayed
+ */
+enum class Op : uint8_t {
+    PushMaterial,  ///< material::stack()->push(materials[index])
+    PopMaterial,   ///< material::stack()->pop()
+    BindGeometry,  ///< Makes geometries[index] the mesh of the following draws
+    Draw           ///< Draws the bound mesh with model matrix matrices[index]
+};
+
+/**
+ * @struct Command
+ * @brief One packet; `index` points into the buffer's material, geometry or matrix table
+ */
+struct Command {
+    Op op;
+    uint32_t index;
+};
+static_assert(std::is_trivially_copyable<Command>::value && sizeof(Command) == 8,
+              "command packets must stay compact PODs");
+
+/**
+ * @class CommandBuffer
+ * @brief Packets plus the matrices and resources they refer to
+ *
+ * The buffer holds a reference to every material and mesh it records until
+ * clear(), so entities may be destroyed while a recorded frame is in flight.
+ * Their own parameters must not change until it is replayed. Storage is
+ * reused, so recording a frame no larger than the biggest one so far does
+ * not allocate.
+ *
+ * Usage:
+ * @code
+ * // Any thread
+ * commands.clear();
+ * commands.pushMaterial(skin);
+ * commands.bindGeometry(mesh);
+ * for (const glm::mat4& model : models) commands.draw(model);
+ * commands.popMaterial();
+ *
+ * // GL thread, with the shader bound
+ * commands.execute();
+ * @endcode
+ */
+class CommandBuffer {
+private:
+    std::vector<Command> m_commands;
+    std::vector<glm::mat4> m_matrices;
+    std::vector<geometry::GeometryPtr> m_geometries;
+    std::vector<material::MaterialPtr> m_materials;
+
+public:
+    // --- Recording (any thread) ---
+
+    void pushMaterial(const material::MaterialPtr& material) {
+        m_commands.push_back(Command{Op::PushMaterial, static_cast<uint32_t>(m_materials.size())});
+        m_materials.push_back(material);
+    }
+
+    void popMaterial() {
+        m_commands.push_back(Command{Op::PopMaterial, 0});
+    }
+
+    void bindGeometry(const geometry::GeometryPtr& geometry) {
+        m_commands.push_back(Command{Op::BindGeometry, static_cast<uint32_t>(m_geometries.size())});
+        m_geometries.push_back(geometry);
+    }
+
+    /**
+     * @brief Draws the last bound mesh with `model` on top of the transform stack.
+     * Ignored, with a warning, if no mesh has been bound since clear().
+     */
+    void draw(const glm::mat4& model) {
+        if (m_geometries.empty()) {
+            std::cerr << "Warning: CommandBuffer::draw called before bindGeometry. Ignoring." << std::endl;
+            return;
+        }
+        m_commands.push_back(Command{Op::Draw, static_cast<uint32_t>(m_matrices.size())});
+        m_matrices.push_back(model);
+    }
+
+    /**
+     * @brief Reserves room for `draws` draws, so recording them does not reallocate.
+     */
+    void reserve(size_t draws) {
+        m_commands.reserve(draws);
+        m_matrices.reserve(draws);
+    }
+
+    /**
+     * @brief Drops every packet and every resource reference.
+     * Call it on the GL thread if the buffer may hold the last reference to a mesh.
+     */
+    void clear() {
+        m_commands.clear();
+        m_matrices.clear();
+        m_geometries.clear();
+        m_materials.clear();
+    }
+
+    // --- Replay (GL thread) ---
+
+    /**
+     * @brief Issues the recorded packets with the current shader, like ecs::drawEntities().
+     * Per-object light selection is honored like in GeometryComponent, with
+     * every draw's lights selected first and uploaded together.
+     */
+    void execute() const {
+        auto& lights = light::manager();
+        const bool select_lights = lights.isObjectLightSelectionEnabled();
+        geometry::Geometry* bound = nullptr;
+
+        // Indexed like m_matrices, since each Draw packet owns one matrix
+        uint32_t* light_slots = nullptr;
+        if (select_lights) {
+            light_slots = arena::frame().allocate<uint32_t>(m_matrices.size());
+            lights.beginSelectionBatch(m_matrices.size());
+            const glm::mat4& base = transform::stack()->top();
+            for (const Command& command : m_commands) {
+                if (command.op == Op::BindGeometry) {
+                    bound = m_geometries[command.index].get();
+                } else if (command.op == Op::Draw && bound) {
+                    light_slots[command.index] = lights.stageLightsFor(
+                        simd::multiply(base, m_matrices[command.index]),
+                        bound->getBoundsCenter(), bound->getBoundsRadius());
+                }
+            }
+            lights.uploadSelectionBatch();
+            bound = nullptr;
+        }
+
+        for (const Command& command : m_commands) {
+            switch (command.op) {
+                case Op::PushMaterial:
+                    material::stack()->push(m_materials[command.index]);
+                    break;
+                case Op::PopMaterial:
+                    material::stack()->pop();
+                    break;
+                case Op::BindGeometry:
+                    bound = m_geometries[command.index].get();
+                    break;
+                case Op::Draw:
+                    if (!bound) {
+                        break;  // A null mesh was bound
+                    }
+                    transform::stack()->push(m_matrices[command.index]);
+                    if (select_lights) {
+                        lights.bindSelection(light_slots[command.index]);
+                    }
+                    shader::stack()->top();  // Applies per-draw uniforms (u_model, material, ...)
+                    bound->Draw();
+                    transform::stack()->pop();
+                    break;
+            }
+        }
+    }
+
+    size_t size() const { return m_commands.size(); }
+    bool empty() const { return m_commands.empty(); }
+
+    /** @brief Number of recorded Draw packets */
+    size_t drawCount() const { return m_matrices.size(); }
+};
+
+} // namespace command
+
+#endif // COMMAND_BUFFER_H
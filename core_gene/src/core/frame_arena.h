@@ -0,0 +1,238 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file frame_arena.h
+ * @brief Double-buffered linear allocator for data that lives one or two frames
+ *
+ * Transient render data (culling results, sorted draw lists, light lists,
+ * upload staging) is bump-allocated from the arena instead of the heap.
+ * EnGene calls beginFrame() at the top of every frame, which switches to the
+ * other buffer and resets it. Memory allocated during frame N therefore stays
+ * valid while frame N+1 is built, and is reused at the start of frame N+2.
+ *
+ * See README.md for usage examples.
+ */
+
+/**
+ * @brief Initial size of each of the two arena buffers, in bytes (default 1 MiB).
+ *
+ * A frame that needs more gets its extra allocations from the heap; the
+ * buffer grows to the frame's high-water mark the next time it is reset.
+ */
+#ifndef ENGENE_FRAME_ARENA_SIZE
+    #define ENGENE_FRAME_ARENA_SIZE (1u << 20)
+#endif
+
+namespace arena {
+
+/**
+ * @struct ArenaStats
+ * @brief Usage counters for tuning ENGENE_FRAME_ARENA_SIZE
+ */
+struct ArenaStats {
+    size_t capacity = 0;                ///< Size of the buffer the current frame allocates from
+    size_t used = 0;                    ///< Bytes allocated so far in the current frame (incl. overflow)
+    size_t last_frame_used = 0;         ///< Bytes allocated by the previous frame
+    size_t high_water_mark = 0;         ///< Most bytes any frame allocated
+    uint64_t overflow_allocations = 0;  ///< Allocations that did not fit and went to the heap, since startup
+    uint64_t growths = 0;               ///< Times a buffer was enlarged, since startup
+};
+
+class FrameArena;
+FrameArena& frame();
+
+/**
+ * @class FrameArena
+ * @brief Bump allocator with two buffers that alternate every frame
+ *
+ * Usage:
+ * @code
+ * // Scratch array for this frame only; no free, no destructor
+ * int* counts = arena::frame().allocate<int>(tile_count);
+ *
+ * // STL containers
+ * arena::FrameVector<DrawItem> draws;
+ * draws.reserve(visible_count);
+ * @endcode
+ *
+ * @note Not thread-safe; allocate from the render thread.
+ * @note Nothing is destroyed on reset, so only trivially destructible objects
+ * may be created with make(). Containers using Allocator must be destroyed
+ * (or stop being used) before the frame after next.
+ */
+class FrameArena {
+private:
+    struct Buffer {
+        std::unique_ptr<unsigned char[]> data;
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t overflow_bytes = 0;  // Requested this frame but served by the heap
+        std::vector<std::unique_ptr<unsigned char[]>> overflow;
+    };
+
+    Buffer m_buffers[2];
+    int m_current = 0;
+    uint64_t m_frame = 0;
+    ArenaStats m_stats;
+
+    FrameArena() {
+        for (Buffer& buffer : m_buffers) {
+            buffer.capacity = ENGENE_FRAME_ARENA_SIZE;
+            buffer.data.reset(new unsigned char[buffer.capacity]);
+        }
+        m_stats.capacity = ENGENE_FRAME_ARENA_SIZE;
+    }
+
+    friend FrameArena& frame();
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * @brief Empties a buffer, enlarging it first if its last frame overflowed.
+     */
+    void reset(Buffer& buffer) {
+        if (buffer.overflow_bytes > 0) {
+            size_t needed = buffer.used + buffer.overflow_bytes;
+            size_t capacity = buffer.capacity;
+            while (capacity < needed) {
+                capacity *= 2;
+            }
+            buffer.data.reset(new unsigned char[capacity]);
+            buffer.capacity = capacity;
+            buffer.overflow.clear();
+            buffer.overflow_bytes = 0;
+            ++m_stats.growths;
+        }
+        buffer.used = 0;
+    }
+
+public:
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Switches to the other buffer and resets it.
+     * Everything allocated two frames ago becomes invalid; the previous frame's data stays.
+     * @note Called by EnGene at the top of every frame.
+     */
+    void beginFrame() {
+        const Buffer& finished = m_buffers[m_current];
+        m_stats.last_frame_used = finished.used + finished.overflow_bytes;
+
+        m_current ^= 1;
+        reset(m_buffers[m_current]);
+        ++m_frame;
+
+        m_stats.capacity = m_buffers[m_current].capacity;
+        m_stats.used = 0;
+    }
+
+    /**
+     * @brief Allocates raw memory valid until the frame after next begins.
+     * @param bytes Size of the block
+     * @param alignment Power-of-two alignment
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        Buffer& buffer = m_buffers[m_current];
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer.data.get());
+        size_t offset = alignUp(base + buffer.used, alignment) - base;
+
+        if (offset + bytes <= buffer.capacity) {
+            buffer.used = offset + bytes;
+            m_stats.used = buffer.used + buffer.overflow_bytes;
+            m_stats.high_water_mark = std::max(m_stats.high_water_mark, m_stats.used);
+            return buffer.data.get() + offset;
+        }
+
+        // Does not fit: serve from the heap for this frame, grow on the next reset
+        buffer.overflow.emplace_back(new unsigned char[bytes + alignment]);
+        uintptr_t chunk = reinterpret_cast<uintptr_t>(buffer.overflow.back().get());
+        buffer.overflow_bytes += bytes + alignment;
+        ++m_stats.overflow_allocations;
+        m_stats.used = buffer.used + buffer.overflow_bytes;
+        m_stats.high_water_mark = std::max(m_stats.high_water_mark, m_stats.used);
+        return reinterpret_cast<void*>(alignUp(chunk, alignment));
+    }
+
+    /**
+     * @brief Allocates uninitialized storage for `count` objects of type T.
+     */
+    template <typename T>
+    T* allocate(size_t count = 1) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Constructs one object in the arena. It is never destroyed.
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "FrameArena::make requires a trivially destructible type; the arena never runs destructors.");
+        return new (allocate<T>()) T(std::forward<Args>(args)...);
+    }
+
+    /** @brief Frames begun since startup */
+    uint64_t getFrame() const { return m_frame; }
+
+    /** @brief Usage counters (see ArenaStats) */
+    const ArenaStats& getStats() const { return m_stats; }
+};
+
+/**
+ * @brief Gets the global frame arena.
+ */
+inline FrameArena& frame() {
+    static FrameArena instance;
+    return instance;
+}
+
+/**
+ * @class Allocator
+ * @brief STL allocator adapter drawing from the global frame arena.
+ *
+ * deallocate() is a no-op; memory is reclaimed when the arena buffer is reset.
+ * A vector that keeps growing leaves its old storage in the arena until then,
+ * so reserve() up front where the size is known.
+ */
+template <typename T>
+class Allocator {
+public:
+    using value_type = T;
+
+    Allocator() noexcept = default;
+    template <typename U>
+    Allocator(const Allocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        return frame().allocate<T>(count);
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const Allocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const Allocator<U>&) const noexcept { return false; }
+};
+
+/// @brief std::vector whose storage lives in the frame arena
+template <typename T>
+using FrameVector = std::vector<T, Allocator<T>>;
+
+} // namespace arena
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,435 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file job_system.h
+ * @brief Work-stealing thread pool for splitting per-frame passes across cores
+ *
+ * Every worker thread owns a queue. A thread pushes the jobs it spawns onto its
+ * own queue and pops them back newest-first, which keeps a subtree's work on
+ * the core whose cache already holds it; idle workers steal the oldest jobs
+ * from the other queues, which are the biggest pieces of a recursive split.
+ * A thread waiting for its jobs runs queued jobs instead of blocking, so jobs
+ * can spawn and wait for jobs of their own.
+ *
+ * Submitting and running jobs does not allocate: jobs are plain structs in
+ * fixed-size ring buffers, and parallelFor() passes its callable by pointer.
+ *
+ * See README.md for usage examples.
+ */
+
+/**
+ * @brief Number of worker threads started by jobs::system() (default -1).
+ *
+ * -1 uses one worker per hardware thread, minus the calling thread, which also
+ * runs jobs while it waits. 0 runs every job inline on the submitting thread.
+ */
+#ifndef ENGENE_JOB_WORKERS
+    #define ENGENE_JOB_WORKERS -1
+#endif
+
+/**
+ * @brief Jobs each thread's queue holds (default 4096, a power of two).
+ *
+ * A job submitted to a full queue runs immediately on the submitting thread.
+ */
+#ifndef ENGENE_JOB_QUEUE_CAPACITY
+    #define ENGENE_JOB_QUEUE_CAPACITY 4096
+#endif
+
+/**
+ * @brief Threads besides the workers that can get a queue of their own (default 2, at most 32).
+ *
+ * See JobSystem::attachThread(). EnGene's pipelined mode attaches its simulation thread.
+ */
+#ifndef ENGENE_JOB_ATTACHED_THREADS
+    #define ENGENE_JOB_ATTACHED_THREADS 2
+#endif
+
+namespace jobs {
+
+class JobSystem;
+JobSystem& system();
+
+/**
+ * @class Counter
+ * @brief Number of unfinished jobs in a group; pass it to JobSystem::wait()
+ *
+ * The first exception thrown by one of its jobs is kept, and wait() rethrows
+ * it on the waiting thread once every job of the group has finished.
+ */
+class Counter {
+private:
+    std::atomic<uint32_t> m_pending{0};
+    std::atomic<bool> m_failed{false};
+    std::exception_ptr m_error;  // Written by the first failing job only, read once m_pending is 0
+    friend class JobSystem;
+
+public:
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * @struct Job
+ * @brief A function over the index range [begin, end)
+ */
+struct Job {
+    void (*function)(void* data, size_t begin, size_t end) = nullptr;
+    void* data = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    Counter* counter = nullptr;
+};
+
+/**
+ * @class JobSystem
+ * @brief Worker threads with one work-stealing queue each
+ *
+ * Usage:
+ * @code
+ * // Split 100000 items into jobs of 1024
+ * jobs::system().parallelFor(items.size(), 1024, [&](size_t begin, size_t end) {
+ *     for (size_t i = begin; i < end; ++i) update(items[i]);
+ * });
+ *
+ * // Or submit jobs by hand and wait for them
+ * jobs::Counter counter;
+ * jobs::system().submit(jobs::Job{&updateRange, &items, 0, items.size(), &counter});
+ * jobs::system().wait(counter);
+ * @endcode
+ */
+class JobSystem {
+private:
+    static_assert((ENGENE_JOB_QUEUE_CAPACITY & (ENGENE_JOB_QUEUE_CAPACITY - 1)) == 0,
+                  "ENGENE_JOB_QUEUE_CAPACITY must be a power of two");
+    static_assert(ENGENE_JOB_ATTACHED_THREADS >= 0 && ENGENE_JOB_ATTACHED_THREADS <= 32,
+                  "ENGENE_JOB_ATTACHED_THREADS must be between 0 and 32");
+
+    /**
+     * @brief Fixed-size deque: the owner pushes and pops at the back, thieves take from the front.
+     */
+    class WorkQueue {
+    private:
+        static constexpr size_t MASK = ENGENE_JOB_QUEUE_CAPACITY - 1;
+
+        std::mutex m_mutex;
+        Job m_jobs[ENGENE_JOB_QUEUE_CAPACITY];
+        size_t m_front = 0;
+        size_t m_back = 0;
+
+    public:
+        bool push(const Job& job) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_back - m_front == ENGENE_JOB_QUEUE_CAPACITY) {
+                return false;
+            }
+            m_jobs[m_back++ & MASK] = job;
+            return true;
+        }
+
+        bool pop(Job& job) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_back == m_front) {
+                return false;
+            }
+            job = m_jobs[--m_back & MASK];
+            return true;
+        }
+
+        bool steal(Job& job) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_back == m_front) {
+                return false;
+            }
+            job = m_jobs[m_front++ & MASK];
+            return true;
+        }
+    };
+
+    // Queue 0 belongs to threads that are not workers (usually the main thread),
+    // then one per worker, then one per attachable thread
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::atomic<uint32_t> m_attached{0};  // Bit i: queue getWorkerCount() + 1 + i is taken
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<bool> m_stopping{false};
+
+    static size_t& threadIndex() {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    JobSystem() {
+        int workers = ENGENE_JOB_WORKERS;
+        if (workers < 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            workers = hardware > 1 ? static_cast<int>(hardware) - 1 : 0;
+        }
+        setWorkerCount(static_cast<size_t>(workers));
+    }
+
+    friend JobSystem& system();
+
+    /**
+     * @brief Runs a job and counts it as finished, even if it throws.
+     * The exception goes to the job's counter; without a counter it propagates.
+     */
+    void execute(const Job& job) {
+        try {
+            job.function(job.data, job.begin, job.end);
+        } catch (...) {
+            if (!job.counter) {
+                throw;
+            }
+            if (!job.counter->m_failed.exchange(true, std::memory_order_relaxed)) {
+                job.counter->m_error = std::current_exception();
+            }
+        }
+        if (job.counter) {
+            job.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    /**
+     * @brief Runs queued jobs until every job of `counter` has finished.
+     */
+    void drain(Counter& counter) {
+        Job job;
+        while (!counter.done()) {
+            if (takeJob(job)) {
+                execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Takes a job from this thread's queue, or steals one from another queue.
+     */
+    bool takeJob(Job& job) {
+        const size_t self = threadIndex() < m_queues.size() ? threadIndex() : 0;
+        bool found = m_queues[self]->pop(job);
+        for (size_t i = 1; !found && i < m_queues.size(); ++i) {
+            found = m_queues[(self + i) % m_queues.size()]->steal(job);
+        }
+        if (found) {
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return found;
+    }
+
+    void workerLoop(size_t index) {
+        threadIndex() = index;
+        Job job;
+        while (true) {
+            if (takeJob(job)) {
+                execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_wake.wait(lock, [this] {
+                return m_stopping.load(std::memory_order_acquire) || m_queued.load(std::memory_order_acquire) > 0;
+            });
+            if (m_stopping.load(std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stopping.store(true, std::memory_order_release);
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+        m_stopping.store(false, std::memory_order_release);
+    }
+
+    template <typename Fn>
+    static void runRange(void* data, size_t begin, size_t end) {
+        (*static_cast<Fn*>(data))(begin, end);
+    }
+
+public:
+    ~JobSystem() {
+        stopWorkers();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Replaces the worker threads. Call it while no jobs are running.
+     * @param worker_count Threads besides the caller; 0 runs every job inline.
+     */
+    void setWorkerCount(size_t worker_count) {
+        stopWorkers();
+        m_queues.clear();
+        for (size_t i = 0; i < worker_count + 1 + ENGENE_JOB_ATTACHED_THREADS; ++i) {
+            m_queues.push_back(std::make_unique<WorkQueue>());
+        }
+        m_queued.store(0, std::memory_order_relaxed);
+        for (size_t i = 1; i <= worker_count; ++i) {
+            m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+        }
+    }
+
+    size_t getWorkerCount() const { return m_workers.size(); }
+
+    /**
+     * @brief Number of distinct thread indices, for sizing per-thread scratch data.
+     */
+    size_t getThreadCount() const { return m_queues.size(); }
+
+    /**
+     * @brief Index of the calling thread: 1..getWorkerCount() on workers, above that
+     * on attached threads, 0 elsewhere. Always below getThreadCount().
+     */
+    static size_t getThreadIndex() { return threadIndex(); }
+
+    /**
+     * @brief Gives the calling thread a queue and thread index of its own.
+     *
+     * Two threads that are not workers otherwise share queue and index 0, so
+     * per-thread scratch data of jobs one of them runs while waiting would be
+     * shared too. Call it from a long-lived thread that submits jobs while the
+     * main thread does; pair it with detachThread() before the thread ends,
+     * and do not change the worker count in between.
+     *
+     * @return False if all ENGENE_JOB_ATTACHED_THREADS slots are taken; the thread then keeps index 0.
+     */
+    bool attachThread() {
+        uint32_t taken = m_attached.load(std::memory_order_relaxed);
+        for (uint32_t slot = 0; slot < ENGENE_JOB_ATTACHED_THREADS; ++slot) {
+            const uint32_t bit = uint32_t(1) << slot;
+            if (taken & bit) {
+                continue;
+            }
+            if (m_attached.compare_exchange_weak(taken, taken | bit, std::memory_order_acq_rel)) {
+                threadIndex() = m_workers.size() + 1 + slot;
+                return true;
+            }
+            slot = uint32_t(-1);  // Another thread took a slot; rescan with the new mask
+        }
+        return false;
+    }
+
+    /**
+     * @brief Releases the calling thread's attachThread() slot; its jobs must be finished.
+     */
+    void detachThread() {
+        const size_t first = m_workers.size() + 1;
+        if (threadIndex() >= first) {
+            m_attached.fetch_and(~(uint32_t(1) << (threadIndex() - first)), std::memory_order_acq_rel);
+        }
+        threadIndex() = 0;
+    }
+
+    /**
+     * @brief Queues a job on the calling thread's queue.
+     * Runs it immediately if there are no workers or the queue is full.
+     */
+    void submit(const Job& job) {
+        if (job.counter) {
+            job.counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        const size_t self = threadIndex() < m_queues.size() ? threadIndex() : 0;
+        if (m_workers.empty()) {
+            execute(job);
+            return;
+        }
+        m_queued.fetch_add(1, std::memory_order_release);
+        if (!m_queues[self]->push(job)) {
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            execute(job);
+            return;
+        }
+        {
+            // Pairs with the predicate check in workerLoop(), so the wake-up is not lost
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        }
+        m_wake.notify_one();
+    }
+
+    /**
+     * @brief Runs queued jobs until every job of `counter` has finished.
+     * @throws The first exception one of those jobs threw. The counter is then
+     *         cleared and can be reused.
+     */
+    void wait(Counter& counter) {
+        drain(counter);
+        if (counter.m_failed.load(std::memory_order_relaxed)) {
+            std::exception_ptr error = std::move(counter.m_error);
+            counter.m_error = nullptr;
+            counter.m_failed.store(false, std::memory_order_relaxed);
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Calls `fn(begin, end)` over [0, count) in jobs of at most `grain` indices, and waits.
+     *
+     * Runs inline when there are no workers or the range fits in one job. The
+     * caller takes part, so it is safe to call from inside a job. If a chunk
+     * throws, the remaining chunks still run and the first exception is
+     * rethrown here.
+     */
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        grain = std::max<size_t>(grain, 1);
+        if (m_workers.empty() || count <= grain) {
+            if (count > 0) {
+                fn(size_t(0), count);
+            }
+            return;
+        }
+
+        using Callable = std::remove_reference_t<Fn>;
+        Counter counter;
+        for (size_t begin = grain; begin < count; begin += grain) {
+            submit(Job{&runRange<Callable>, const_cast<void*>(static_cast<const void*>(std::addressof(fn))),
+                       begin, std::min(begin + grain, count), &counter});
+        }
+        try {
+            fn(size_t(0), grain);  // The first chunk runs here while the workers steal the rest
+        } catch (...) {
+            // The queued jobs point at counter and fn, so they must finish before the stack unwinds
+            drain(counter);
+            throw;
+        }
+        wait(counter);
+    }
+};
+
+/**
+ * @brief Gets the global job system, starting its workers on first use.
+ */
+inline JobSystem& system() {
+    static JobSystem instance;
+    return instance;
+}
+
+} // namespace jobs
+
+#endif // JOB_SYSTEM_H
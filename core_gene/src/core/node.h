@@ -9,9 +9,25 @@
 #include <utility>
 #include <algorithm>
 #include <iostream>
+#include <type_traits>
+#include "../gl_base/frame_stats.h"
+#include "node_pool.h"
 
 namespace node {
 
+namespace detail {
+
+// Payloads can react to re-parenting by defining `void onParentChanged(Node&)`
+template <typename Payload, typename NodeType, typename = void>
+struct HasParentChangedHook : std::false_type {};
+
+template <typename Payload, typename NodeType>
+struct HasParentChangedHook<Payload, NodeType,
+    std::void_t<decltype(std::declval<Payload&>().onParentChanged(std::declval<NodeType&>()))>>
+    : std::true_type {};
+
+} // namespace detail
+
 /**
  * @class Node
  * @brief A generic, templated class for representing a node in a tree structure.
@@ -20,6 +36,11 @@ namespace node {
  * a user-defined 'PayloadType'. It is responsible for traversal logic but delegates
  * the specific actions performed during traversal to the caller via the visit() method.
  *
+ * Nodes are stored in a NodePool slab (see node_pool.h) together with the
+ * control block of their shared_ptr, and are addressable by a generational
+ * NodeHandle. The parent link is such a handle, so it does not keep the
+ * parent alive and costs 4 bytes instead of a weak_ptr.
+ *
  * @tparam PayloadType The type of data or behavior object this node will contain.
  */
 template <typename PayloadType>
@@ -28,30 +49,55 @@ public:
     // Type aliases for cleaner code
     using NodePtr = std::shared_ptr<Node<PayloadType>>;
     using ParentPtr = std::weak_ptr<Node<PayloadType>>;
+    using Pool = NodePool<Node<PayloadType>>;
+
+    /**
+     * @struct VisitActions
+     * @brief Pre- and post-visit behavior, shared by every node that behaves the same way
+     */
+    struct VisitActions {
+        std::function<void(Node<PayloadType>&)> pre;
+        std::function<void(Node<PayloadType>&)> post;
+    };
+    using VisitActionsPtr = std::shared_ptr<const VisitActions>;
 
 private:
+    // Fields read by visit() come first, so a traversal touches fewer cache lines per node
+    bool applicability = true;
     int id;
     inline static int next_id = 0;
-    std::string name;
+    NodeHandle handle;
+    NodeHandle parent;
     std::vector<NodePtr> children;
-    ParentPtr parent;
-    bool applicability = true;
 
-    // The node now stores its own behavior (its "strategy")
-    std::function<void(Node<PayloadType>&)> pre_visit_action_;
-    std::function<void(Node<PayloadType>&)> post_visit_action_;
+    // The node stores its own behavior (its "strategy"); usually one object shared by the whole scene
+    VisitActionsPtr actions_;
     PayloadType payload_;
 
+    std::string name;
+
     // Private constructor to enforce creation via the static Make() function.
     explicit Node(std::string name) : name(std::move(name)) {
         id = next_id++;
     }
 
     // Private setter for parent to be controlled by child management methods.
-    void setParent(ParentPtr new_parent) {
+    void setParent(NodeHandle new_parent) {
         parent = new_parent;
+        if constexpr (detail::HasParentChangedHook<PayloadType, Node<PayloadType>>::value) {
+            payload_.onParentChanged(*this);
+        }
     }
 
+    // Destroys a pooled node and returns its slot (the control block is released separately).
+    struct PoolDeleter {
+        void operator()(Node<PayloadType>* node) const {
+            NodeHandle node_handle = node->handle;
+            node->~Node();
+            Pool::instance().releaseObject(node_handle);
+        }
+    };
+
 public:
 
     /**
@@ -64,7 +110,7 @@ public:
         // std::cout << "Destroying " << name << std::endl; // Helpful for debugging
         for (const auto& child : children) {
             if (child) {
-                // Set the child's parent to an empty weak_ptr.
+                // Clear the child's parent handle.
                 child->setParent({}); 
             }
         }
@@ -74,9 +120,36 @@ public:
      * @brief Factory function to create a new Node.
      * @param name The name of the node.
      * @return A shared pointer to the newly created Node.
+     * @note The node and its control block are placed in a NodePool slot.
      */
     static NodePtr Make(std::string name) {
-        return NodePtr(new Node<PayloadType>(std::move(name)));
+        Pool& pool = Pool::instance();
+        NodeHandle node_handle = pool.acquire();
+        Node<PayloadType>* node;
+        try {
+            node = new (pool.objectStorage(node_handle)) Node<PayloadType>(std::move(name));
+        } catch (...) {
+            pool.releaseObject(node_handle);
+            throw;
+        }
+        node->handle = node_handle;
+        return NodePtr(node, PoolDeleter{}, SlotAllocator<Node<PayloadType>, Node<PayloadType>>(node_handle));
+    }
+
+    /**
+     * @brief Gets the node a handle refers to.
+     * @return The node, or nullptr if it has been destroyed.
+     */
+    static NodePtr FromHandle(NodeHandle node_handle) {
+        Node<PayloadType>* node = Pool::instance().resolve(node_handle);
+        return node ? node->weak_from_this().lock() : nullptr;
+    }
+
+    /**
+     * @brief Non-owning lookup, for hot paths that do not need to extend the node's lifetime.
+     */
+    static Node<PayloadType>* Resolve(NodeHandle node_handle) {
+        return Pool::instance().resolve(node_handle);
     }
 
     // --- Payload Access ---
@@ -93,7 +166,9 @@ public:
     // --- Core Getters ---
     int getId() const { return id; }
     const std::string& getName() const { return name; }
-    NodePtr getParent() const { return parent.lock(); }
+    NodeHandle getHandle() const { return handle; }
+    NodeHandle getParentHandle() const { return parent; }
+    NodePtr getParent() const { return FromHandle(parent); }
     bool getApplicability() const { return applicability; }
     std::vector<NodePtr> getChildren() const { return children; }
 
@@ -126,6 +201,28 @@ public:
         return nullptr;
     }
 
+    /**
+     * @brief Calls `fn(Node&)` for each direct child, without copying the child list.
+     */
+    template <typename Fn>
+    void forEachChild(Fn&& fn) {
+        forEachChild(0, children.size(), std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief Calls `fn(Node&)` for the children with index in [first, last).
+     * Lets a caller split the children of a wide node into ranges.
+     */
+    template <typename Fn>
+    void forEachChild(size_t first, size_t last, Fn&& fn) {
+        last = std::min(last, children.size());
+        for (size_t i = first; i < last; ++i) {
+            if (children[i]) {
+                fn(*children[i]);
+            }
+        }
+    }
+
     int getChildIndex(const NodePtr& child) const {
         for (int i = 0; i < children.size(); i++) {
             if (children[i] == child) {
@@ -138,7 +235,7 @@ public:
     void addChild(const NodePtr& child) {
         if (child) {
             children.push_back(child);
-            child->setParent(this->shared_from_this());
+            child->setParent(handle);
         }
     }
 
@@ -149,13 +246,13 @@ public:
             return;
         }
         children.insert(children.begin() + index, child);
-        child->setParent(this->shared_from_this());
+        child->setParent(handle);
     }
 
     void addChildFront(const NodePtr& child) {
         if (child) {
             children.insert(children.begin(), child);
-            child->setParent(this->shared_from_this());
+            child->setParent(handle);
         }
     }
 
@@ -164,7 +261,7 @@ public:
         auto it = std::find(children.begin(), children.end(), after);
         if (it != children.end()) {
             children.insert(it + 1, child);
-            child->setParent(this->shared_from_this());
+            child->setParent(handle);
         } else {
             std::cerr << "Reference child not found in addChildAfter" << std::endl;
         }
@@ -206,25 +303,40 @@ public:
     /**
      * @brief Sets the action to be performed on this node BEFORE visiting children.
      * @param action The function to execute.
+     * @note Gives the node its own copy of its actions; prefer setVisitActions() for many nodes.
      */
     void onPreVisit(const std::function<void(Node<PayloadType>&)>& action) {
-        pre_visit_action_ = action;
+        auto actions = std::make_shared<VisitActions>(actions_ ? *actions_ : VisitActions{});
+        actions->pre = action;
+        actions_ = std::move(actions);
     }
 
     /**
      * @brief Sets the action to be performed on this node AFTER visiting children.
      * @param action The function to execute.
+     * @note Gives the node its own copy of its actions; prefer setVisitActions() for many nodes.
      */
     void onPostVisit(const std::function<void(Node<PayloadType>&)>& action) {
-        post_visit_action_ = action;
+        auto actions = std::make_shared<VisitActions>(actions_ ? *actions_ : VisitActions{});
+        actions->post = action;
+        actions_ = std::move(actions);
     }
 
+    /**
+     * @brief Shares a set of actions with other nodes, without copying them.
+     * @param actions The actions, or nullptr for none.
+     */
+    void setVisitActions(VisitActionsPtr actions) {
+        actions_ = std::move(actions);
+    }
+
+    const VisitActionsPtr& getVisitActions() const { return actions_; }
+
     /**
      * @brief Detaches all actions from this node.
      */
     void clearActions() {
-        pre_visit_action_ = nullptr;
-        post_visit_action_ = nullptr;
+        actions_ = nullptr;
     }
 
     // --- Generic Traversal Method ---
@@ -238,11 +350,15 @@ public:
      *
      */
     void visit() {
-        if (!applicability) return;
+        if (!applicability) {
+            ++stats::current().nodes_culled;
+            return;
+        }
+        ++stats::current().nodes_visited;
 
         // 1. Execute the stored pre-order action, if it exists
-        if (pre_visit_action_) {
-            pre_visit_action_(*this);
+        if (actions_ && actions_->pre) {
+            actions_->pre(*this);
         }
 
         // 2. Recursively visit children
@@ -253,8 +369,8 @@ public:
         }
 
         // 3. Execute the stored post-order action, if it exists
-        if (post_visit_action_) {
-            post_visit_action_(*this);
+        if (actions_ && actions_->post) {
+            actions_->post(*this);
         }
     }
 
@@ -294,6 +410,38 @@ public:
             post_visit_lambda(this->shared_from_this());
         }
     }
+
+    /**
+     * @brief Allocation-free variant of visit(pre, post) for per-frame traversals.
+     *
+     * The actions are taken as template parameters and receive the node by
+     * reference, so neither a std::function nor a shared_ptr is created per node.
+     *
+     * @param pre_visit Callable as pre_visit(Node&), executed before visiting children.
+     * @param post_visit Callable as post_visit(Node&), executed after visiting children.
+     * @param ignore_applicability If true, traversal proceeds regardless of the node's
+     * 'applicability' flag. Defaults to false.
+     */
+    template <typename PreVisit, typename PostVisit>
+    void traverse(PreVisit&& pre_visit, PostVisit&& post_visit, bool ignore_applicability = false) {
+        if (!ignore_applicability && !applicability) return;
+
+        pre_visit(*this);
+        for (const auto& child : children) {
+            if (child) {
+                child->traverse(pre_visit, post_visit, ignore_applicability);
+            }
+        }
+        post_visit(*this);
+    }
+
+    /**
+     * @brief Pre-order only overload of traverse().
+     */
+    template <typename PreVisit>
+    void traverse(PreVisit&& pre_visit, bool ignore_applicability = false) {
+        traverse(std::forward<PreVisit>(pre_visit), [](Node&) {}, ignore_applicability);
+    }
 };
 
 } // namespace node
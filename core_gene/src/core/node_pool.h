@@ -0,0 +1,205 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "../utils/generational_handle.h"
+
+/**
+ * @file node_pool.h
+ * @brief Slab storage and generational handles for scene graph nodes
+ *
+ * Every node lives in a fixed-size slot of a chunked slab, together with the
+ * control block of the shared_ptr that owns it. Nodes created one after the
+ * other are therefore adjacent in memory, and creating a node costs no heap
+ * allocation once the slab has grown. A NodeHandle names a slot plus the
+ * generation of its occupant, so a handle to a destroyed node never resolves
+ * to the node that reuses its slot (see generational_handle.h).
+ */
+
+namespace node {
+
+struct NodeTag;
+
+/// @brief 32-bit generational reference to a pooled node (24-bit slot, 8-bit generation)
+using NodeHandle = generational::Handle<NodeTag>;
+
+/**
+ * @class NodePool
+ * @brief Chunked slab of node slots with a free list
+ * @tparam T The node type stored in the slots
+ *
+ * Slots are released only when both the node and its shared_ptr control block
+ * are gone (a weak_ptr can keep the control block alive past the node).
+ * Freed slots are reused in FIFO order by generational::IndexAllocator, so a
+ * slot is only reused after many others and is retired before its generation
+ * wraps.
+ * Chunks are never returned to the system; the pool is sized by the largest
+ * scene seen so far.
+ *
+ * @note Not thread-safe, like the scene graph itself.
+ */
+template <typename T>
+class NodePool {
+public:
+    static constexpr uint32_t CHUNK_SIZE = 1024;          ///< Slots per slab chunk
+    static constexpr size_t CONTROL_BLOCK_SIZE = 32;      ///< Bytes reserved for the shared_ptr control block
+    static constexpr uint32_t MAX_NODES = generational::IndexAllocator::MAX_INDICES;
+
+private:
+    struct Slot {
+        alignas(std::max_align_t) unsigned char control[CONTROL_BLOCK_SIZE];
+        alignas(T) unsigned char object[sizeof(T)];
+    };
+
+    enum State : uint8_t {
+        Free = 0,
+        NodeAlive = 1,     ///< Node constructed
+        ControlAlive = 2   ///< Control block stored in the slot
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    std::vector<uint8_t> m_states;
+    generational::IndexAllocator m_indices;
+    size_t m_live = 0;
+
+    NodePool() = default;
+
+    Slot& slot(uint32_t index) {
+        return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+
+    void grow() {
+        m_chunks.emplace_back(new Slot[CHUNK_SIZE]);
+        m_states.resize(m_chunks.size() * CHUNK_SIZE, Free);
+    }
+
+    void clearState(uint32_t index, State state) {
+        m_states[index] &= static_cast<uint8_t>(~state);
+        if (m_states[index] == Free) {
+            m_indices.recycle(index);
+        }
+    }
+
+public:
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * @brief Gets the pool for node type T.
+     * @note Never destroyed, so nodes held by other static objects can still release their slots at exit.
+     */
+    static NodePool& instance() {
+        static NodePool* pool = new NodePool();
+        return *pool;
+    }
+
+    /**
+     * @brief Reserves a slot; the caller constructs the node in objectStorage().
+     */
+    NodeHandle acquire() {
+        uint32_t index = m_indices.acquire();
+        if (index >= getCapacity()) {
+            grow();
+        }
+        m_states[index] = NodeAlive;
+        ++m_live;
+        return NodeHandle::Make(index, m_indices.generation(index));
+    }
+
+    void* objectStorage(NodeHandle handle) {
+        return slot(handle.index()).object;
+    }
+
+    void* controlStorage(NodeHandle handle) {
+        return slot(handle.index()).control;
+    }
+
+    /**
+     * @brief Marks the node of a slot destroyed; outstanding handles stop resolving.
+     */
+    void releaseObject(NodeHandle handle) {
+        uint32_t index = handle.index();
+        m_indices.invalidate(index);
+        --m_live;
+        clearState(index, NodeAlive);
+    }
+
+    void markControl(NodeHandle handle) {
+        m_states[handle.index()] |= ControlAlive;
+    }
+
+    void releaseControl(NodeHandle handle) {
+        clearState(handle.index(), ControlAlive);
+    }
+
+    /**
+     * @brief Resolves a handle to its node.
+     * @return The node, or nullptr if it was destroyed or the handle is invalid.
+     */
+    T* resolve(NodeHandle handle) {
+        uint32_t index = handle.index();
+        if (!m_indices.matches(index, handle.generation()) || !(m_states[index] & NodeAlive)) {
+            return nullptr;
+        }
+        return std::launder(reinterpret_cast<T*>(slot(index).object));
+    }
+
+    /** @brief Nodes currently alive */
+    size_t getLiveCount() const { return m_live; }
+
+    /** @brief Slots allocated (live and free) */
+    size_t getCapacity() const { return m_chunks.size() * CHUNK_SIZE; }
+
+    /** @brief Bytes held by the slab, excluding what nodes allocate themselves */
+    size_t getReservedBytes() const { return getCapacity() * sizeof(Slot); }
+};
+
+/**
+ * @class SlotAllocator
+ * @brief Places the shared_ptr control block of a pooled node inside its slot.
+ *
+ * Falls back to the heap if the standard library's control block is larger
+ * than NodePool::CONTROL_BLOCK_SIZE.
+ */
+template <typename U, typename T>
+class SlotAllocator {
+public:
+    using value_type = U;
+
+    NodeHandle handle;
+
+    explicit SlotAllocator(NodeHandle h) noexcept : handle(h) {}
+    template <typename V>
+    SlotAllocator(const SlotAllocator<V, T>& other) noexcept : handle(other.handle) {}
+
+    U* allocate(size_t count) {
+        if (count * sizeof(U) <= NodePool<T>::CONTROL_BLOCK_SIZE && alignof(U) <= alignof(std::max_align_t)) {
+            NodePool<T>::instance().markControl(handle);
+            return static_cast<U*>(NodePool<T>::instance().controlStorage(handle));
+        }
+        return static_cast<U*>(::operator new(count * sizeof(U)));
+    }
+
+    void deallocate(U* ptr, size_t) noexcept {
+        if (static_cast<void*>(ptr) == NodePool<T>::instance().controlStorage(handle)) {
+            NodePool<T>::instance().releaseControl(handle);
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+    template <typename V>
+    bool operator==(const SlotAllocator<V, T>& other) const noexcept { return handle == other.handle; }
+    template <typename V>
+    bool operator!=(const SlotAllocator<V, T>& other) const noexcept { return handle != other.handle; }
+};
+
+} // namespace node
+
+#endif // NODE_POOL_H
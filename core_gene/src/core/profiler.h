@@ -0,0 +1,502 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../gl_base/gl_includes.h"
+
+/**
+ * @file profiler.h
+ * @brief Scoped CPU/GPU frame profiler with Chrome trace export
+ *
+ * EnGene wraps its run phases in profiling scopes; the scene graph can
+ * additionally record every node and component apply. GPU scopes use
+ * glQueryCounter timestamps from a query pool and are read back a few frames
+ * later, so profiling never waits for the GPU.
+ *
+ * See README.md for usage examples.
+ */
+
+/**
+ * @brief Compile-time switch for the built-in profiling hooks.
+ *
+ * Defaults to 0 when NDEBUG is defined and to 1 otherwise. With 0, the
+ * ENGENE_PROFILE_* macros and every hook inside EnGene compile to nothing;
+ * the Profiler API stays available but never receives events.
+ */
+#ifndef ENGENE_PROFILING
+    #ifdef NDEBUG
+        #define ENGENE_PROFILING 0
+    #else
+        #define ENGENE_PROFILING 1
+    #endif
+#endif
+
+namespace profiling {
+
+/**
+ * @enum Detail
+ * @brief How fine-grained the recorded scopes are (each level includes the previous)
+ */
+enum class Detail {
+    Phases,      ///< EnGene run phases and user scopes
+    Nodes,       ///< + one scope per visited scene node
+    Components   ///< + one scope per component apply
+};
+
+/**
+ * @struct Event
+ * @brief One closed profiling scope
+ */
+struct Event {
+    const char* name = nullptr;  ///< Static or interned string, valid for the profiler's lifetime
+    int depth = 0;               ///< Nesting depth inside the frame (0 = outermost)
+    double start_ms = 0.0;       ///< CPU start, relative to the profiler epoch
+    double cpu_ms = 0.0;         ///< CPU duration
+    double gpu_start_ms = -1.0;  ///< GPU start on the CPU timeline (-1 without GPU timing)
+    double gpu_ms = -1.0;        ///< GPU duration (-1 without GPU timing or if dropped)
+    GLuint query_begin = 0;      ///< Timestamp queries, 0 once resolved
+    GLuint query_end = 0;
+};
+
+/**
+ * @struct FrameProfile
+ * @brief All scopes of one frame
+ */
+struct FrameProfile {
+    uint64_t frame = 0;          ///< Frame number since the profiler was created
+    double start_ms = 0.0;       ///< CPU start, relative to the profiler epoch
+    double cpu_ms = 0.0;         ///< beginFrame() to endFrame()
+    double gpu_clock_offset_ms = 0.0;  ///< Maps GPU timestamps onto the CPU timeline
+    std::vector<Event> events;   ///< Scopes in the order they were opened
+
+    /** @brief Summed CPU time of all scopes with this name */
+    double cpuTime(const char* name) const {
+        double total = 0.0;
+        for (const auto& e : events) {
+            if (std::strcmp(e.name, name) == 0) total += e.cpu_ms;
+        }
+        return total;
+    }
+
+    /** @brief Summed GPU time of all scopes with this name (-1 if none was timed) */
+    double gpuTime(const char* name) const {
+        double total = -1.0;
+        for (const auto& e : events) {
+            if (e.gpu_ms >= 0.0 && std::strcmp(e.name, name) == 0) {
+                total = (total < 0.0 ? 0.0 : total) + e.gpu_ms;
+            }
+        }
+        return total;
+    }
+
+    /** @brief Number of scopes with this name */
+    size_t count(const char* name) const {
+        size_t n = 0;
+        for (const auto& e : events) {
+            if (std::strcmp(e.name, name) == 0) ++n;
+        }
+        return n;
+    }
+};
+
+/**
+ * @class Profiler
+ * @brief Collects scopes per frame and keeps a rolling history of finished frames
+ *
+ * Enabling or changing the detail level takes effect at the next beginFrame(),
+ * so scopes opened in one frame are always closed in the same frame.
+ *
+ * @note Single-threaded: scopes must be opened and closed on the GL thread.
+ * Other threads that run profiled code call profiling::ignoreCurrentThread().
+ *
+ * Usage:
+ * @code
+ * profiling::profiler().setEnabled(true);
+ *
+ * {
+ *     ENGENE_PROFILE_GPU_SCOPE("Shadows");
+ *     renderShadows();
+ * }
+ *
+ * if (const auto* frame = profiling::profiler().getLastFrame()) {
+ *     std::cout << frame->cpuTime("Render") << " ms" << std::endl;
+ * }
+ * profiling::profiler().writeChromeTrace("frame_trace.json");
+ * @endcode
+ */
+class Profiler {
+private:
+    /// Frames whose GPU queries may stay unresolved before their GPU times are dropped
+    static constexpr size_t MAX_PENDING_FRAMES = 4;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point m_epoch = Clock::now();
+
+    bool m_enabled = false;
+    bool m_requested_enabled = false;
+    Detail m_detail = Detail::Phases;
+    Detail m_requested_detail = Detail::Phases;
+    size_t m_history_size = 300;
+    uint64_t m_frame_counter = 0;
+
+    FrameProfile m_current;
+    std::vector<size_t> m_open;              ///< Indices of open scopes in m_current.events
+    bool m_current_has_gpu = false;
+    std::deque<FrameProfile> m_pending;      ///< Finished frames waiting for GPU results
+    std::deque<FrameProfile> m_history;      ///< Finished, fully resolved frames
+    std::vector<FrameProfile> m_spare;       ///< Recycled frames (keeps event capacity)
+    std::vector<GLuint> m_free_queries;
+    std::unordered_set<std::string> m_names; ///< Interned dynamic names
+
+    double nowMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - m_epoch).count();
+    }
+
+    GLuint acquireQuery() {
+        if (m_free_queries.empty()) {
+            GLuint ids[16];
+            glGenQueries(16, ids);
+            m_free_queries.insert(m_free_queries.end(), ids, ids + 16);
+        }
+        GLuint id = m_free_queries.back();
+        m_free_queries.pop_back();
+        return id;
+    }
+
+    void releaseQueries(FrameProfile& frame) {
+        for (auto& e : frame.events) {
+            if (e.query_begin) m_free_queries.push_back(e.query_begin);
+            if (e.query_end) m_free_queries.push_back(e.query_end);
+            e.query_begin = e.query_end = 0;
+        }
+    }
+
+    FrameProfile takeSpare() {
+        if (m_spare.empty()) {
+            return FrameProfile();
+        }
+        FrameProfile frame = std::move(m_spare.back());
+        m_spare.pop_back();
+        frame.events.clear();
+        return frame;
+    }
+
+    void pushHistory(FrameProfile&& frame) {
+        m_history.push_back(std::move(frame));
+        while (m_history.size() > m_history_size) {
+            m_spare.push_back(std::move(m_history.front()));
+            m_history.pop_front();
+        }
+    }
+
+    /**
+     * @brief Moves pending frames whose queries are available into the history.
+     * @note Frames older than MAX_PENDING_FRAMES lose their GPU times instead of stalling.
+     */
+    void resolvePending() {
+        while (!m_pending.empty()) {
+            FrameProfile& frame = m_pending.front();
+
+            // Outer scopes end last but come first in the list, so check every end query
+            GLint available = GL_TRUE;
+            for (const auto& e : frame.events) {
+                if (e.query_end && available) {
+                    glGetQueryObjectiv(e.query_end, GL_QUERY_RESULT_AVAILABLE, &available);
+                }
+            }
+
+            if (available) {
+                for (auto& e : frame.events) {
+                    if (!e.query_begin) continue;
+                    GLuint64 begin_ns = 0, end_ns = 0;
+                    glGetQueryObjectui64v(e.query_begin, GL_QUERY_RESULT, &begin_ns);
+                    glGetQueryObjectui64v(e.query_end, GL_QUERY_RESULT, &end_ns);
+                    e.gpu_start_ms = static_cast<double>(begin_ns) * 1e-6 + frame.gpu_clock_offset_ms;
+                    e.gpu_ms = static_cast<double>(end_ns - begin_ns) * 1e-6;
+                }
+            } else if (m_pending.size() <= MAX_PENDING_FRAMES) {
+                break;
+            }
+
+            releaseQueries(frame);
+            pushHistory(std::move(frame));
+            m_pending.pop_front();
+        }
+    }
+
+    static void writeJsonString(std::ostream& out, const char* text) {
+        out << '"';
+        for (const char* c = text; *c; ++c) {
+            switch (*c) {
+                case '"':  out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) >= 0x20) out << *c;
+                    break;
+            }
+        }
+        out << '"';
+    }
+
+    static void writeTraceEvent(std::ostream& out, bool& first, const char* name, const char* category,
+                                int tid, double start_ms, double duration_ms) {
+        out << (first ? "\n" : ",\n") << "  {\"name\":";
+        writeJsonString(out, name);
+        out << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+            << ",\"ts\":" << start_ms * 1000.0 << ",\"dur\":" << duration_ms * 1000.0 << "}";
+        first = false;
+    }
+
+    Profiler() = default;
+    friend Profiler& profiler();
+
+public:
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // --- Configuration ---
+
+    /** @brief Turns recording on or off from the next beginFrame() */
+    void setEnabled(bool enabled) { m_requested_enabled = enabled; }
+
+    /** @brief Checks whether the current frame is being recorded */
+    bool isEnabled() const { return m_enabled; }
+
+    /** @brief Sets the recording granularity from the next beginFrame() */
+    void setDetail(Detail detail) { m_requested_detail = detail; }
+
+    /** @brief Gets the granularity of the current frame */
+    Detail getDetail() const { return m_detail; }
+
+    /** @brief Checks whether scopes of the given granularity are recorded this frame */
+    bool isRecording(Detail level) const {
+        return m_enabled && static_cast<int>(level) <= static_cast<int>(m_detail);
+    }
+
+    /** @brief Sets how many finished frames are kept for queries and trace export (default: 300) */
+    void setHistorySize(size_t frames) {
+        m_history_size = frames > 0 ? frames : 1;
+        while (m_history.size() > m_history_size) {
+            m_spare.push_back(std::move(m_history.front()));
+            m_history.pop_front();
+        }
+    }
+
+    // --- Frame boundaries (called by EnGene) ---
+
+    /**
+     * @brief Starts a frame: applies pending settings and collects finished GPU queries.
+     */
+    void beginFrame() {
+        resolvePending();
+
+        m_enabled = m_requested_enabled;
+        m_detail = m_requested_detail;
+        m_open.clear();
+        m_current_has_gpu = false;
+        m_current.events.clear();
+        m_current.frame = m_frame_counter++;
+        m_current.start_ms = nowMs();
+        m_current.gpu_clock_offset_ms = 0.0;
+
+        if (m_enabled) {
+            // Timestamp of the GPU command stream right now (does not wait for the GPU)
+            GLint64 gpu_now_ns = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpu_now_ns);
+            m_current.gpu_clock_offset_ms = nowMs() - static_cast<double>(gpu_now_ns) * 1e-6;
+        }
+    }
+
+    /**
+     * @brief Ends a frame and queues it until its GPU times are available.
+     */
+    void endFrame() {
+        if (!m_enabled) {
+            return;
+        }
+        while (!m_open.empty()) {
+            end();  // Close scopes left open, e.g. by an exception
+        }
+        m_current.cpu_ms = nowMs() - m_current.start_ms;
+
+        FrameProfile next = takeSpare();
+        std::swap(next, m_current);
+        if (m_current_has_gpu) {
+            m_pending.push_back(std::move(next));
+        } else {
+            pushHistory(std::move(next));
+        }
+    }
+
+    // --- Scopes ---
+
+    /**
+     * @brief Opens a scope in the current frame
+     * @param name Must outlive the profiler (string literal or intern())
+     * @param gpu Also time the GPU commands issued inside the scope
+     */
+    void begin(const char* name, bool gpu = false) {
+        Event e;
+        e.name = name;
+        e.depth = static_cast<int>(m_open.size());
+        if (gpu) {
+            e.query_begin = acquireQuery();
+            e.query_end = acquireQuery();
+            glQueryCounter(e.query_begin, GL_TIMESTAMP);
+            m_current_has_gpu = true;
+        }
+        e.start_ms = nowMs();
+        m_open.push_back(m_current.events.size());
+        m_current.events.push_back(e);
+    }
+
+    /** @brief Closes the innermost open scope */
+    void end() {
+        if (m_open.empty()) {
+            return;
+        }
+        Event& e = m_current.events[m_open.back()];
+        m_open.pop_back();
+        e.cpu_ms = nowMs() - e.start_ms;
+        if (e.query_end) {
+            glQueryCounter(e.query_end, GL_TIMESTAMP);
+        }
+    }
+
+    /** @brief Returns a stable copy of a dynamic name, for use as a scope name */
+    const char* intern(const std::string& name) {
+        return m_names.insert(name).first->c_str();
+    }
+
+    // --- Results ---
+
+    /** @brief Latest fully resolved frame, or nullptr before the first one */
+    const FrameProfile* getLastFrame() const {
+        return m_history.empty() ? nullptr : &m_history.back();
+    }
+
+    /** @brief Resolved frames, oldest first */
+    const std::deque<FrameProfile>& getHistory() const {
+        return m_history;
+    }
+
+    /** @brief Drops all recorded frames */
+    void clear() {
+        while (!m_history.empty()) {
+            m_spare.push_back(std::move(m_history.front()));
+            m_history.pop_front();
+        }
+    }
+
+    /**
+     * @brief Writes the frame history as Chrome trace_event JSON
+     * @param path Output file, open it in chrome://tracing or https://ui.perfetto.dev
+     * @return false if the file could not be written
+     * @note CPU scopes go to thread 0, GPU scopes to thread 1.
+     */
+    bool writeChromeTrace(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Warning: Profiler could not open '" << path << "' for writing" << std::endl;
+            return false;
+        }
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+            << "\n  {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"CPU\"}},"
+            << "\n  {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"GPU\"}}";
+        bool first = false;  // Thread names already written
+
+        for (const auto& frame : m_history) {
+            std::string frame_name = "Frame " + std::to_string(frame.frame);
+            writeTraceEvent(out, first, frame_name.c_str(), "frame", 0, frame.start_ms, frame.cpu_ms);
+            for (const auto& e : frame.events) {
+                writeTraceEvent(out, first, e.name, "cpu", 0, e.start_ms, e.cpu_ms);
+                if (e.gpu_ms >= 0.0) {
+                    writeTraceEvent(out, first, e.name, "gpu", 1, e.gpu_start_ms, e.gpu_ms);
+                }
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+};
+
+/**
+ * @brief Gets the global profiler.
+ * @note Never destroyed: its query objects are released with the GL context.
+ */
+inline Profiler& profiler() {
+    static Profiler* instance = new Profiler();
+    return *instance;
+}
+
+namespace detail {
+inline bool& threadIgnored() {
+    thread_local bool ignored = false;
+    return ignored;
+}
+}
+
+/**
+ * @brief Makes scopes opened on the calling thread record nothing.
+ * EnGene's simulation thread calls this, since it runs the same systems as the GL thread.
+ */
+inline void ignoreCurrentThread() {
+    detail::threadIgnored() = true;
+}
+
+/**
+ * @class Scope
+ * @brief RAII profiling scope; use through the ENGENE_PROFILE_* macros
+ */
+class Scope {
+private:
+    bool m_active;
+
+public:
+    explicit Scope(const char* name, bool gpu = false, Detail level = Detail::Phases)
+        : m_active(!detail::threadIgnored() && profiler().isRecording(level)) {
+        if (m_active) profiler().begin(name, gpu);
+    }
+
+    ~Scope() {
+        if (m_active) profiler().end();
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+} // namespace profiling
+
+#define ENGENE_PROFILE_CONCAT_INNER(a, b) a##b
+#define ENGENE_PROFILE_CONCAT(a, b) ENGENE_PROFILE_CONCAT_INNER(a, b)
+
+#if ENGENE_PROFILING
+    /// CPU scope until the end of the enclosing block
+    #define ENGENE_PROFILE_SCOPE(name) \
+        profiling::Scope ENGENE_PROFILE_CONCAT(engene_profile_scope_, __LINE__)(name)
+    /// CPU and GPU scope until the end of the enclosing block
+    #define ENGENE_PROFILE_GPU_SCOPE(name) \
+        profiling::Scope ENGENE_PROFILE_CONCAT(engene_profile_scope_, __LINE__)(name, true)
+    /// CPU scope recorded only at the given Detail level
+    #define ENGENE_PROFILE_DETAIL_SCOPE(name, level) \
+        profiling::Scope ENGENE_PROFILE_CONCAT(engene_profile_scope_, __LINE__)(name, false, level)
+#else
+    #define ENGENE_PROFILE_SCOPE(name) do { } while (0)
+    #define ENGENE_PROFILE_GPU_SCOPE(name) do { } while (0)
+    #define ENGENE_PROFILE_DETAIL_SCOPE(name, level) do { } while (0)
+#endif
+
+#endif // PROFILER_H
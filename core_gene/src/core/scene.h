@@ -14,6 +14,7 @@
 #include "../3d/camera/camera.h"
 #include "../3d/camera/orthographic_camera.h"
 #include "../gl_base/transform.h"
+#include "profiler.h"
 #include "../exceptions/node_not_found_exception.h"
 
 
@@ -102,15 +103,30 @@ private:
     void configureNodeForDrawing(const SceneNodePtr& node) {
         if (!node) return;
 
-        // The pre-visit action: apply the node's components.
-        node->onPreVisit([](SceneNode& n) {
-            n.payload().apply(); // The payload is the ComponentCollection
-        });
-
-        // The post-visit action: unapply the node's components.
-        node->onPostVisit([](SceneNode& n) {
-            n.payload().unapply();
-        });
+        // One set of actions for every drawn node, so nodes do not each carry two std::functions
+        static const SceneNode::VisitActionsPtr drawing = std::make_shared<const SceneNode::VisitActions>(
+            SceneNode::VisitActions{
+                // The pre-visit action: apply the node's components.
+                [](SceneNode& n) {
+#if ENGENE_PROFILING
+                    // Spans the whole subtree; closed in the post-visit action
+                    if (profiling::profiler().isRecording(profiling::Detail::Nodes)) {
+                        profiling::profiler().begin(profiling::profiler().intern(n.getName()));
+                    }
+#endif
+                    n.payload().apply(); // The payload is the ComponentCollection
+                },
+                // The post-visit action: unapply the node's components.
+                [](SceneNode& n) {
+                    n.payload().unapply();
+#if ENGENE_PROFILING
+                    if (profiling::profiler().isRecording(profiling::Detail::Nodes)) {
+                        profiling::profiler().end();
+                    }
+#endif
+                }
+            });
+        node->setVisitActions(drawing);
     }
 
 public:
@@ -319,6 +335,7 @@ public:
      */
     void draw(float aspect_ratio = 1.0f) {
         if (root) {
+            updateWorldTransforms();
             root->visit();
         }
     }
@@ -328,10 +345,27 @@ public:
      */
     void drawSubtree(SceneNodePtr node, float aspect_ratio = 1.0f) {
         if (node) {
+            SceneNode* tree_root = node.get();
+            while (SceneNode* parent = SceneNode::Resolve(tree_root->getParentHandle())) {
+                tree_root = parent;
+            }
+            scene::updateWorldTransforms(*tree_root);
             node->visit();
         }
     }
 
+    /**
+     * @brief Recomputes the world matrices of the dirty parts of the graph and
+     * notifies the ObservedTransformComponents whose world transform changed.
+     * draw() calls this first; call it earlier in the frame to read world
+     * transforms (e.g. for physics or picking) before drawing.
+     */
+    void updateWorldTransforms() {
+        if (root) {
+            scene::updateWorldTransforms(*root);
+        }
+    }
+
     void drawSubtree(const std::string& node_name, float aspect_ratio = 1.0f) { // --- MODIFIED ---
         SceneNodePtr node = getNodeByName(node_name);
         if (node) {
@@ -68,6 +68,22 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Links the current node to an entity of the ECS backend (see ecs/world.h).
+     *
+     * The node keeps only the handle; the entity's transform, mesh and material
+     * are drawn by ecs::drawEntities(), not by the node's components.
+     *
+     * @param entity The entity, e.g. from ecs::world().create().
+     * @return A reference to the current builder for chaining.
+     */
+    SceneNodeBuilder& withEntity(ecs::Entity entity) {
+        if (node_) {
+            node_->payload().setEntity(entity);
+        }
+        return *this;
+    }
+
     /**
      * @brief Adds a new child node to the current node and returns a builder for it.
      *
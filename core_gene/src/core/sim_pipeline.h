@@ -0,0 +1,168 @@
+#ifndef SIM_PIPELINE_H
+#define SIM_PIPELINE_H
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "job_system.h"
+#include "profiler.h"
+#include "../ecs/world.h"
+#include "../ecs/systems.h"
+#include "../ecs/render_snapshot.h"
+
+/**
+ * @file sim_pipeline.h
+ * @brief Simulation thread of EnGene's pipelined mode
+ *
+ * With EnGeneConfig::pipelined, each frame is a handoff between two threads:
+ *
+ *   main thread:        | sync N | render N (front snapshot) | sync N+1 | render N+1 ...
+ *   simulation thread:           | fixed updates N+1, extract |          | fixed updates N+2 ...
+ *
+ * At the sync point the simulation thread is idle: the main thread swaps the
+ * two snapshots, runs the sync callback and starts the next simulation step.
+ * That handoff is the only lock; while the threads work they touch disjoint
+ * data, so simulation and render time overlap instead of adding up.
+ *
+ * See README.md for usage examples.
+ */
+
+namespace pipeline {
+
+/**
+ * @class SimulationThread
+ * @brief Runs fixed updates and ECS extraction on its own thread, one frame ahead of the renderer
+ *
+ * The thread owns ecs::world() between start() and wait(). A step runs the
+ * fixed update `steps` times, then ecs::updateTransforms() and extracts the
+ * back snapshot. An exception thrown by the fixed update is rethrown by the
+ * next wait().
+ */
+class SimulationThread {
+private:
+    std::function<void(double)> m_fixed_update;
+    double m_timestep;
+
+    ecs::RenderSnapshot m_snapshots[2];
+    int m_front = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;  // Simulation thread waits for start() or the destructor
+    std::condition_variable m_done;  // Main thread waits for the step to finish
+    bool m_busy = false;
+    bool m_stopping = false;
+    int m_steps = 0;
+    std::exception_ptr m_error;
+
+    std::thread m_thread;
+
+    void simulate(int steps) {
+        for (int i = 0; i < steps; ++i) {
+            if (m_fixed_update) {
+                m_fixed_update(m_timestep);
+            }
+        }
+        ecs::updateTransforms(ecs::world());
+        m_snapshots[1 - m_front].extract(ecs::world());
+    }
+
+    void loop() {
+        profiling::ignoreCurrentThread();  // The profiler only records the GL thread
+        const bool attached = jobs::system().attachThread();  // Keeps its jobs apart from the main thread's
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this] { return m_busy || m_stopping; });
+            if (m_stopping) {
+                break;
+            }
+            const int steps = m_steps;
+            lock.unlock();
+            try {
+                simulate(steps);
+            } catch (...) {
+                m_error = std::current_exception();
+            }
+            lock.lock();
+            m_busy = false;
+            m_done.notify_one();
+        }
+
+        if (attached) {
+            jobs::system().detachThread();
+        }
+    }
+
+public:
+    /**
+     * @param fixed_update Called `steps` times per step with `timestep`, on the simulation thread.
+     * Extracts the current world into the back snapshot, which the first swap() publishes.
+     */
+    SimulationThread(std::function<void(double)> fixed_update, double timestep)
+        : m_fixed_update(std::move(fixed_update)),
+          m_timestep(timestep)
+    {
+        ecs::updateTransforms(ecs::world());
+        m_snapshots[1 - m_front].extract(ecs::world());
+        m_thread = std::thread(&SimulationThread::loop, this);
+    }
+
+    ~SimulationThread() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this] { return !m_busy; });
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    /**
+     * @brief Starts simulating the next frame: `steps` fixed updates, then extraction.
+     * Call it only when the thread is idle (after wait()).
+     */
+    void start(int steps) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_steps = steps;
+            m_busy = true;
+        }
+        m_wake.notify_one();
+    }
+
+    /**
+     * @brief Blocks until the current step is finished, then rethrows its exception, if any.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return !m_busy; });
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Makes the snapshot extracted by the last step the front one. Call it after wait().
+     * The old front snapshot releases its resources here, on the calling thread.
+     */
+    void swap() {
+        m_front = 1 - m_front;
+        m_snapshots[1 - m_front].release();
+    }
+
+    /** @brief Snapshot the renderer draws; only changes in swap() */
+    const ecs::RenderSnapshot& front() const { return m_snapshots[m_front]; }
+};
+
+} // namespace pipeline
+
+#endif // SIM_PIPELINE_H
@@ -0,0 +1,21 @@
+#ifndef ECS_ENTITY_H
+#define ECS_ENTITY_H
+#pragma once
+
+#include "../utils/generational_handle.h"
+
+namespace ecs {
+
+struct EntityTag;
+
+/**
+ * @brief 32-bit generational entity handle (24-bit index, 8-bit generation)
+ *
+ * A default-constructed Entity is invalid. A handle to a destroyed entity
+ * stops resolving, even after its index is reused (see generational_handle.h).
+ */
+using Entity = generational::Handle<EntityTag>;
+
+} // namespace ecs
+
+#endif // ECS_ENTITY_H
@@ -0,0 +1,139 @@
+#ifndef ECS_RENDER_SNAPSHOT_H
+#define ECS_RENDER_SNAPSHOT_H
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "world.h"
+#include "systems.h"
+#include "../core/command_buffer.h"
+
+/**
+ * @file render_snapshot.h
+ * @brief A copy of everything the renderer reads from the ECS world for one frame
+ *
+ * EnGene's pipelined mode (EnGeneConfig::pipelined) simulates the next frame
+ * on a second thread while the current one renders. The renderer then cannot
+ * read the world, which is being changed; it draws a RenderSnapshot instead.
+ * Two snapshots are used in turn: the simulation thread extracts into one while
+ * the main thread draws the other, so neither waits on a lock while it works.
+ * The draws are recorded as a command::CommandBuffer, so sorting and grouping
+ * happen on the simulation thread and drawing is a replay of packets.
+ *
+ * See README.md for usage examples.
+ */
+
+namespace ecs {
+
+/**
+ * @class RenderSnapshot
+ * @brief World matrices, meshes, materials and lights of the drawable entities, at one point in time
+ *
+ * Model matrices are copied. Meshes, materials and lights are shared, so their
+ * own parameters must not change while a snapshot that uses them is drawn.
+ * The snapshot keeps them alive until release(), which lets the simulation
+ * remove entities without the renderer losing their meshes mid-frame.
+ *
+ * Buffers are reused: once a snapshot has seen its largest frame, extract()
+ * does not allocate.
+ */
+class RenderSnapshot {
+private:
+    std::vector<DrawItem> m_draws;  // Sort scratch; points into the world during extract() only
+    command::CommandBuffer m_commands;
+
+    struct LightItem {
+        light::LightPtr light;
+        glm::mat4 world;
+    };
+    std::vector<LightItem> m_lights;
+
+public:
+    /**
+     * @brief Copies the drawable entities and lights of `world`, replacing the previous contents.
+     *
+     * Reads WorldTransform, so run updateTransforms() first. Draws are sorted
+     * by material then mesh, like drawEntities(). Uses no frame arena memory,
+     * so it can run on any thread that owns the world at the time.
+     */
+    void extract(World& world) {
+        constexpr Signature lit = signatureOf<WorldTransform, LightRef>();
+
+        release();
+        extractDraws(world, m_draws);
+
+        // Draws are sorted by material then mesh, so each run needs one push and one bind
+        m_commands.reserve(m_draws.size());
+        const material::MaterialPtr* material = nullptr;
+        const geometry::Geometry* geometry = nullptr;
+        for (const DrawItem& item : m_draws) {
+            const material::Material* item_material = item.material ? item.material->get() : nullptr;
+            if (item_material != (material ? material->get() : nullptr)) {
+                if (material) {
+                    m_commands.popMaterial();
+                }
+                if (item.material) {
+                    m_commands.pushMaterial(*item.material);
+                }
+                material = item.material;
+            }
+            if (item.geometry->get() != geometry) {
+                m_commands.bindGeometry(*item.geometry);
+                geometry = item.geometry->get();
+            }
+            m_commands.draw(*item.model);
+        }
+        if (material) {
+            m_commands.popMaterial();
+        }
+        m_draws.clear();
+
+        world.eachArchetype(lit, [&](Archetype& archetype) {
+            const WorldTransform* world_matrices = archetype.column<WorldTransform>();
+            const LightRef* lights = archetype.column<LightRef>();
+            for (size_t i = 0; i < archetype.size(); ++i) {
+                if (lights[i].light) {
+                    m_lights.push_back(LightItem{lights[i].light, world_matrices[i].matrix});
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Drops the snapshot's references to meshes, materials and lights; the draws become empty.
+     * EnGene calls this on the main thread, so the last reference to a GPU resource is never dropped elsewhere.
+     */
+    void release() {
+        m_commands.clear();
+        m_lights.clear();
+    }
+
+    /**
+     * @brief Submits the captured lights to light::manager() for the next apply(), like submitLights().
+     */
+    void submitLights() const {
+        for (const LightItem& item : m_lights) {
+            light::manager().submitLight(*item.light, item.world);
+        }
+    }
+
+    /**
+     * @brief Draws the captured entities with the current shader, like drawEntities().
+     */
+    void draw() const {
+        ENGENE_PROFILE_SCOPE("ECS Draw");
+        m_commands.execute();
+    }
+
+    /** @brief The recorded draws, for replaying them elsewhere */
+    const command::CommandBuffer& commands() const { return m_commands; }
+
+    size_t drawCount() const { return m_commands.drawCount(); }
+    size_t lightCount() const { return m_lights.size(); }
+};
+
+} // namespace ecs
+
+#endif // ECS_RENDER_SNAPSHOT_H
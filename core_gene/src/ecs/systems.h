@@ -0,0 +1,224 @@
+#ifndef ECS_SYSTEMS_H
+#define ECS_SYSTEMS_H
+#pragma once
+
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "world.h"
+#include "../core/frame_arena.h"
+#include "../core/job_system.h"
+#include "../core/profiler.h"
+#include "../utils/simd_math.h"
+#include "../gl_base/shader.h"
+#include "../gl_base/transform.h"
+#include "../gl_base/material.h"
+#include "../components/light_component.h"  // Brings in the light manager in the order it needs
+
+/**
+ * @file systems.h
+ * @brief Per-frame passes over the ECS world: transform propagation, light submission, drawing
+ *
+ * updateTransforms() splits large archetypes into jobs of ENGENE_ECS_JOB_GRAIN
+ * entities on jobs::system().
+ *
+ * A frame using the ECS backend calls, from the render callback:
+ * @code
+ * ecs::updateTransforms(ecs::world());
+ * ecs::submitLights(ecs::world());   // Before light::manager().apply()
+ * light::manager().apply();
+ * scene::graph()->draw();
+ * ecs::drawEntities(ecs::world());   // With the shader (and camera) bound, like the scene graph
+ * @endcode
+ */
+
+/**
+ * @brief Entities per job in updateTransforms() (default 4096).
+ */
+#ifndef ENGENE_ECS_JOB_GRAIN
+    #define ENGENE_ECS_JOB_GRAIN 4096
+#endif
+
+namespace ecs {
+
+/**
+ * @brief Recomputes every WorldTransform from LocalTransform and the parent's WorldTransform.
+ *
+ * Archetypes are processed in depth order, so every parent is final before its
+ * children read it. Within an archetype the pass is a linear walk over dense
+ * arrays; consecutive entities with the same parent reuse the parent lookup.
+ *
+ * @param root Matrix applied on top of every root entity (e.g. the transform of a scene node)
+ */
+inline void updateTransforms(World& world, const glm::mat4& root = glm::mat4(1.0f)) {
+    ENGENE_PROFILE_SCOPE("ECS Transforms");
+    constexpr Signature required = signatureOf<LocalTransform, WorldTransform>();
+
+    world.eachArchetype(required, [&](Archetype& archetype) {
+        const LocalTransform* local = archetype.column<LocalTransform>();
+        WorldTransform* world_matrices = archetype.column<WorldTransform>();
+        const Parent* parents = archetype.has<Parent>() ? archetype.column<Parent>() : nullptr;
+
+        // Rows of one archetype only read shallower archetypes, so any split of them is independent
+        jobs::system().parallelFor(archetype.size(), ENGENE_ECS_JOB_GRAIN, [&](size_t begin, size_t end) {
+            if (!parents) {
+                // Both columns are packed matrices, so root entities go through one batched multiply
+                static_assert(sizeof(LocalTransform) == sizeof(glm::mat4) && sizeof(WorldTransform) == sizeof(glm::mat4),
+                              "transform columns must be tightly packed matrices");
+                simd::multiply(root, &local[begin].matrix, &world_matrices[begin].matrix, end - begin);
+                return;
+            }
+
+            Entity cached_parent;
+            const glm::mat4* parent_matrix = &root;
+            for (size_t i = begin; i < end; ++i) {
+                if (parents[i].entity != cached_parent) {
+                    cached_parent = parents[i].entity;
+                    const WorldTransform* parent_world = world.get<WorldTransform>(cached_parent);
+                    parent_matrix = parent_world ? &parent_world->matrix : &root;
+                }
+                simd::multiply(*parent_matrix, local[i].matrix, world_matrices[i].matrix);
+            }
+        });
+    });
+}
+
+/**
+ * @brief Submits every entity with a LightRef to light::manager() for the next apply().
+ */
+inline void submitLights(World& world) {
+    constexpr Signature required = signatureOf<WorldTransform, LightRef>();
+
+    world.eachArchetype(required, [&](Archetype& archetype) {
+        const WorldTransform* world_matrices = archetype.column<WorldTransform>();
+        const LightRef* lights = archetype.column<LightRef>();
+        for (size_t i = 0; i < archetype.size(); ++i) {
+            if (lights[i].light) {
+                light::manager().submitLight(*lights[i].light, world_matrices[i].matrix);
+            }
+        }
+    });
+}
+
+/**
+ * @struct DrawItem
+ * @brief One entity to draw, as extracted by extractDraws()
+ */
+struct DrawItem {
+    const glm::mat4* model;
+    const geometry::GeometryPtr* geometry;
+    const material::MaterialPtr* material;  ///< nullptr if the entity has no MaterialRef
+};
+
+namespace detail {
+
+// Groups by material so the material stack changes once per group, then by mesh
+template <typename Iterator>
+void sortDraws(Iterator begin, Iterator end) {
+    std::sort(begin, end, [](const DrawItem& a, const DrawItem& b) {
+        const material::Material* ma = a.material ? a.material->get() : nullptr;
+        const material::Material* mb = b.material ? b.material->get() : nullptr;
+        if (ma != mb) return ma < mb;
+        return a.geometry->get() < b.geometry->get();
+    });
+}
+
+// Draws sorted items on top of the current transform stack with the current shader
+inline void drawItems(const DrawItem* items, size_t count) {
+    auto& lights = light::manager();
+    const bool select_lights = lights.isObjectLightSelectionEnabled();
+    const material::Material* bound_material = nullptr;
+
+    // Select every draw's lights up front so they reach the GPU in one upload
+    uint32_t* light_slots = nullptr;
+    if (select_lights) {
+        light_slots = arena::frame().allocate<uint32_t>(count);
+        lights.beginSelectionBatch(count);
+        const glm::mat4& base = transform::stack()->top();
+        for (size_t i = 0; i < count; ++i) {
+            const DrawItem& item = items[i];
+            light_slots[i] = lights.stageLightsFor(simd::multiply(base, *item.model),
+                                                   (*item.geometry)->getBoundsCenter(),
+                                                   (*item.geometry)->getBoundsRadius());
+        }
+        lights.uploadSelectionBatch();
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const DrawItem& item = items[i];
+        const material::Material* item_material = item.material ? item.material->get() : nullptr;
+        if (item_material != bound_material) {
+            if (bound_material) {
+                material::stack()->pop();
+            }
+            if (item_material) {
+                material::stack()->push(*item.material);
+            }
+            bound_material = item_material;
+        }
+
+        transform::stack()->push(*item.model);
+        if (select_lights) {
+            lights.bindSelection(light_slots[i]);
+        }
+        shader::stack()->top();  // Applies per-draw uniforms (u_model, material, ...)
+        (*item.geometry)->Draw();
+        transform::stack()->pop();
+    }
+
+    if (bound_material) {
+        material::stack()->pop();
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Collects every entity with a WorldTransform and a GeometryRef, sorted by material then mesh.
+ * @param out Receives the draws (an arena::FrameVector or a std::vector); cleared first.
+ * Points into the world, so use it before changing the world.
+ */
+template <typename DrawVector>
+void extractDraws(World& world, DrawVector& out) {
+    constexpr Signature required = signatureOf<WorldTransform, GeometryRef>();
+
+    size_t count = 0;
+    world.eachArchetype(required, [&](Archetype& archetype) { count += archetype.size(); });
+    out.clear();
+    out.reserve(count);
+
+    world.eachArchetype(required, [&](Archetype& archetype) {
+        const WorldTransform* world_matrices = archetype.column<WorldTransform>();
+        const GeometryRef* geometries = archetype.column<GeometryRef>();
+        const MaterialRef* materials = archetype.has<MaterialRef>() ? archetype.column<MaterialRef>() : nullptr;
+        for (size_t i = 0; i < archetype.size(); ++i) {
+            if (!geometries[i].geometry) continue;
+            out.push_back(DrawItem{
+                &world_matrices[i].matrix,
+                &geometries[i].geometry,
+                materials && materials[i].material ? &materials[i].material : nullptr
+            });
+        }
+    });
+
+    detail::sortDraws(out.begin(), out.end());
+}
+
+/**
+ * @brief Draws every entity with a WorldTransform and a GeometryRef using the current shader.
+ *
+ * Each model matrix is pushed on top of the current transform stack, so the
+ * whole ECS world can be placed under a scene node by calling this from a
+ * component. Per-object light selection is honored like in GeometryComponent.
+ * The draw list lives in the frame arena.
+ */
+inline void drawEntities(World& world) {
+    ENGENE_PROFILE_SCOPE("ECS Draw");
+    arena::FrameVector<DrawItem> draws;
+    extractDraws(world, draws);
+    detail::drawItems(draws.data(), draws.size());
+}
+
+} // namespace ecs
+
+#endif // ECS_SYSTEMS_H
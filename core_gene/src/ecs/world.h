@@ -0,0 +1,551 @@
+#ifndef ECS_WORLD_H
+#define ECS_WORLD_H
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../gl_base/geometry.h"
+#include "../gl_base/material.h"
+#include "../3d/lights/light.h"
+#include "entity.h"
+
+/**
+ * @file world.h
+ * @brief Optional archetype-based entity storage for large numbers of simple objects
+ *
+ * The scene graph stores every component as a polymorphic heap object and
+ * calls apply() on it for every node, every frame. For crowds of thousands of
+ * objects that only need a transform, a mesh, a material and maybe a light,
+ * the ECS backend stores those few hot component types in dense arrays
+ * instead. Entities with the same set of components and the same hierarchy
+ * depth share an archetype, and every archetype keeps one array per component
+ * type (structure of arrays). Systems (see systems.h) walk those arrays
+ * linearly.
+ *
+ * The backend is opt-in; scenes that never create an entity pay nothing.
+ * Custom behavior stays in scene graph components.
+ *
+ * See README.md for usage examples.
+ */
+
+namespace ecs {
+
+// --- Hot component types ---
+
+/// @brief Transform relative to the parent entity (or to the root matrix for entities without one)
+struct LocalTransform {
+    glm::mat4 matrix = glm::mat4(1.0f);
+};
+
+/// @brief Combined transform, written by updateTransforms()
+struct WorldTransform {
+    glm::mat4 matrix = glm::mat4(1.0f);
+};
+
+/// @brief Parent entity in the transform hierarchy. Set through World::setParent().
+struct Parent {
+    Entity entity;
+};
+
+/// @brief Mesh drawn by drawEntities()
+struct GeometryRef {
+    geometry::GeometryPtr geometry;
+};
+
+/// @brief Material pushed on the material stack while the entity is drawn
+struct MaterialRef {
+    material::MaterialPtr material;
+};
+
+/// @brief Light submitted to the light manager by submitLights()
+struct LightRef {
+    light::LightPtr light;
+};
+
+/// @brief Bit set of the component types an entity has
+using Signature = uint32_t;
+
+namespace detail {
+
+template <typename T, typename... Ts>
+struct IndexOf;
+
+template <typename T, typename... Ts>
+struct IndexOf<T, T, Ts...> : std::integral_constant<size_t, 0> {};
+
+template <typename T, typename U, typename... Ts>
+struct IndexOf<T, U, Ts...> : std::integral_constant<size_t, 1 + IndexOf<T, Ts...>::value> {};
+
+template <typename... Ts>
+struct ComponentList {
+    using Columns = std::tuple<std::vector<Ts>...>;
+
+    template <typename T>
+    static constexpr Signature bit() { return Signature(1) << IndexOf<T, Ts...>::value; }
+};
+
+using Components = ComponentList<LocalTransform, WorldTransform, Parent, GeometryRef, MaterialRef, LightRef>;
+
+} // namespace detail
+
+/**
+ * @brief Signature bit of a component type.
+ */
+template <typename T>
+constexpr Signature bit() {
+    return detail::Components::bit<T>();
+}
+
+/**
+ * @brief Signature with the bits of all the given component types.
+ */
+template <typename... Ts>
+constexpr Signature signatureOf() {
+    return (Signature(0) | ... | bit<Ts>());
+}
+
+/**
+ * @class Archetype
+ * @brief Entities with the same components and hierarchy depth, one dense array per component
+ *
+ * Rows are kept packed: removing an entity moves the last row into its place.
+ * Arrays of component types outside the signature stay empty.
+ */
+class Archetype {
+private:
+    Signature m_signature;
+    uint32_t m_depth;
+    std::vector<Entity> m_entities;
+    detail::Components::Columns m_columns;
+
+    template <typename Fn>
+    void forEachColumn(Fn&& fn) {
+        std::apply([&](auto&... columns) { (fn(columns), ...); }, m_columns);
+    }
+
+    template <typename Column>
+    static constexpr Signature columnBit() {
+        return bit<typename Column::value_type>();
+    }
+
+    friend class World;
+
+    Archetype(Signature signature, uint32_t depth) : m_signature(signature), m_depth(depth) {}
+
+    uint32_t pushRow(Entity entity) {
+        m_entities.push_back(entity);
+        forEachColumn([&](auto& column) {
+            if (m_signature & columnBit<std::decay_t<decltype(column)>>()) {
+                column.emplace_back();
+            }
+        });
+        return static_cast<uint32_t>(m_entities.size() - 1);
+    }
+
+    /**
+     * @brief Removes a row by moving the last row into it.
+     * @return The entity that now occupies `row`, or an invalid entity if `row` was the last.
+     */
+    Entity swapRemove(uint32_t row) {
+        uint32_t last = static_cast<uint32_t>(m_entities.size() - 1);
+        forEachColumn([&](auto& column) {
+            if (m_signature & columnBit<std::decay_t<decltype(column)>>()) {
+                if (row != last) {
+                    column[row] = std::move(column[last]);
+                }
+                column.pop_back();
+            }
+        });
+        Entity moved;
+        if (row != last) {
+            moved = m_entities[last];
+            m_entities[row] = moved;
+        }
+        m_entities.pop_back();
+        return moved;
+    }
+
+    /**
+     * @brief Moves the components shared by both archetypes from `row` of `from` into `to_row`.
+     */
+    void moveFrom(Archetype& from, uint32_t row, uint32_t to_row) {
+        Signature shared = m_signature & from.m_signature;
+        // Both tuples hold the same column types in the same order, so the packs expand pairwise
+        std::apply([&](auto&... to_columns) {
+            std::apply([&](auto&... from_columns) {
+                (moveColumn(shared, to_columns, from_columns, row, to_row), ...);
+            }, from.m_columns);
+        }, m_columns);
+    }
+
+    template <typename Column>
+    static void moveColumn(Signature shared, Column& to, Column& from, uint32_t row, uint32_t to_row) {
+        if (shared & columnBit<Column>()) {
+            to[to_row] = std::move(from[row]);
+        }
+    }
+
+public:
+    Signature getSignature() const { return m_signature; }
+    uint32_t getDepth() const { return m_depth; }
+    size_t size() const { return m_entities.size(); }
+    bool empty() const { return m_entities.empty(); }
+
+    template <typename T>
+    bool has() const { return (m_signature & bit<T>()) != 0; }
+
+    /// @brief True if the archetype has every bit of `signature`
+    bool matches(Signature signature) const { return (m_signature & signature) == signature; }
+
+    const Entity* entities() const { return m_entities.data(); }
+
+    /**
+     * @brief Dense array of one component type, indexed like entities().
+     * Empty (nullptr data) if the archetype does not have T.
+     */
+    template <typename T>
+    T* column() { return std::get<std::vector<T>>(m_columns).data(); }
+
+    template <typename T>
+    const T* column() const { return std::get<std::vector<T>>(m_columns).data(); }
+};
+
+class World;
+World& world();
+
+/**
+ * @class World
+ * @brief Owns all entities and the archetypes that store their components
+ *
+ * Usage:
+ * @code
+ * ecs::World& w = ecs::world();
+ * ecs::Entity crowd = w.create(glm::translate(glm::mat4(1.0f), origin));
+ * for (int i = 0; i < 10000; ++i) {
+ *     ecs::Entity agent = w.create(agentMatrix(i), crowd);
+ *     w.add(agent, ecs::GeometryRef{mesh});
+ *     w.add(agent, ecs::MaterialRef{skin});
+ * }
+ * @endcode
+ *
+ * Adding or removing a component, or changing the parent, moves the entity to
+ * another archetype; do it at setup time, not per frame. Pointers returned by
+ * get() and column() are invalidated by those operations too.
+ *
+ * @note Not thread-safe, like the scene graph.
+ */
+class World {
+private:
+    struct Record {
+        uint32_t archetype = 0;
+        uint32_t row = 0;
+        uint32_t child_count = 0;  // Lets leaves skip the child search on destroy/setParent
+    };
+
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::vector<Archetype*> m_by_depth;  // Parents are always in an earlier archetype than their children
+    std::unordered_map<uint64_t, uint32_t> m_archetype_index;
+
+    std::vector<Record> m_records;
+    generational::IndexAllocator m_indices;
+    size_t m_live = 0;
+
+    World() = default;
+    friend World& world();
+
+    static uint64_t archetypeKey(Signature signature, uint32_t depth) {
+        return (static_cast<uint64_t>(depth) << 32) | signature;
+    }
+
+    uint32_t findOrCreateArchetype(Signature signature, uint32_t depth) {
+        uint64_t key = archetypeKey(signature, depth);
+        auto it = m_archetype_index.find(key);
+        if (it != m_archetype_index.end()) {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+        m_archetypes.emplace_back(new Archetype(signature, depth));
+        m_archetype_index[key] = index;
+
+        Archetype* created = m_archetypes.back().get();
+        auto pos = std::upper_bound(m_by_depth.begin(), m_by_depth.end(), created,
+            [](const Archetype* a, const Archetype* b) { return a->getDepth() < b->getDepth(); });
+        m_by_depth.insert(pos, created);
+        return index;
+    }
+
+    /**
+     * @brief Moves an entity's row to the archetype for (signature, depth).
+     */
+    void relocate(Entity entity, Signature signature, uint32_t depth) {
+        Record& record = m_records[entity.index()];
+        Archetype& from = *m_archetypes[record.archetype];
+        if (from.getSignature() == signature && from.getDepth() == depth) {
+            return;
+        }
+
+        uint32_t target_index = findOrCreateArchetype(signature, depth);
+        Archetype& to = *m_archetypes[target_index];
+        uint32_t to_row = to.pushRow(entity);
+        to.moveFrom(from, record.row, to_row);
+
+        Entity moved = from.swapRemove(record.row);
+        if (moved.isValid()) {
+            m_records[moved.index()].row = record.row;
+        }
+        record.archetype = target_index;
+        record.row = to_row;
+    }
+
+    uint32_t depthOf(Entity entity) const {
+        return m_archetypes[m_records[entity.index()].archetype]->getDepth();
+    }
+
+    void findChildren(Entity parent, std::vector<Entity>& children) const {
+        children.clear();
+        if (m_records[parent.index()].child_count == 0) return;
+        for (const auto& archetype : m_archetypes) {
+            if (!archetype->has<Parent>()) continue;
+            const Parent* parents = archetype->column<Parent>();
+            for (size_t i = 0; i < archetype->size(); ++i) {
+                if (parents[i].entity == parent) {
+                    children.push_back(archetype->entities()[i]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Re-files the children of `parent` (and their descendants) after its depth changed.
+     */
+    void updateChildDepths(Entity parent) {
+        std::vector<Entity> pending{parent};
+        std::vector<Entity> children;
+        while (!pending.empty()) {
+            Entity current = pending.back();
+            pending.pop_back();
+            uint32_t child_depth = depthOf(current) + 1;
+
+            findChildren(current, children);
+            for (Entity child : children) {
+                Record& record = m_records[child.index()];
+                relocate(child, m_archetypes[record.archetype]->getSignature(), child_depth);
+                pending.push_back(child);
+            }
+        }
+    }
+
+public:
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    static constexpr uint32_t MAX_ENTITIES = generational::IndexAllocator::MAX_INDICES;
+
+    /**
+     * @brief Creates an entity with a LocalTransform and a WorldTransform.
+     * @param local Transform relative to `parent`.
+     * @param parent Parent entity, or an invalid entity for a root.
+     */
+    Entity create(const glm::mat4& local = glm::mat4(1.0f), Entity parent = Entity{}) {
+        uint32_t index = m_indices.acquire();
+        if (index == m_records.size()) {
+            m_records.emplace_back();
+        }
+        Entity entity = Entity::Make(index, m_indices.generation(index));
+
+        Record& record = m_records[index];
+        record.child_count = 0;
+        record.archetype = findOrCreateArchetype(signatureOf<LocalTransform, WorldTransform>(), 0);
+        record.row = m_archetypes[record.archetype]->pushRow(entity);
+        ++m_live;
+
+        get<LocalTransform>(entity)->matrix = local;
+        if (parent.isValid()) {
+            setParent(entity, parent);
+        }
+        return entity;
+    }
+
+    /**
+     * @brief Destroys an entity. Its children become roots.
+     */
+    void destroy(Entity entity) {
+        if (!isAlive(entity)) return;
+
+        // Detach children first, so none keeps a handle that could later resolve to a new entity
+        std::vector<Entity> children;
+        findChildren(entity, children);
+        for (Entity child : children) {
+            setParent(child, Entity{});
+        }
+        setParent(entity, Entity{});
+
+        Record& record = m_records[entity.index()];
+        Entity moved = m_archetypes[record.archetype]->swapRemove(record.row);
+        if (moved.isValid()) {
+            m_records[moved.index()].row = record.row;
+        }
+
+        m_indices.release(entity.index());
+        --m_live;
+    }
+
+    bool isAlive(Entity entity) const {
+        return m_indices.matches(entity.index(), entity.generation());
+    }
+
+    /**
+     * @brief Adds (or overwrites) a component. Use setParent() for Parent.
+     */
+    template <typename T>
+    void add(Entity entity, T value) {
+        static_assert(!std::is_same<T, Parent>::value, "Use World::setParent() to change the parent.");
+        if (!isAlive(entity)) return;
+        Record& record = m_records[entity.index()];
+        Archetype& current = *m_archetypes[record.archetype];
+        relocate(entity, current.getSignature() | bit<T>(), current.getDepth());
+        *get<T>(entity) = std::move(value);
+    }
+
+    /**
+     * @brief Removes a component. Use setParent(entity, Entity{}) for Parent.
+     */
+    template <typename T>
+    void remove(Entity entity) {
+        static_assert(!std::is_same<T, Parent>::value, "Use World::setParent() to change the parent.");
+        if (!isAlive(entity)) return;
+        Record& record = m_records[entity.index()];
+        Archetype& current = *m_archetypes[record.archetype];
+        relocate(entity, current.getSignature() & ~bit<T>(), current.getDepth());
+    }
+
+    template <typename T>
+    bool has(Entity entity) const {
+        return isAlive(entity) && m_archetypes[m_records[entity.index()].archetype]->has<T>();
+    }
+
+    /**
+     * @brief Gets a component of an entity.
+     * @return The component, or nullptr if the entity is dead or does not have it.
+     */
+    template <typename T>
+    T* get(Entity entity) {
+        if (!isAlive(entity)) return nullptr;
+        const Record& record = m_records[entity.index()];
+        Archetype& archetype = *m_archetypes[record.archetype];
+        return archetype.has<T>() ? archetype.column<T>() + record.row : nullptr;
+    }
+
+    /**
+     * @brief Makes `child` a child of `parent`, or a root if `parent` is invalid.
+     * Moves the child and all of its descendants to archetypes of the new depth.
+     * Ignored, with a warning, if `parent` is `child` or one of its descendants.
+     * @note Costs a pass over all entities per level of the moved subtree.
+     */
+    void setParent(Entity child, Entity parent) {
+        if (!isAlive(child)) return;
+        for (Entity ancestor = parent; isAlive(ancestor); ancestor = getParent(ancestor)) {
+            if (ancestor == child) {
+                std::cerr << "Warning: World::setParent would make an entity its own ancestor. Ignoring." << std::endl;
+                return;
+            }
+        }
+        Record& record = m_records[child.index()];
+        Signature signature = m_archetypes[record.archetype]->getSignature();
+
+        Entity old_parent = getParent(child);
+        if (isAlive(old_parent)) {
+            --m_records[old_parent.index()].child_count;
+        }
+
+        if (isAlive(parent)) {
+            relocate(child, signature | bit<Parent>(), depthOf(parent) + 1);
+            get<Parent>(child)->entity = parent;
+            ++m_records[parent.index()].child_count;
+        } else {
+            relocate(child, signature & ~bit<Parent>(), 0);
+        }
+        updateChildDepths(child);
+    }
+
+    /**
+     * @brief Gets the parent of an entity, or an invalid entity for roots.
+     */
+    Entity getParent(Entity entity) {
+        Parent* parent = get<Parent>(entity);
+        return parent ? parent->entity : Entity{};
+    }
+
+    /**
+     * @brief Calls `fn(Entity, Ts&...)` for every entity that has all of Ts.
+     * Archetypes are visited in depth order (parents before children).
+     */
+    template <typename... Ts, typename Fn>
+    void each(Fn&& fn) {
+        constexpr Signature required = signatureOf<Ts...>();
+        for (Archetype* archetype : m_by_depth) {
+            if (!archetype->matches(required) || archetype->empty()) continue;
+            const Entity* entities = archetype->entities();
+            auto columns = std::make_tuple(archetype->column<Ts>()...);
+            for (size_t i = 0; i < archetype->size(); ++i) {
+                fn(entities[i], std::get<Ts*>(columns)[i]...);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls `fn(Archetype&)` for every non-empty archetype that has all the bits of `required`.
+     * Archetypes are visited in depth order (parents before children).
+     */
+    template <typename Fn>
+    void eachArchetype(Signature required, Fn&& fn) {
+        for (Archetype* archetype : m_by_depth) {
+            if (archetype->matches(required) && !archetype->empty()) {
+                fn(*archetype);
+            }
+        }
+    }
+
+    /** @brief Entities currently alive */
+    size_t getEntityCount() const { return m_live; }
+
+    /** @brief Archetypes created so far (including empty ones) */
+    size_t getArchetypeCount() const { return m_archetypes.size(); }
+
+    /**
+     * @brief Destroys every entity. Outstanding handles stop resolving.
+     */
+    void clear() {
+        m_indices.releaseAll();
+        m_archetypes.clear();
+        m_by_depth.clear();
+        m_archetype_index.clear();
+        for (Record& record : m_records) {
+            record.child_count = 0;
+        }
+        m_live = 0;
+    }
+};
+
+/**
+ * @brief Gets the global entity world.
+ */
+inline World& world() {
+    static World instance;
+    return instance;
+}
+
+} // namespace ecs
+
+#endif // ECS_WORLD_H
@@ -10,6 +10,7 @@
 
 #include "gl_includes.h"
 #include "error.h"
+#include "gl_state.h"
 #include "texture.h"
 #include "../exceptions/texture_exception.h"
 
@@ -186,6 +187,7 @@ inline Cubemap::~Cubemap() {
         GLenum error = glGetError(); // Clear any existing errors
         glDeleteTextures(1, &m_tid);
         error = glGetError();
+        gl_state::cache()->onTextureDeleted(m_tid);
         
         // Only report error if it's not GL_INVALID_OPERATION (context destroyed)
         // GL_INVALID_OPERATION (0x0502) means the context is gone, which is fine during shutdown
@@ -198,17 +200,13 @@ inline Cubemap::~Cubemap() {
 
 // Bind method
 inline void Cubemap::Bind(GLuint unit) const {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    GL_CHECK("activate texture unit for cubemap");
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
+    gl_state::cache()->bindTexture(unit, GL_TEXTURE_CUBE_MAP, m_tid);
     GL_CHECK("bind cubemap texture");
 }
 
 // Unbind method
 inline void Cubemap::Unbind(GLuint unit) const {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    GL_CHECK("activate texture unit for cubemap unbind");
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    gl_state::cache()->bindTexture(unit, GL_TEXTURE_CUBE_MAP, 0);
     GL_CHECK("unbind cubemap texture");
 }
 
@@ -299,7 +297,7 @@ inline Cubemap::Cubemap(const std::array<std::string, 6>& face_paths)
     }
     
     // Bind the cubemap texture
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
+    gl_state::cache()->bindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
     GL_CHECK("bind cubemap for configuration");
     
     // Load all 6 faces
@@ -330,7 +328,7 @@ inline Cubemap::Cubemap(const std::array<std::string, 6>& face_paths)
     GL_CHECK("set cubemap texture parameters");
     
     // Unbind
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    gl_state::cache()->bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 // Factory method for individual face files
@@ -459,7 +457,7 @@ inline Cubemap::Cubemap(const std::string& cross_layout_path)
     }
     
     // Bind the cubemap texture
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
+    gl_state::cache()->bindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
     GL_CHECK("bind cubemap for configuration");
     
     // Determine format based on number of channels
@@ -499,7 +497,7 @@ inline Cubemap::Cubemap(const std::string& cross_layout_path)
     GL_CHECK("set cubemap texture parameters");
     
     // Unbind
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    gl_state::cache()->bindTexture(GL_TEXTURE_CUBE_MAP, 0);
     
     // Clean up face data
     for (auto* data : face_data) {
@@ -559,7 +557,7 @@ inline Cubemap::Cubemap(int face_width, int face_height,
     }
     
     // Bind the cubemap texture
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
+    gl_state::cache()->bindTexture(GL_TEXTURE_CUBE_MAP, m_tid);
     GL_CHECK("bind cubemap for configuration");
     
     // Upload all 6 faces
@@ -581,7 +579,7 @@ inline Cubemap::Cubemap(int face_width, int face_height,
     GL_CHECK("set cubemap texture parameters");
     
     // Unbind
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    gl_state::cache()->bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 // Factory method for direct data upload
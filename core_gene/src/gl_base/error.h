@@ -10,6 +10,33 @@
 
 #include "gl_includes.h"
 
+/**
+ * @brief Compile-time ceiling for OpenGL error checking.
+ *
+ * - 0: Off      - GL_CHECK compiles to nothing, no debug callback
+ * - 1: Callback - GL_CHECK compiles to nothing, asynchronous debug callback only
+ * - 2: Sampled  - GL_CHECK calls glGetError() on every Nth checkpoint
+ * - 3: Full     - GL_CHECK calls glGetError() at every checkpoint, synchronous callback
+ *
+ * Defaults to 0 when NDEBUG is defined and to 3 otherwise. Override by
+ * defining ENGENE_GL_CHECK_LEVEL before including EnGene headers:
+ * @code
+ * #define ENGENE_GL_CHECK_LEVEL 1
+ * #include <EnGene.h>
+ * @endcode
+ * The runtime level (Error::setCheckLevel) can only lower this ceiling.
+ */
+#ifndef ENGENE_GL_CHECK_LEVEL
+    #ifdef NDEBUG
+        #define ENGENE_GL_CHECK_LEVEL 0
+    #else
+        #define ENGENE_GL_CHECK_LEVEL 3
+    #endif
+#endif
+
+static_assert(ENGENE_GL_CHECK_LEVEL >= 0 && ENGENE_GL_CHECK_LEVEL <= 3,
+              "ENGENE_GL_CHECK_LEVEL must be in the range [0, 3]");
+
 #include <iostream>
 #include <iomanip>
 #include <cstdint> // For uint64_t
@@ -92,21 +119,104 @@ static void print_stacktrace() {
 
 class Error {
 public:
+    /**
+     * @enum CheckLevel
+     * @brief Runtime OpenGL error checking level (see ENGENE_GL_CHECK_LEVEL).
+     */
+    enum class CheckLevel : int {
+        Off = 0,       ///< No checking at all
+        Callback = 1,  ///< Asynchronous debug callback only, no glGetError()
+        Sampled = 2,   ///< glGetError() on every Nth GL_CHECK
+        Full = 3       ///< glGetError() on every GL_CHECK, synchronous callback
+    };
+
+    /**
+     * @brief Sets the runtime check level.
+     * @param level Requested level, clamped to ENGENE_GL_CHECK_LEVEL
+     * @note Switching between Full and lower levels toggles GL_DEBUG_OUTPUT_SYNCHRONOUS
+     *       if the debug callback is already installed.
+     */
+    static void setCheckLevel(CheckLevel level) {
+        if (static_cast<int>(level) > ENGENE_GL_CHECK_LEVEL) {
+            std::cerr << "Warning: GL check level " << static_cast<int>(level)
+                      << " exceeds the compile-time level " << ENGENE_GL_CHECK_LEVEL
+                      << ". Clamping." << std::endl;
+            level = static_cast<CheckLevel>(ENGENE_GL_CHECK_LEVEL);
+        }
+        s_level = level;
+
+        if (s_callback_installed) {
+            if (level == CheckLevel::Off) {
+                glDisable(GL_DEBUG_OUTPUT);
+            } else {
+                glEnable(GL_DEBUG_OUTPUT);
+            }
+            if (level == CheckLevel::Full) {
+                glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            } else {
+                glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            }
+        }
+    }
+
+    /** @brief Gets the runtime check level */
+    static CheckLevel getCheckLevel() { return s_level; }
+
+    /**
+     * @brief Sets how many GL_CHECK checkpoints pass between glGetError() calls
+     *        in CheckLevel::Sampled (default 64).
+     */
+    static void setSampleInterval(unsigned int interval) {
+        s_sample_interval = interval > 0 ? interval : 1;
+    }
+
+    /** @brief Gets the sampling interval used by CheckLevel::Sampled */
+    static unsigned int getSampleInterval() { return s_sample_interval; }
+
+    /**
+     * @brief Decides whether the current GL_CHECK checkpoint queries glGetError().
+     * @note Called by the GL_CHECK macro before building the message.
+     */
+    static bool shouldCheck() {
+        switch (s_level) {
+            case CheckLevel::Full:
+                return true;
+            case CheckLevel::Sampled:
+                if (++s_sample_counter >= s_sample_interval) {
+                    s_sample_counter = 0;
+                    return true;
+                }
+                return false;
+            default:
+                return false;
+        }
+    }
+
     /**
      * @brief Enables the modern OpenGL debug message callback.
      * This is the recommended way to handle errors.
      * Call this ONCE after your OpenGL context is created and made current.
+     * @note Does nothing in CheckLevel::Off. The callback is synchronous only
+     *       in CheckLevel::Full, so lower levels do not serialize the driver.
      */
     static void EnableDebugCallback() {
+        if (s_level == CheckLevel::Off) {
+            return;
+        }
+
         GLint flags;
         glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
         
         // Check if the debug context flag is set
         if (flags & GL_CONTEXT_FLAG_DEBUG_BIT) {
             glEnable(GL_DEBUG_OUTPUT);
-            // Makes the callback synchronous (call from the same thread)
-            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); 
+            // Synchronous output (callback from the same thread) stalls the driver,
+            // so it is reserved for full checking
+            if (s_level == CheckLevel::Full) {
+                glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            }
             glDebugMessageCallback(OpenGLDebugCallback, nullptr);
+            s_callback_installed = true;
             
             // You can optionally control which messages you want to see
             // glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
@@ -120,8 +230,9 @@ public:
      * @brief Legacy error check using glGetError().
      * Still useful for forcing a check and crash at a specific point.
      * Use the GL_CHECK(msg) macro instead of calling this directly.
+     * Takes the message as a C string so passing checkpoint literals does not allocate.
      */
-    static void CheckInternal(const std::string& msg, const char* file, int line) {
+    static void CheckInternal(const char* msg, const char* file, int line) {
         GLenum err;
         bool hasError = false;
         
@@ -142,8 +253,11 @@ public:
             std::cerr << "--- OpenGL Error (glGetError) ---" << "\n"
                       << "Message:  " << msg << "\n"
                       << "Error:    " << errorString << " (0x" << std::hex << err << std::dec << ")" << "\n"
-                      << "Location: " << file << ":" << line << "\n"
-                      << "---------------------------------" << std::endl;
+                      << "Location: " << file << ":" << line << "\n";
+            if (s_level == CheckLevel::Sampled) {
+                std::cerr << "Note:     sampled checking, the failing call may precede this checkpoint" << "\n";
+            }
+            std::cerr << "---------------------------------" << std::endl;
         }
         
         if (hasError) {
@@ -172,6 +286,11 @@ public:
     }
 
 private:
+    inline static CheckLevel s_level = static_cast<CheckLevel>(ENGENE_GL_CHECK_LEVEL);
+    inline static unsigned int s_sample_interval = 64;
+    inline static unsigned int s_sample_counter = 0;
+    inline static bool s_callback_installed = false;
+
     /**
      * @brief The actual callback function that OpenGL will call with detailed messages.
      * Note: The APIENTRY macro ensures the correct calling convention.
@@ -239,7 +358,14 @@ private:
 /**
  * @brief Public macro for legacy checking with glGetError().
  * This will automatically capture the file and line number.
+ * Compiles to nothing below ENGENE_GL_CHECK_LEVEL 2; otherwise the message
+ * is only built when Error::shouldCheck() selects this checkpoint.
  */
-#define GL_CHECK(msg) Error::CheckInternal(msg, __FILE__, __LINE__)
+#if ENGENE_GL_CHECK_LEVEL >= 2
+    #define GL_CHECK(msg) \
+        do { if (Error::shouldCheck()) Error::CheckInternal(msg, __FILE__, __LINE__); } while (0)
+#else
+    #define GL_CHECK(msg) do { } while (0)
+#endif
 
 #endif // ERROR_H
\ No newline at end of file
@@ -0,0 +1,183 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @file frame_stats.h
+ * @brief Per-frame render counters and their rolling statistics
+ *
+ * Subsystems increment stats::current() as they issue work; EnGene closes the
+ * frame with stats::history().nextFrame(), which stores the counters in a
+ * rolling window and resets them.
+ */
+
+namespace stats {
+
+/**
+ * @struct FrameStats
+ * @brief Work submitted during one frame
+ */
+struct FrameStats {
+    uint64_t draw_calls = 0;        ///< glDraw* calls
+    uint64_t indices = 0;           ///< Indices (or vertices for array draws) submitted
+    uint64_t program_switches = 0;  ///< Program changes made by ShaderStack::top()
+    uint64_t texture_binds = 0;     ///< Binds and unbinds issued by TextureStack
+    uint64_t fbo_binds = 0;         ///< Framebuffer binds issued by FramebufferStack
+    uint64_t state_syncs = 0;       ///< FramebufferStack stencil/blend/depth syncs
+    uint64_t uniform_uploads = 0;   ///< glUniform* calls from the shader uniform tiers
+    uint64_t ubo_bytes = 0;         ///< Bytes uploaded by StructResource::apply() and the light selection stream
+    uint64_t nodes_visited = 0;     ///< Scene nodes applied during drawing
+    uint64_t nodes_culled = 0;      ///< Scene nodes skipped (subtree not applicable)
+};
+
+/**
+ * @struct Summary
+ * @brief Rolling statistics of one counter
+ */
+struct Summary {
+    double min = 0.0;
+    double avg = 0.0;
+    double max = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+};
+
+/**
+ * @brief Counters of the frame being recorded
+ */
+inline FrameStats& current() {
+    static FrameStats instance;
+    return instance;
+}
+
+/**
+ * @class FrameStatsHistory
+ * @brief Rolling window of the last N finished frames
+ *
+ * Usage:
+ * @code
+ * stats::history().setFrameCallback([](const stats::FrameStats& frame) {
+ *     if (frame.draw_calls > 5000) std::cout << "Draw call budget exceeded" << std::endl;
+ * });
+ *
+ * // After app.run()
+ * auto draws = stats::history().summarize(&stats::FrameStats::draw_calls);
+ * std::cout << draws.avg << " avg, " << draws.p99 << " p99" << std::endl;
+ * @endcode
+ */
+class FrameStatsHistory {
+public:
+    using Counter = uint64_t FrameStats::*;
+    using FrameCallback = std::function<void(const FrameStats&)>;
+
+private:
+    std::vector<FrameStats> m_window;
+    size_t m_next = 0;
+    size_t m_count = 0;
+    uint64_t m_total_frames = 0;
+    FrameStats m_last;
+    FrameCallback m_callback;
+    mutable std::vector<uint64_t> m_scratch;  ///< Reused by summarize()
+
+    FrameStatsHistory() {
+        setWindowSize(120);
+    }
+
+    friend FrameStatsHistory& history();
+
+public:
+    FrameStatsHistory(const FrameStatsHistory&) = delete;
+    FrameStatsHistory& operator=(const FrameStatsHistory&) = delete;
+
+    /** @brief Sets how many frames the rolling statistics cover (clears the window) */
+    void setWindowSize(size_t frames) {
+        m_window.assign(frames > 0 ? frames : 1, FrameStats());
+        m_scratch.reserve(m_window.size());
+        m_next = 0;
+        m_count = 0;
+    }
+
+    /** @brief Gets the rolling window size */
+    size_t getWindowSize() const { return m_window.size(); }
+
+    /** @brief Called with the counters of every finished frame (nullptr to remove) */
+    void setFrameCallback(FrameCallback callback) { m_callback = std::move(callback); }
+
+    /**
+     * @brief Ends the frame: stores current() in the window, runs the callback and resets current()
+     * @note Called by EnGene after every frame.
+     */
+    void nextFrame() {
+        m_last = current();
+        m_window[m_next] = m_last;
+        m_next = (m_next + 1) % m_window.size();
+        m_count = std::min(m_count + 1, m_window.size());
+        ++m_total_frames;
+        current() = FrameStats();
+
+        if (m_callback) {
+            m_callback(m_last);
+        }
+    }
+
+    /** @brief Counters of the last finished frame */
+    const FrameStats& getLast() const { return m_last; }
+
+    /** @brief Number of frames currently in the window */
+    size_t getFrameCount() const { return m_count; }
+
+    /** @brief Number of frames finished since startup */
+    uint64_t getTotalFrames() const { return m_total_frames; }
+
+    /**
+     * @brief Computes min/avg/max and percentiles (nearest sample) of a counter over the window
+     * @param counter Member to summarize, e.g. &stats::FrameStats::draw_calls
+     */
+    Summary summarize(Counter counter) const {
+        Summary summary;
+        if (m_count == 0) {
+            return summary;
+        }
+
+        m_scratch.clear();
+        for (size_t i = 0; i < m_count; ++i) {
+            m_scratch.push_back(m_window[i].*counter);
+        }
+        std::sort(m_scratch.begin(), m_scratch.end());
+
+        double sum = 0.0;
+        for (uint64_t value : m_scratch) {
+            sum += static_cast<double>(value);
+        }
+        auto rank = [this](double p) {
+            size_t index = static_cast<size_t>(p * static_cast<double>(m_scratch.size() - 1) + 0.5);
+            return static_cast<double>(m_scratch[index]);
+        };
+
+        summary.min = static_cast<double>(m_scratch.front());
+        summary.max = static_cast<double>(m_scratch.back());
+        summary.avg = sum / static_cast<double>(m_scratch.size());
+        summary.p50 = rank(0.50);
+        summary.p95 = rank(0.95);
+        summary.p99 = rank(0.99);
+        return summary;
+    }
+};
+
+/**
+ * @brief Gets the global rolling frame statistics.
+ */
+inline FrameStatsHistory& history() {
+    static FrameStatsHistory instance;
+    return instance;
+}
+
+} // namespace stats
+
+#endif // FRAME_STATS_H
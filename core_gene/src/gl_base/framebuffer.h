@@ -6,8 +6,11 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <functional>
+#include <iterator>
 #include "gl_includes.h"
 #include "error.h"
+#include "frame_stats.h"
 #include "../exceptions/framebuffer_exception.h"
 #include "texture.h"
 #include "shader.h"
@@ -27,9 +30,11 @@ namespace framebuffer {
 // Forward declarations
 class Framebuffer;
 class FramebufferStack;
+class FramebufferPool;
 
 using FramebufferPtr = std::shared_ptr<Framebuffer>;
 using FramebufferStackPtr = std::shared_ptr<FramebufferStack>;
+using FramebufferPoolPtr = std::shared_ptr<FramebufferPool>;
 
 /**
  * @namespace framebuffer::attachment
@@ -207,6 +212,32 @@ inline GLenum toGLTextureWrap(TextureWrap wrap) {
     }
 }
 
+/**
+ * @brief Approximate GPU storage cost of one pixel in the given format
+ * @param format The internal format enum value
+ * @return Size in bytes (drivers commonly pad RGB to RGBA and 24-bit depth to 32)
+ */
+inline size_t bytesPerPixel(Format format) {
+    switch (format) {
+        case Format::RGBA8: return 4;
+        case Format::RGB8: return 4;
+        case Format::RGBA16F: return 8;
+        case Format::RGBA32F: return 16;
+        case Format::RGB16F: return 8;
+        case Format::RGB32F: return 16;
+        case Format::R32I: return 4;
+        case Format::R32UI: return 4;
+        case Format::RG32UI: return 8;
+        case Format::DepthComponent16: return 2;
+        case Format::DepthComponent24: return 4;
+        case Format::DepthComponent32: return 4;
+        case Format::DepthComponent32F: return 4;
+        case Format::StencilIndex8: return 1;
+        case Format::Depth24Stencil8: return 4;
+        default: return 4;
+    }
+}
+
 } // namespace attachment
 
 /**
@@ -391,6 +422,24 @@ public:
               filter(filt),
               wrap(w),
               is_shadow_texture(is_shadow) {}
+        
+        bool operator==(const AttachmentSpec& other) const {
+            return point == other.point && format == other.format && storage == other.storage &&
+                   name == other.name && filter == other.filter && wrap == other.wrap &&
+                   is_shadow_texture == other.is_shadow_texture;
+        }
+    };
+
+    /**
+     * @struct SharedAttachment
+     * @brief An existing texture to attach instead of allocating a new one
+     * 
+     * @note The same texture may be attached to several framebuffers (see RenderGraph).
+     */
+    struct SharedAttachment {
+        attachment::Point point;       ///< Attachment point
+        std::string name;              ///< Name for getTexture() retrieval
+        texture::TexturePtr texture;   ///< Texture to attach (must match framebuffer size)
     };
 
 private:
@@ -408,6 +457,8 @@ private:
     
     // Friend declaration for FramebufferStack
     friend class FramebufferStack;
+    friend class FramebufferPool;
+    friend class Readback;
     
     /**
      * @brief Creates a texture attachment and attaches it to the framebuffer.
@@ -415,13 +466,46 @@ private:
      * @throws exception::FramebufferException if attachment creation fails
      */
     void createTextureAttachment(const AttachmentSpec& spec) {
+        texture::TexturePtr texture_ptr = allocateAttachmentTexture(m_width, m_height, spec);
+        attachTexture(spec.point, spec.name, texture_ptr);
+    }
+
+    /**
+     * @brief Attaches an already allocated texture to the bound framebuffer.
+     * @param point Attachment point
+     * @param name Name used for getTexture() retrieval
+     * @param texture_ptr The texture to attach
+     */
+    void attachTexture(attachment::Point point, const std::string& name, texture::TexturePtr texture_ptr) {
+        GLenum attachment_point = attachment::toGLAttachmentPoint(point);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment_point, GL_TEXTURE_2D, texture_ptr->GetTextureID(), 0);
+        GL_CHECK("attach texture to framebuffer");
+        
+        m_named_textures[name] = texture_ptr;
+        
+        // Track color attachments for glDrawBuffers
+        if (point >= attachment::Point::Color0 && point <= attachment::Point::Color7) {
+            m_color_attachments.push_back(attachment_point);
+        }
+    }
+
+public:
+    /**
+     * @brief Allocates a 2D texture suitable for use as a framebuffer attachment.
+     * @param width Texture width in pixels
+     * @param height Texture height in pixels
+     * @param spec Format, filter, wrap and shadow settings (point and storage are ignored)
+     * @throws exception::FramebufferException if the format is unsupported
+     * @note Used by RenderGraph to create attachments shared by several FBOs
+     */
+    static texture::TexturePtr allocateAttachmentTexture(int width, int height, const AttachmentSpec& spec) {
         // Generate texture ID
         GLuint texture_id;
         glGenTextures(1, &texture_id);
         GL_CHECK("generate texture for FBO attachment");
         
         // Bind and configure texture
-        glBindTexture(GL_TEXTURE_2D, texture_id);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, texture_id);
         GL_CHECK("bind texture for FBO attachment");
         
         // Set texture parameters from spec
@@ -498,27 +582,17 @@ private:
         }
         
         // Allocate texture storage
-        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, m_width, m_height, 0, 
+        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, 
                      pixel_format, pixel_type, nullptr);
         GL_CHECK("allocate texture storage for FBO attachment");
         
-        // Attach texture to framebuffer
-        GLenum attachment_point = attachment::toGLAttachmentPoint(spec.point);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment_point, GL_TEXTURE_2D, texture_id, 0);
-        GL_CHECK("attach texture to framebuffer");
-        
         // Unbind texture
-        glBindTexture(GL_TEXTURE_2D, 0);
-        
-        // Create Texture object and store in map
-        texture::TexturePtr texture_ptr(new texture::Texture(texture_id, m_width, m_height));
-        m_named_textures[spec.name] = texture_ptr;
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, 0);
         
-        // Track color attachments for glDrawBuffers
-        if (spec.point >= attachment::Point::Color0 && spec.point <= attachment::Point::Color7) {
-            m_color_attachments.push_back(attachment_point);
-        }
+        return texture::TexturePtr(new texture::Texture(texture_id, width, height));
     }
+
+private:
     
     /**
      * @brief Creates a renderbuffer attachment and attaches it to the framebuffer.
@@ -639,6 +713,50 @@ protected:
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
+    /**
+     * @brief Protected constructor for framebuffers over existing textures.
+     * @param width Framebuffer width in pixels
+     * @param height Framebuffer height in pixels
+     * @param attachments Textures to attach
+     * @throws exception::FramebufferException if framebuffer creation or validation fails
+     */
+    Framebuffer(int width, int height, const std::vector<SharedAttachment>& attachments)
+        : m_fbo_id(0), m_width(width), m_height(height), m_clear_on_bind(true), 
+          m_has_depth(false), m_has_stencil(false) {
+        
+        for (const auto& shared : attachments) {
+            if (shared.point == attachment::Point::Depth) {
+                m_has_depth = true;
+            } else if (shared.point == attachment::Point::Stencil) {
+                m_has_stencil = true;
+            } else if (shared.point == attachment::Point::DepthStencil) {
+                m_has_depth = true;
+                m_has_stencil = true;
+            }
+        }
+        
+        glGenFramebuffers(1, &m_fbo_id);
+        GL_CHECK("generate framebuffer");
+        
+        if (m_fbo_id == 0) {
+            throw exception::FramebufferException("Failed to generate framebuffer object");
+        }
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo_id);
+        GL_CHECK("bind framebuffer for configuration");
+        
+        for (const auto& shared : attachments) {
+            if (!shared.texture) {
+                throw exception::FramebufferException("Shared attachment '" + shared.name + "' has no texture");
+            }
+            attachTexture(shared.point, shared.name, shared.texture);
+        }
+        
+        validateCompleteness();
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
 public:
     /**
      * @brief Destructor - automatically cleans up OpenGL resources.
@@ -710,10 +828,18 @@ public:
     /**
      * @brief Factory method for custom framebuffer configuration
      * @throws exception::FramebufferException if creation fails
+     * @note Recycles an idle framebuffer from the FramebufferPool when pooling is enabled
      */
     static FramebufferPtr Make(int width, int height, 
-                                const std::vector<AttachmentSpec>& specs) {
-        return FramebufferPtr(new Framebuffer(width, height, specs));
+                                const std::vector<AttachmentSpec>& specs);
+    
+    /**
+     * @brief Factory for a framebuffer over existing textures (no new storage allocated)
+     * @throws exception::FramebufferException if creation fails
+     */
+    static FramebufferPtr MakeFromTextures(int width, int height,
+                                           const std::vector<SharedAttachment>& attachments) {
+        return FramebufferPtr(new Framebuffer(width, height, attachments));
     }
     
     /**
@@ -801,6 +927,37 @@ public:
         return Make(width, height, specs);
     }
     
+    /**
+     * @brief Factory for G-Buffer with per-target formats and a readable depth texture
+     * @param colorTargets (texture name, format) per color attachment, in attachment order
+     * @param depthTextureName Name of the depth texture (for position reconstruction)
+     * @throws exception::FramebufferException if creation fails
+     * @note Maximum 8 color attachments (OpenGL 4.3 guarantee)
+     */
+    static FramebufferPtr MakeGBuffer(
+        int width, int height,
+        const std::vector<std::pair<std::string, attachment::Format>>& colorTargets,
+        const std::string& depthTextureName,
+        attachment::Format depthFormat = attachment::Format::DepthComponent24) {
+        
+        std::vector<AttachmentSpec> specs;
+        
+        for (size_t i = 0; i < colorTargets.size() && i < 8; ++i) {
+            attachment::Point point = static_cast<attachment::Point>(
+                static_cast<int>(attachment::Point::Color0) + i);
+            specs.push_back(AttachmentSpec(point, colorTargets[i].second,
+                                          attachment::StorageType::Texture,
+                                          colorTargets[i].first,
+                                          attachment::TextureFilter::Nearest));
+        }
+        
+        specs.push_back(AttachmentSpec(attachment::Point::Depth, depthFormat,
+                                      attachment::StorageType::Texture, depthTextureName,
+                                      attachment::TextureFilter::Nearest));
+        
+        return Make(width, height, specs);
+    }
+    
     /**
      * @brief Binds framebuffer (internal use by FramebufferStack)
      * @note Use framebuffer::stack()->push() instead
@@ -1250,6 +1407,7 @@ private:
     GLuint m_currently_bound_fbo;
     int m_current_viewport_width;
     int m_current_viewport_height;
+    FramebufferPtr m_default_target;  ///< Stands in for the window framebuffer (headless mode)
     
     // GPU state caching for stencil, blend, and depth (NEW)
     StencilState m_gpu_stencil_state;  ///< Cached GPU stencil state
@@ -1287,6 +1445,37 @@ private:
         m_gpu_depth_state = DepthState();
     }
     
+    /** @brief ID bound for the default framebuffer (0 unless a default target is set) */
+    GLuint defaultFramebufferId() const {
+        return m_default_target ? m_default_target->getID() : 0;
+    }
+    
+    /** @brief Fills viewport and draw buffers of a state representing the default framebuffer */
+    void describeDefault(FramebufferState& state) const {
+        getDefaultSize(state.viewport_width, state.viewport_height);
+        if (m_default_target) {
+            state.draw_buffers = m_default_target->m_color_attachments;  // Access via friend
+        } else {
+            state.draw_buffers = { GL_BACK };
+        }
+    }
+    
+    /** @brief Selects the draw buffers of a state after its framebuffer was bound */
+    void applyDrawBuffers(const FramebufferState& state) const {
+        if (state.fbo == nullptr && !m_default_target) {
+            glDrawBuffer(GL_BACK);
+            GL_CHECK("set default draw buffer");
+        } else if (state.draw_buffers.empty()) {
+            // Depth-only FBO (e.g., shadow map)
+            glDrawBuffer(GL_NONE);
+            GL_CHECK("set draw buffer to none");
+        } else {
+            // Color attachments present
+            glDrawBuffers(static_cast<GLsizei>(state.draw_buffers.size()), state.draw_buffers.data());
+            GL_CHECK("set draw buffers");
+        }
+    }
+    
     /**
      * @brief Synchronizes GPU state to match target framebuffer state
      * @param target_state The desired state to synchronize to
@@ -1841,6 +2030,45 @@ public:
         return DepthManager(this);
     }
     
+    /**
+     * @brief Replaces the window framebuffer with an offscreen target
+     * @param target Framebuffer used wherever the default framebuffer (nullptr) is pushed,
+     *               or nullptr to return to the window framebuffer
+     * @note Used by headless EnGene; rebinds immediately when only the base state is active
+     */
+    void setDefaultTarget(FramebufferPtr target) {
+        m_default_target = target;
+        if (m_stack.size() == 1) {
+            describeDefault(m_stack.back());
+            glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferId());
+            GL_CHECK("bind default target");
+            m_currently_bound_fbo = defaultFramebufferId();
+            glViewport(0, 0, m_stack.back().viewport_width, m_stack.back().viewport_height);
+            GL_CHECK("set default target viewport");
+            m_current_viewport_width = m_stack.back().viewport_width;
+            m_current_viewport_height = m_stack.back().viewport_height;
+            applyDrawBuffers(m_stack.back());
+        }
+    }
+    
+    /** @brief Returns the offscreen default target (nullptr when rendering to a window) */
+    FramebufferPtr getDefaultTarget() const {
+        return m_default_target;
+    }
+    
+    /**
+     * @brief Queries the size of the default framebuffer
+     * @note Window framebuffer size from GLFW, or the default target size if one is set
+     */
+    void getDefaultSize(int& width, int& height) const {
+        if (m_default_target) {
+            width = m_default_target->getWidth();
+            height = m_default_target->getHeight();
+        } else {
+            glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
+        }
+    }
+    
     // Delete copy constructor and assignment operator (singleton)
     FramebufferStack(const FramebufferStack&) = delete;
     FramebufferStack& operator=(const FramebufferStack&) = delete;
@@ -1904,14 +2132,8 @@ inline void FramebufferStack::push(FramebufferPtr fbo) {
     
     // Set viewport and draw buffers based on FBO type
     if (is_default_fbo) {
-        // Query window size from GLFW for default framebuffer
-        GLFWwindow* window = glfwGetCurrentContext();
-        int window_width, window_height;
-        glfwGetFramebufferSize(window, &window_width, &window_height);
-        
-        state.viewport_width = window_width;
-        state.viewport_height = window_height;
-        state.draw_buffers = { GL_BACK };
+        // Window size from GLFW, or the headless default target
+        describeDefault(state);
     } else {
         // Use FBO dimensions and color attachments
         state.viewport_width = fbo->getWidth();
@@ -1927,17 +2149,18 @@ inline void FramebufferStack::push(FramebufferPtr fbo) {
     m_stack.push_back(state);
     
     // Determine target FBO ID
-    GLuint target_fbo_id = is_default_fbo ? 0 : fbo->getID();
+    GLuint target_fbo_id = is_default_fbo ? defaultFramebufferId() : fbo->getID();
     
     // Bind FBO (with optimization - only bind if changed)
     if (m_currently_bound_fbo != target_fbo_id) {
         if (is_default_fbo) {
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, target_fbo_id);
             GL_CHECK("bind default framebuffer");
         } else {
             fbo->bind();
         }
         m_currently_bound_fbo = target_fbo_id;
+        ++stats::current().fbo_binds;
     }
     
     // Set viewport (with optimization - only update if dimensions changed)
@@ -1950,18 +2173,7 @@ inline void FramebufferStack::push(FramebufferPtr fbo) {
     }
     
     // Configure draw buffers
-    if (is_default_fbo) {
-        glDrawBuffer(GL_BACK);
-        GL_CHECK("set default draw buffer");
-    } else if (state.draw_buffers.empty()) {
-        // Depth-only FBO (e.g., shadow map)
-        glDrawBuffer(GL_NONE);
-        GL_CHECK("set draw buffer to none");
-    } else {
-        // Color attachments present
-        glDrawBuffers(static_cast<GLsizei>(state.draw_buffers.size()), state.draw_buffers.data());
-        GL_CHECK("set draw buffers");
-    }
+    applyDrawBuffers(m_stack.back());
     
     // CRITICAL: Do NOT call syncGpuToState() in inherit mode
     // State is logically identical to previous level, no GPU state changes needed
@@ -1981,14 +2193,8 @@ inline void FramebufferStack::push(FramebufferPtr fbo, RenderStatePtr state_to_a
     
     // Set viewport and draw buffers based on FBO type
     if (is_default_fbo) {
-        // Query window size from GLFW for default framebuffer
-        GLFWwindow* window = glfwGetCurrentContext();
-        int window_width, window_height;
-        glfwGetFramebufferSize(window, &window_width, &window_height);
-        
-        state.viewport_width = window_width;
-        state.viewport_height = window_height;
-        state.draw_buffers = { GL_BACK };
+        // Window size from GLFW, or the headless default target
+        describeDefault(state);
     } else {
         // Use FBO dimensions and color attachments
         state.viewport_width = fbo->getWidth();
@@ -2004,17 +2210,18 @@ inline void FramebufferStack::push(FramebufferPtr fbo, RenderStatePtr state_to_a
     m_stack.push_back(state);
     
     // Determine target FBO ID
-    GLuint target_fbo_id = is_default_fbo ? 0 : fbo->getID();
+    GLuint target_fbo_id = is_default_fbo ? defaultFramebufferId() : fbo->getID();
     
     // Bind FBO (with optimization - only bind if changed)
     if (m_currently_bound_fbo != target_fbo_id) {
         if (is_default_fbo) {
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, target_fbo_id);
             GL_CHECK("bind default framebuffer");
         } else {
             fbo->bind();
         }
         m_currently_bound_fbo = target_fbo_id;
+        ++stats::current().fbo_binds;
     }
     
     // Set viewport (with optimization - only update if dimensions changed)
@@ -2027,18 +2234,7 @@ inline void FramebufferStack::push(FramebufferPtr fbo, RenderStatePtr state_to_a
     }
     
     // Configure draw buffers
-    if (is_default_fbo) {
-        glDrawBuffer(GL_BACK);
-        GL_CHECK("set default draw buffer");
-    } else if (state.draw_buffers.empty()) {
-        // Depth-only FBO (e.g., shadow map)
-        glDrawBuffer(GL_NONE);
-        GL_CHECK("set draw buffer to none");
-    } else {
-        // Color attachments present
-        glDrawBuffers(static_cast<GLsizei>(state.draw_buffers.size()), state.draw_buffers.data());
-        GL_CHECK("set draw buffers");
-    }
+    applyDrawBuffers(m_stack.back());
     
     // CRITICAL: Call syncGpuToState() to apply the new state atomically
     syncGpuToState(m_stack.back());
@@ -2056,30 +2252,28 @@ inline void FramebufferStack::pop() {
     
     // Restore framebuffer
     if (state_to_restore.fbo == nullptr) {
-        // Restore default framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        // Restore default framebuffer (window or headless default target)
+        glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferId());
         GL_CHECK("restore default framebuffer");
-        m_currently_bound_fbo = 0;
+        m_currently_bound_fbo = defaultFramebufferId();
+        ++stats::current().fbo_binds;
         
-        // Query window size from GLFW
-        GLFWwindow* window = glfwGetCurrentContext();
         int window_width, window_height;
-        glfwGetFramebufferSize(window, &window_width, &window_height);
+        getDefaultSize(window_width, window_height);
         
         glViewport(0, 0, window_width, window_height);
         GL_CHECK("restore window viewport");
         m_current_viewport_width = window_width;
         m_current_viewport_height = window_height;
         
-        // Restore default draw buffer
-        // For default framebuffer, use glDrawBuffer (singular) with GL_BACK
-        glDrawBuffer(GL_BACK);
-        GL_CHECK("restore default draw buffer");
+        // Restore default draw buffer (GL_BACK for the window)
+        applyDrawBuffers(state_to_restore);
     } else {
         // Restore previous FBO
         if (m_currently_bound_fbo != state_to_restore.fbo->getID()) {
             state_to_restore.fbo->bind();
             m_currently_bound_fbo = state_to_restore.fbo->getID();
+            ++stats::current().fbo_binds;
         }
         
         if (m_current_viewport_width != state_to_restore.viewport_width ||
@@ -2105,6 +2299,8 @@ inline void FramebufferStack::pop() {
 }
 
 inline void FramebufferStack::syncGpuToState(const FramebufferState& target_state) {
+    ++stats::current().state_syncs;
+
     // ========== Sync Stencil State ==========
     const StencilState& target_stencil = target_state.stencil_state;
     
@@ -2282,6 +2478,191 @@ inline FramebufferStackPtr stack() {
     return instance;
 }
 
+/**
+ * @class FramebufferPool
+ * @brief Recycles framebuffers keyed by (width, height, attachment specs)
+ * 
+ * A pooled framebuffer is idle once nothing outside the pool references it
+ * or any of its textures. acquire() hands back an idle framebuffer with an
+ * identical key instead of creating a new one. Framebuffers idle for more
+ * than the configured number of frames are released.
+ * 
+ * @note Disabled by default. When enabled, all Framebuffer::Make* factories draw from it.
+ * @note EnGene::run() advances the pool once per frame via nextFrame().
+ */
+class FramebufferPool {
+public:
+    /**
+     * @struct Stats
+     * @brief Pool usage counters
+     */
+    struct Stats {
+        size_t hits = 0;            ///< acquire() calls served by a recycled framebuffer
+        size_t misses = 0;          ///< acquire() calls that created a framebuffer
+        size_t evictions = 0;       ///< Framebuffers released after going idle
+        size_t entries = 0;         ///< Framebuffers currently owned by the pool
+        size_t resident_bytes = 0;  ///< Approximate GPU memory of owned framebuffers
+        
+        /** @brief Fraction of acquire() calls served from the pool */
+        float hitRate() const {
+            size_t total = hits + misses;
+            return total ? static_cast<float>(hits) / static_cast<float>(total) : 0.0f;
+        }
+    };
+
+private:
+    struct Entry {
+        int width;
+        int height;
+        std::vector<Framebuffer::AttachmentSpec> specs;
+        FramebufferPtr fbo;
+        size_t bytes;
+        unsigned long long last_used_frame;
+    };
+    
+    std::unordered_map<size_t, std::vector<Entry>> m_buckets;
+    unsigned long long m_frame = 0;
+    unsigned int m_max_idle_frames = 120;
+    bool m_enabled = false;
+    Stats m_stats;
+    
+    FramebufferPool() = default;
+    friend FramebufferPoolPtr pool();
+    
+    static size_t hashKey(int width, int height, const std::vector<Framebuffer::AttachmentSpec>& specs) {
+        size_t seed = std::hash<int>()(width);
+        auto combine = [&seed](size_t value) {
+            seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        };
+        combine(std::hash<int>()(height));
+        for (const auto& spec : specs) {
+            combine(static_cast<size_t>(spec.point));
+            combine(static_cast<size_t>(spec.format));
+            combine(static_cast<size_t>(spec.storage));
+            combine(std::hash<std::string>()(spec.name));
+            combine(static_cast<size_t>(spec.filter));
+            combine(static_cast<size_t>(spec.wrap));
+            combine(static_cast<size_t>(spec.is_shadow_texture));
+        }
+        return seed;
+    }
+    
+    /** @brief True if no one outside the pool holds the framebuffer or its textures */
+    static bool isIdle(const Entry& entry) {
+        if (entry.fbo.use_count() > 1) return false;
+        for (const auto& pair : entry.fbo->m_named_textures) {
+            if (pair.second.use_count() > 1) return false;
+        }
+        return true;
+    }
+    
+    static size_t computeBytes(int width, int height, const std::vector<Framebuffer::AttachmentSpec>& specs) {
+        size_t bytes = 0;
+        for (const auto& spec : specs) {
+            bytes += static_cast<size_t>(width) * static_cast<size_t>(height) * attachment::bytesPerPixel(spec.format);
+        }
+        return bytes;
+    }
+
+public:
+    FramebufferPool(const FramebufferPool&) = delete;
+    FramebufferPool& operator=(const FramebufferPool&) = delete;
+    
+    /**
+     * @brief Returns an idle framebuffer with this exact configuration, or creates one
+     * @throws exception::FramebufferException if creation fails
+     * @note Recycled framebuffers are reset to clear-on-bind
+     */
+    FramebufferPtr acquire(int width, int height, const std::vector<Framebuffer::AttachmentSpec>& specs) {
+        size_t key = hashKey(width, height, specs);
+        auto& bucket = m_buckets[key];
+        
+        for (auto& entry : bucket) {
+            if (entry.width == width && entry.height == height && entry.specs == specs && isIdle(entry)) {
+                entry.last_used_frame = m_frame;
+                entry.fbo->setClearOnBind(true);
+                m_stats.hits++;
+                return entry.fbo;
+            }
+        }
+        
+        FramebufferPtr fbo(new Framebuffer(width, height, specs));
+        size_t bytes = computeBytes(width, height, specs);
+        bucket.push_back(Entry{width, height, specs, fbo, bytes, m_frame});
+        m_stats.misses++;
+        m_stats.entries++;
+        m_stats.resident_bytes += bytes;
+        return fbo;
+    }
+    
+    /**
+     * @brief Advances the frame counter and releases framebuffers idle for too long
+     */
+    void nextFrame() {
+        m_frame++;
+        for (auto bucket_it = m_buckets.begin(); bucket_it != m_buckets.end(); ) {
+            auto& bucket = bucket_it->second;
+            for (auto it = bucket.begin(); it != bucket.end(); ) {
+                if (!isIdle(*it)) {
+                    it->last_used_frame = m_frame;
+                    ++it;
+                } else if (m_frame - it->last_used_frame > m_max_idle_frames) {
+                    m_stats.evictions++;
+                    m_stats.entries--;
+                    m_stats.resident_bytes -= it->bytes;
+                    it = bucket.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            bucket_it = bucket.empty() ? m_buckets.erase(bucket_it) : std::next(bucket_it);
+        }
+    }
+    
+    /** @brief Releases every idle framebuffer immediately */
+    void releaseIdle() {
+        unsigned int max_idle = m_max_idle_frames;
+        m_max_idle_frames = 0;
+        nextFrame();
+        m_max_idle_frames = max_idle;
+    }
+    
+    /** @brief Routes Framebuffer::Make* factories through the pool (default: false) */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    
+    /** @brief Checks whether the factories draw from the pool */
+    bool isEnabled() const { return m_enabled; }
+    
+    /** @brief Sets how many frames a framebuffer may stay idle before release (default: 120) */
+    void setMaxIdleFrames(unsigned int frames) { m_max_idle_frames = frames; }
+    
+    /** @brief Gets the usage counters */
+    const Stats& getStats() const { return m_stats; }
+    
+    /** @brief Resets hit/miss/eviction counters (entries and resident bytes are kept) */
+    void resetStats() {
+        m_stats.hits = 0;
+        m_stats.misses = 0;
+        m_stats.evictions = 0;
+    }
+};
+
+/**
+ * @brief Singleton accessor for FramebufferPool (Meyers pattern)
+ */
+inline FramebufferPoolPtr pool() {
+    static FramebufferPoolPtr instance = FramebufferPoolPtr(new FramebufferPool());
+    return instance;
+}
+
+inline FramebufferPtr Framebuffer::Make(int width, int height, 
+                                        const std::vector<AttachmentSpec>& specs) {
+    if (pool()->isEnabled()) {
+        return pool()->acquire(width, height, specs);
+    }
+    return FramebufferPtr(new Framebuffer(width, height, specs));
+}
+
 } // namespace framebuffer
 
 #endif // FRAMEBUFFER_H
@@ -4,9 +4,14 @@
 
 #include "gl_includes.h"
 #include "shader.h"
+#include "gl_state.h"
+#include "frame_stats.h"
 
 #include <memory>
 #include <vector>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
 
 
 namespace geometry {
@@ -24,6 +29,32 @@ class Geometry {
     unsigned int m_vbo;
     unsigned int m_ebo; 
     int n_indices;
+    glm::vec3 m_bounds_center = glm::vec3(0.0f);
+    float m_bounds_radius = 0.0f;
+
+    // Esfera envolvente em espaço de modelo (centro da AABB + maior distância)
+    void computeBounds(const float* dados_vertices, int nverts, int pos_size, int stride_in_floats) {
+        if (!dados_vertices || nverts <= 0) return;
+        int dims = pos_size < 3 ? pos_size : 3;
+
+        glm::vec3 min_p(0.0f), max_p(0.0f);
+        for (int v = 0; v < nverts; ++v) {
+            glm::vec3 p(0.0f);
+            for (int c = 0; c < dims; ++c) p[c] = dados_vertices[v * stride_in_floats + c];
+            min_p = (v == 0) ? p : glm::min(min_p, p);
+            max_p = (v == 0) ? p : glm::max(max_p, p);
+        }
+        m_bounds_center = (min_p + max_p) * 0.5f;
+
+        float max_dist2 = 0.0f;
+        for (int v = 0; v < nverts; ++v) {
+            glm::vec3 p(0.0f);
+            for (int c = 0; c < dims; ++c) p[c] = dados_vertices[v * stride_in_floats + c];
+            glm::vec3 d = p - m_bounds_center;
+            max_dist2 = std::max(max_dist2, glm::dot(d, d));
+        }
+        m_bounds_radius = std::sqrt(max_dist2);
+    }
 
 protected:
     // Construtor agora armazena vbo e ebo
@@ -39,14 +70,15 @@ protected:
         int amt_of_floats_per_vertex = pos_size;
         for (int sz : attr_sizes) amt_of_floats_per_vertex += sz;
         int vertex_stride_in_bytes = amt_of_floats_per_vertex * sizeof(float);
+        computeBounds(dados_vertices, nverts, pos_size, amt_of_floats_per_vertex);
 
         // 1. Geração e bind do VAO
         glGenVertexArrays(1, &m_vao);
-        glBindVertexArray(m_vao);
+        gl_state::cache()->bindVertexArray(m_vao);
 
         // 2. Geração, bind e envio de dados para o VBO
         glGenBuffers(1, &m_vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        gl_state::cache()->bindBuffer(GL_ARRAY_BUFFER, m_vbo);
         glBufferData(GL_ARRAY_BUFFER, amt_of_floats_per_vertex * nverts * sizeof(float), dados_vertices, GL_STATIC_DRAW);
 
         // 3. Configuração dos atributos dos vértices
@@ -71,9 +103,8 @@ protected:
         
         // 5. Unbind de tudo para evitar modificações acidentais
         // O VAO "lembra" dos binds do VBO e EBO, então podemos desvinculá-los.
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        gl_state::cache()->bindVertexArray(0);
+        gl_state::cache()->bindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
 public:
@@ -88,14 +119,23 @@ public:
         glDeleteBuffers(1, &m_vbo);
         glDeleteBuffers(1, &m_ebo);
         glDeleteVertexArrays(1, &m_vao);
+        gl_state::cache()->onBufferDeleted(m_vbo);
+        gl_state::cache()->onBufferDeleted(m_ebo);
+        gl_state::cache()->onVertexArrayDeleted(m_vao);
     }
 
+    // Esfera envolvente em espaço de modelo, usada pela seleção de luzes por objeto
+    const glm::vec3& getBoundsCenter() const { return m_bounds_center; }
+    float getBoundsRadius() const { return m_bounds_radius; }
+
     // Função de desenho
     virtual void Draw() {
-        glBindVertexArray(m_vao);
+        // O VAO permanece vinculado; o cache de estado evita o rebind no próximo Draw
+        gl_state::cache()->bindVertexArray(m_vao);
         // Desenha índices (3*(nverts-2))
         glDrawElements(mode, n_indices, type, (void*)0);
-        glBindVertexArray(0);
+        ++stats::current().draw_calls;
+        stats::current().indices += n_indices;
     }
 };
 
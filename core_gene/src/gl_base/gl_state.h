@@ -0,0 +1,478 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include "gl_includes.h"
+#include "error.h"
+
+namespace gl_state {
+
+class StateCache;
+using StateCachePtr = std::shared_ptr<StateCache>;
+
+/**
+ * @class StateCache
+ * @brief Central shadow copy of the GL binding state touched by EnGene.
+ *
+ * Every VAO, program, texture, buffer and clip distance change made by the
+ * library goes through this cache. A call whose target state already matches
+ * the cache is skipped, so redundant binds never reach the driver.
+ * FBO, viewport and stencil/blend/depth state remain owned by FramebufferStack.
+ *
+ * Invariants:
+ * - GL objects must be released through the matching on*Deleted() notification,
+ *   since deleting a bound object implicitly rebinds 0 on the GPU.
+ * - Code that changes these bindings behind the cache's back must call
+ *   invalidate() afterwards.
+ *
+ * Usage:
+ * @code
+ * gl_state::cache()->bindVertexArray(vao);
+ * gl_state::cache()->bindTexture(0, GL_TEXTURE_2D, tex_id);
+ *
+ * // Debug builds: compare every cached call against glGet*
+ * gl_state::cache()->setValidation(true);
+ *
+ * const auto& stats = gl_state::cache()->getStats();  // Previous frame
+ * @endcode
+ */
+class StateCache {
+public:
+    /**
+     * @struct Stats
+     * @brief Per-frame counters of state-changing calls
+     */
+    struct Stats {
+        size_t issued = 0;   ///< Calls forwarded to OpenGL
+        size_t skipped = 0;  ///< Calls dropped because the state already matched
+
+        /** @brief Fraction of state calls that were redundant */
+        float skipRate() const {
+            size_t total = issued + skipped;
+            return total ? static_cast<float>(skipped) / static_cast<float>(total) : 0.0f;
+        }
+    };
+
+private:
+    /// Marks a binding whose GPU value is not known; the next bind is always issued.
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+    static constexpr int MAX_CLIP_DISTANCES = 8;
+    static constexpr signed char CLIP_UNKNOWN = -1;
+
+    struct TextureUnit {
+        std::vector<std::pair<GLenum, GLuint>> bindings;  ///< (target, texture) pairs
+    };
+
+    GLuint m_vertex_array = 0;
+    GLuint m_program = 0;
+    GLuint m_active_unit = 0;
+    std::vector<TextureUnit> m_units;
+    std::unordered_map<GLenum, GLuint> m_buffers;
+    std::unordered_map<GLenum, std::vector<GLuint>> m_indexed_buffers;
+    signed char m_clip_distances[MAX_CLIP_DISTANCES] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    Stats m_frame_stats;
+    Stats m_last_frame_stats;
+    bool m_validate = false;
+
+    StateCache() = default;
+    friend StateCachePtr cache();
+
+    bool record(bool changed) {
+        if (changed) {
+            m_frame_stats.issued++;
+        } else {
+            m_frame_stats.skipped++;
+        }
+        return changed;
+    }
+
+    GLuint& textureSlot(GLuint unit, GLenum target) {
+        if (unit >= m_units.size()) {
+            m_units.resize(unit + 1);
+        }
+        auto& bindings = m_units[unit].bindings;
+        for (auto& binding : bindings) {
+            if (binding.first == target) return binding.second;
+        }
+        // Unseen target on this unit: GL default is 0 unless the cache was invalidated
+        bindings.emplace_back(target, 0);
+        return bindings.back().second;
+    }
+
+    GLuint& indexedSlot(GLenum target, GLuint index) {
+        auto& slots = m_indexed_buffers[target];
+        if (index >= slots.size()) {
+            slots.resize(index + 1, 0);
+        }
+        return slots[index];
+    }
+
+    static GLenum textureBindingQuery(GLenum target) {
+        switch (target) {
+            case GL_TEXTURE_2D:       return GL_TEXTURE_BINDING_2D;
+            case GL_TEXTURE_CUBE_MAP: return GL_TEXTURE_BINDING_CUBE_MAP;
+            default:                  return 0;
+        }
+    }
+
+    static GLenum bufferBindingQuery(GLenum target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER:          return GL_ARRAY_BUFFER_BINDING;
+            case GL_UNIFORM_BUFFER:        return GL_UNIFORM_BUFFER_BINDING;
+            case GL_SHADER_STORAGE_BUFFER: return GL_SHADER_STORAGE_BUFFER_BINDING;
+            case GL_PIXEL_PACK_BUFFER:     return GL_PIXEL_PACK_BUFFER_BINDING;
+            case GL_PIXEL_UNPACK_BUFFER:   return GL_PIXEL_UNPACK_BUFFER_BINDING;
+            default:                       return 0;
+        }
+    }
+
+    static bool reportMismatch(const char* what, GLuint cached, GLint actual) {
+        if (cached == UNKNOWN || static_cast<GLint>(cached) == actual) {
+            return true;
+        }
+        std::cerr << "Warning: GL state cache mismatch for " << what
+                  << " (cached " << cached << ", GPU " << actual << ")" << std::endl;
+        return false;
+    }
+
+    bool checkVertexArray() const {
+        GLint actual = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &actual);
+        return reportMismatch("vertex array", m_vertex_array, actual);
+    }
+
+    bool checkProgram() const {
+        GLint actual = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &actual);
+        return reportMismatch("program", m_program, actual);
+    }
+
+    bool checkActiveUnit() const {
+        GLint actual = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &actual);
+        GLuint cached = (m_active_unit == UNKNOWN) ? UNKNOWN : GL_TEXTURE0 + m_active_unit;
+        return reportMismatch("active texture unit", cached, actual);
+    }
+
+    /// Checks bindings of the currently active unit (no unit switching).
+    bool checkActiveUnitTexture(GLenum target) const {
+        GLenum query = textureBindingQuery(target);
+        if (query == 0 || m_active_unit == UNKNOWN || m_active_unit >= m_units.size()) {
+            return true;
+        }
+        for (const auto& binding : m_units[m_active_unit].bindings) {
+            if (binding.first == target) {
+                GLint actual = 0;
+                glGetIntegerv(query, &actual);
+                return reportMismatch("texture binding", binding.second, actual);
+            }
+        }
+        return true;
+    }
+
+    bool checkBuffer(GLenum target) const {
+        GLenum query = bufferBindingQuery(target);
+        auto it = m_buffers.find(target);
+        if (query == 0 || it == m_buffers.end()) {
+            return true;
+        }
+        GLint actual = 0;
+        glGetIntegerv(query, &actual);
+        return reportMismatch("buffer binding", it->second, actual);
+    }
+
+    bool checkIndexedBuffer(GLenum target, GLuint index) const {
+        GLenum query = bufferBindingQuery(target);
+        auto it = m_indexed_buffers.find(target);
+        if (query == 0 || it == m_indexed_buffers.end() || index >= it->second.size()) {
+            return true;
+        }
+        GLint actual = 0;
+        glGetIntegeri_v(query, index, &actual);
+        return reportMismatch("indexed buffer binding", it->second[index], actual);
+    }
+
+    bool checkClipDistance(int index) const {
+        if (m_clip_distances[index] == CLIP_UNKNOWN) {
+            return true;
+        }
+        GLboolean actual = glIsEnabled(GL_CLIP_DISTANCE0 + index);
+        return reportMismatch("clip distance", static_cast<GLuint>(m_clip_distances[index]),
+                              actual == GL_TRUE ? 1 : 0);
+    }
+
+public:
+    StateCache(const StateCache&) = delete;
+    StateCache& operator=(const StateCache&) = delete;
+
+    // --- Vertex arrays and programs ---
+
+    /** @brief Binds a VAO unless it is already bound */
+    void bindVertexArray(GLuint vao) {
+        if (record(m_vertex_array != vao)) {
+            glBindVertexArray(vao);
+            m_vertex_array = vao;
+        }
+        if (m_validate) checkVertexArray();
+    }
+
+    /** @brief Makes a program current unless it already is */
+    void useProgram(GLuint program) {
+        if (record(m_program != program)) {
+            glUseProgram(program);
+            m_program = program;
+        }
+        if (m_validate) checkProgram();
+    }
+
+    /** @brief Gets the cached VAO binding */
+    GLuint getVertexArray() const { return m_vertex_array; }
+
+    /** @brief Gets the cached current program */
+    GLuint getProgram() const { return m_program; }
+
+    // --- Textures ---
+
+    /** @brief Selects the active texture unit unless it is already active */
+    void activeTexture(GLuint unit) {
+        if (record(m_active_unit != unit)) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            m_active_unit = unit;
+        }
+        if (m_validate) checkActiveUnit();
+    }
+
+    /**
+     * @brief Binds a texture to a unit, switching the active unit only if needed.
+     * @param unit Texture unit index (0-based, not GL_TEXTUREi)
+     * @param target Texture target (GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, ...)
+     * @param texture Texture ID (0 to unbind)
+     */
+    void bindTexture(GLuint unit, GLenum target, GLuint texture) {
+        GLuint& slot = textureSlot(unit, target);
+        if (record(slot != texture)) {
+            activeTexture(unit);
+            glBindTexture(target, texture);
+            slot = texture;
+        }
+        if (m_validate && m_active_unit == unit) checkActiveUnitTexture(target);
+    }
+
+    /**
+     * @brief Binds a texture on the currently active unit.
+     * @note For creation and parameter edits, which do not care about the unit.
+     */
+    void bindTexture(GLenum target, GLuint texture) {
+        if (m_active_unit == UNKNOWN) {
+            activeTexture(0);
+        }
+        bindTexture(m_active_unit, target, texture);
+    }
+
+    // --- Buffers ---
+
+    /**
+     * @brief Binds a buffer to a generic binding point unless already bound.
+     * @note GL_ELEMENT_ARRAY_BUFFER is VAO state and is never cached here.
+     */
+    void bindBuffer(GLenum target, GLuint buffer) {
+        if (target == GL_ELEMENT_ARRAY_BUFFER) {
+            record(true);
+            glBindBuffer(target, buffer);
+            return;
+        }
+        auto it = m_buffers.find(target);
+        if (record(it == m_buffers.end() || it->second != buffer)) {
+            glBindBuffer(target, buffer);
+            m_buffers[target] = buffer;
+        }
+        if (m_validate) checkBuffer(target);
+    }
+
+    /**
+     * @brief Binds a buffer to an indexed binding point unless already bound.
+     * @note Like glBindBufferBase, this also updates the generic binding of @p target.
+     */
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+        GLuint& slot = indexedSlot(target, index);
+        auto it = m_buffers.find(target);
+        bool generic_matches = (it != m_buffers.end() && it->second == buffer);
+        if (record(slot != buffer || !generic_matches)) {
+            glBindBufferBase(target, index, buffer);
+            slot = buffer;
+            m_buffers[target] = buffer;
+        }
+        if (m_validate) {
+            checkIndexedBuffer(target, index);
+            checkBuffer(target);
+        }
+    }
+
+    /**
+     * @brief Binds a range of a buffer to an indexed binding point.
+     * @note Always issued, since offsets are not cached. The slot becomes unknown,
+     *       so the next bindBufferBase() on it is never skipped.
+     */
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        record(true);
+        glBindBufferRange(target, index, buffer, offset, size);
+        indexedSlot(target, index) = UNKNOWN;
+        m_buffers[target] = buffer;
+        if (m_validate) checkBuffer(target);
+    }
+
+    // --- Clip distances ---
+
+    /** @brief Enables or disables GL_CLIP_DISTANCEi unless already in that state */
+    void setClipDistance(int index, bool enabled) {
+        if (index < 0 || index >= MAX_CLIP_DISTANCES) {
+            std::cerr << "Warning: Clip distance index " << index << " out of range." << std::endl;
+            return;
+        }
+        signed char wanted = enabled ? 1 : 0;
+        if (record(m_clip_distances[index] != wanted)) {
+            if (enabled) {
+                glEnable(GL_CLIP_DISTANCE0 + index);
+            } else {
+                glDisable(GL_CLIP_DISTANCE0 + index);
+            }
+            m_clip_distances[index] = wanted;
+        }
+        if (m_validate) checkClipDistance(index);
+    }
+
+    // --- Object deletion ---
+    // Deleting a bound object rebinds 0 on the GPU; these keep the cache in step.
+
+    /** @brief Call right after glDeleteVertexArrays */
+    void onVertexArrayDeleted(GLuint vao) {
+        if (m_vertex_array == vao) m_vertex_array = 0;
+    }
+
+    /** @brief Call right after glDeleteProgram (a current program stays in use until replaced) */
+    void onProgramDeleted(GLuint program) {
+        if (m_program == program) m_program = UNKNOWN;
+    }
+
+    /** @brief Call right after glDeleteTextures */
+    void onTextureDeleted(GLuint texture) {
+        for (auto& unit : m_units) {
+            for (auto& binding : unit.bindings) {
+                if (binding.second == texture) binding.second = 0;
+            }
+        }
+    }
+
+    /** @brief Call right after glDeleteBuffers */
+    void onBufferDeleted(GLuint buffer) {
+        for (auto& entry : m_buffers) {
+            if (entry.second == buffer) entry.second = 0;
+        }
+        for (auto& entry : m_indexed_buffers) {
+            for (auto& slot : entry.second) {
+                if (slot == buffer) slot = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Forgets every cached binding so the next call of each kind is issued.
+     * @note Use after third-party code (UI layers, loaders) touched GL state directly.
+     */
+    void invalidate() {
+        m_vertex_array = UNKNOWN;
+        m_program = UNKNOWN;
+        m_active_unit = UNKNOWN;
+        for (auto& unit : m_units) {
+            for (auto& binding : unit.bindings) binding.second = UNKNOWN;
+        }
+        for (auto& entry : m_buffers) entry.second = UNKNOWN;
+        for (auto& entry : m_indexed_buffers) {
+            for (auto& slot : entry.second) slot = UNKNOWN;
+        }
+        for (auto& clip : m_clip_distances) clip = CLIP_UNKNOWN;
+    }
+
+    // --- Validation ---
+
+    /**
+     * @brief Enables comparing the cache with glGet* after every call.
+     * @note Debug aid only: each check stalls the pipeline.
+     */
+    void setValidation(bool enabled) { m_validate = enabled; }
+
+    /** @brief Checks whether per-call validation is enabled */
+    bool isValidationEnabled() const { return m_validate; }
+
+    /**
+     * @brief Compares every cached binding with the GPU, printing mismatches.
+     * @return true if the cache matches the GPU
+     * @note Temporarily switches the active texture unit to inspect each unit.
+     */
+    bool validate() const {
+        bool ok = checkVertexArray();
+        ok = checkProgram() && ok;
+        ok = checkActiveUnit() && ok;
+
+        GLint previous_unit = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &previous_unit);
+        for (GLuint unit = 0; unit < m_units.size(); ++unit) {
+            for (const auto& binding : m_units[unit].bindings) {
+                GLenum query = textureBindingQuery(binding.first);
+                if (query == 0) continue;
+                glActiveTexture(GL_TEXTURE0 + unit);
+                GLint actual = 0;
+                glGetIntegerv(query, &actual);
+                ok = reportMismatch("texture binding", binding.second, actual) && ok;
+            }
+        }
+        glActiveTexture(static_cast<GLenum>(previous_unit));
+
+        for (const auto& entry : m_buffers) {
+            ok = checkBuffer(entry.first) && ok;
+        }
+        for (const auto& entry : m_indexed_buffers) {
+            for (GLuint index = 0; index < entry.second.size(); ++index) {
+                ok = checkIndexedBuffer(entry.first, index) && ok;
+            }
+        }
+        for (int i = 0; i < MAX_CLIP_DISTANCES; ++i) {
+            ok = checkClipDistance(i) && ok;
+        }
+        GL_CHECK("validate GL state cache");
+        return ok;
+    }
+
+    // --- Statistics ---
+
+    /** @brief Ends the frame: current counters become getStats() and are reset */
+    void nextFrame() {
+        m_last_frame_stats = m_frame_stats;
+        m_frame_stats = Stats();
+    }
+
+    /** @brief Gets counters of the last completed frame */
+    const Stats& getStats() const { return m_last_frame_stats; }
+
+    /** @brief Gets counters accumulated so far in the current frame */
+    const Stats& getCurrentFrameStats() const { return m_frame_stats; }
+};
+
+/**
+ * @brief Gets the global GL state cache.
+ * @note Never destroyed, so GL objects released during static destruction
+ *       can still notify it.
+ */
+inline StateCachePtr cache() {
+    static StateCachePtr* instance = new StateCachePtr(new StateCache());
+    return *instance;
+}
+
+} // namespace gl_state
+
+#endif // GL_STATE_H
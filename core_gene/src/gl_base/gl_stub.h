@@ -0,0 +1,178 @@
+#ifndef GL_STUB_H
+#define GL_STUB_H
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include "gl_includes.h"
+
+/**
+ * @file gl_stub.h
+ * @brief Loads no-op OpenGL functions so CPU-side code runs without a context.
+ *
+ * Meant for microbenchmarks and CI machines without a GPU: after
+ * gl_stub::load(), every GL entry point glad knows about is callable and does
+ * nothing. The few calls whose results the engine depends on return values
+ * that keep it on its normal path:
+ * - glGetString(GL_VERSION) reports 4.6, so glad accepts the "context"
+ * - glGen* / glCreate* hand out increasing non-zero names
+ * - compile and link status queries report success
+ * - glCheckFramebufferStatus reports GL_FRAMEBUFFER_COMPLETE
+ * - query results are immediately available and zero
+ * Everything else returns zero and leaves output parameters as they are.
+ *
+ * @note Unmatched entry points share one argument-less no-op, which relies on the
+ * caller cleaning up the arguments. That holds for the x86-64 and AArch64 C ABIs,
+ * not for 32-bit Windows stdcall.
+ */
+#if defined(_WIN32) && !defined(_WIN64)
+    #error "gl_stub.h requires a caller-cleanup calling convention (64-bit target)"
+#endif
+
+namespace gl_stub {
+
+namespace detail {
+
+inline uint64_t& callCounter() {
+    static uint64_t count = 0;
+    return count;
+}
+
+inline GLuint& nextName() {
+    static GLuint name = 0;
+    return name;
+}
+
+// Shared by every entry point without a dedicated stub: returns 0 / nullptr
+inline uintptr_t GLAD_API_PTR noop() {
+    ++callCounter();
+    return 0;
+}
+
+inline const GLubyte* GLAD_API_PTR getString(GLenum name) {
+    ++callCounter();
+    switch (name) {
+        case GL_VERSION:                  return reinterpret_cast<const GLubyte*>("4.6.0 EnGene stub");
+        case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte*>("4.60");
+        case GL_VENDOR:                   return reinterpret_cast<const GLubyte*>("EnGene");
+        case GL_RENDERER:                 return reinterpret_cast<const GLubyte*>("GL stub");
+        default:                          return reinterpret_cast<const GLubyte*>("");
+    }
+}
+
+inline const GLubyte* GLAD_API_PTR getStringi(GLenum, GLuint) {
+    ++callCounter();
+    return reinterpret_cast<const GLubyte*>("");
+}
+
+inline void GLAD_API_PTR getIntegerv(GLenum, GLint* data) {
+    ++callCounter();
+    if (data) *data = 0;
+}
+
+inline void GLAD_API_PTR getInteger64v(GLenum, GLint64* data) {
+    ++callCounter();
+    if (data) *data = 0;
+}
+
+inline void GLAD_API_PTR getObjectiv(GLuint, GLenum pname, GLint* params) {
+    ++callCounter();
+    if (!params) return;
+    switch (pname) {
+        case GL_COMPILE_STATUS:
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+        case GL_QUERY_RESULT_AVAILABLE:
+            *params = GL_TRUE;
+            break;
+        default:
+            *params = 0;
+    }
+}
+
+inline void GLAD_API_PTR getQueryObjectui64v(GLuint, GLenum, GLuint64* params) {
+    ++callCounter();
+    if (params) *params = 0;
+}
+
+inline void GLAD_API_PTR genNames(GLsizei n, GLuint* names) {
+    ++callCounter();
+    for (GLsizei i = 0; names && i < n; ++i) {
+        names[i] = ++nextName();
+    }
+}
+
+inline GLuint GLAD_API_PTR createShader(GLenum) {
+    ++callCounter();
+    return ++nextName();
+}
+
+inline GLuint GLAD_API_PTR createProgram() {
+    ++callCounter();
+    return ++nextName();
+}
+
+inline GLenum GLAD_API_PTR checkFramebufferStatus(GLenum) {
+    ++callCounter();
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+inline bool isOneOf(const char* name, std::initializer_list<const char*> candidates) {
+    for (const char* candidate : candidates) {
+        if (std::strcmp(name, candidate) == 0) return true;
+    }
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * @brief glad loader callback returning the stub for a GL entry point.
+ */
+inline GLADapiproc getProcAddress(const char* name) {
+    using namespace detail;
+    if (std::strcmp(name, "glGetString") == 0)  return reinterpret_cast<GLADapiproc>(&getString);
+    if (std::strcmp(name, "glGetStringi") == 0) return reinterpret_cast<GLADapiproc>(&getStringi);
+    if (std::strcmp(name, "glGetIntegerv") == 0) return reinterpret_cast<GLADapiproc>(&getIntegerv);
+    if (std::strcmp(name, "glGetInteger64v") == 0) return reinterpret_cast<GLADapiproc>(&getInteger64v);
+    if (isOneOf(name, {"glGetShaderiv", "glGetProgramiv", "glGetQueryObjectiv", "glGetQueryObjectuiv"})) {
+        return reinterpret_cast<GLADapiproc>(&getObjectiv);
+    }
+    if (isOneOf(name, {"glGetQueryObjectui64v", "glGetQueryObjecti64v"})) {
+        return reinterpret_cast<GLADapiproc>(&getQueryObjectui64v);
+    }
+    if (isOneOf(name, {"glGenBuffers", "glGenVertexArrays", "glGenTextures", "glGenFramebuffers",
+                       "glGenRenderbuffers", "glGenQueries", "glGenSamplers"})) {
+        return reinterpret_cast<GLADapiproc>(&genNames);
+    }
+    if (std::strcmp(name, "glCreateShader") == 0)  return reinterpret_cast<GLADapiproc>(&createShader);
+    if (std::strcmp(name, "glCreateProgram") == 0) return reinterpret_cast<GLADapiproc>(&createProgram);
+    if (std::strcmp(name, "glCheckFramebufferStatus") == 0) {
+        return reinterpret_cast<GLADapiproc>(&checkFramebufferStatus);
+    }
+    return reinterpret_cast<GLADapiproc>(&noop);
+}
+
+/**
+ * @brief Points every glad GL function at the stubs.
+ * @return The glad version code (4.6), as returned by gladLoadGL()
+ */
+inline int load() {
+    return gladLoadGL(getProcAddress);
+}
+
+/**
+ * @brief Number of stubbed GL calls made since startup (or the last resetCallCount()).
+ */
+inline uint64_t callCount() {
+    return detail::callCounter();
+}
+
+inline void resetCallCount() {
+    detail::callCounter() = 0;
+}
+
+} // namespace gl_stub
+
+#endif // GL_STUB_H
@@ -0,0 +1,209 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "gl_includes.h"
+#include "../exceptions/base_exception.h"
+
+/**
+ * Headless backends are opt-in because they add a link dependency:
+ * - ENGENE_HEADLESS_EGL:    EGL surfaceless platform (link with -lEGL)
+ * - ENGENE_HEADLESS_OSMESA: Mesa off-screen rendering, e.g. llvmpipe (link with -lOSMesa)
+ *
+ * Define one of them before including EnGene headers to enable
+ * EnGeneConfig::headless.
+ */
+#if defined(ENGENE_HEADLESS_EGL)
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#elif defined(ENGENE_HEADLESS_OSMESA)
+    #include <GL/osmesa.h>
+#endif
+
+namespace headless {
+
+class HeadlessContext;
+using HeadlessContextPtr = std::shared_ptr<HeadlessContext>;
+
+/**
+ * @class HeadlessContext
+ * @brief Creates and owns an OpenGL 4.3 core context without a window.
+ *
+ * The context has no usable default framebuffer; EnGene renders into an
+ * internal framebuffer installed with framebuffer::stack()->setDefaultTarget().
+ * GL function pointers are loaded through glad as soon as the context is current.
+ */
+class HeadlessContext {
+private:
+#if defined(ENGENE_HEADLESS_EGL)
+    EGLDisplay m_display = EGL_NO_DISPLAY;
+    EGLContext m_context = EGL_NO_CONTEXT;
+
+    static GLADapiproc loadProc(const char* name) {
+        return reinterpret_cast<GLADapiproc>(eglGetProcAddress(name));
+    }
+
+    void create() {
+        // Prefer the surfaceless platform: no X11/Wayland display required
+        auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (get_platform_display) {
+            m_display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (m_display == EGL_NO_DISPLAY) {
+            m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+        if (m_display == EGL_NO_DISPLAY) {
+            throw exception::EnGeneException("Headless: no EGL display available");
+        }
+
+        EGLint major = 0, minor = 0;
+        if (!eglInitialize(m_display, &major, &minor)) {
+            throw exception::EnGeneException("Headless: eglInitialize failed");
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            throw exception::EnGeneException("Headless: EGL does not support desktop OpenGL");
+        }
+
+        const EGLint config_attribs[] = {
+            EGL_SURFACE_TYPE, EGL_DONT_CARE,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint num_configs = 0;
+        if (!eglChooseConfig(m_display, config_attribs, &config, 1, &num_configs) || num_configs == 0) {
+            throw exception::EnGeneException("Headless: no EGL config supports OpenGL");
+        }
+
+        const EGLint context_attribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION_KHR, 4,
+            EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+            EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR,
+            EGL_NONE
+        };
+        m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attribs);
+        if (m_context == EGL_NO_CONTEXT) {
+            throw exception::EnGeneException("Headless: could not create an OpenGL 4.3 core EGL context");
+        }
+
+        // Requires EGL_KHR_surfaceless_context
+        if (!eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context)) {
+            throw exception::EnGeneException("Headless: eglMakeCurrent without surface failed");
+        }
+    }
+
+    void destroy() {
+        if (m_display != EGL_NO_DISPLAY) {
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (m_context != EGL_NO_CONTEXT) {
+                eglDestroyContext(m_display, m_context);
+            }
+            eglTerminate(m_display);
+        }
+    }
+
+#elif defined(ENGENE_HEADLESS_OSMESA)
+    OSMesaContext m_context = nullptr;
+    std::vector<unsigned char> m_buffer;  ///< OSMesa needs a client buffer to make the context current
+
+    static GLADapiproc loadProc(const char* name) {
+        return reinterpret_cast<GLADapiproc>(OSMesaGetProcAddress(name));
+    }
+
+    void create() {
+        const int attribs[] = {
+            OSMESA_FORMAT, OSMESA_RGBA,
+            OSMESA_DEPTH_BITS, 0,
+            OSMESA_STENCIL_BITS, 0,
+            OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+            OSMESA_CONTEXT_MAJOR_VERSION, 4,
+            OSMESA_CONTEXT_MINOR_VERSION, 3,
+            0
+        };
+        m_context = OSMesaCreateContextAttribs(attribs, nullptr);
+        if (!m_context) {
+            throw exception::EnGeneException("Headless: could not create an OpenGL 4.3 core OSMesa context");
+        }
+
+        // 1x1 client buffer: rendering goes to the internal default target
+        m_buffer.resize(4);
+        if (!OSMesaMakeCurrent(m_context, m_buffer.data(), GL_UNSIGNED_BYTE, 1, 1)) {
+            throw exception::EnGeneException("Headless: OSMesaMakeCurrent failed");
+        }
+    }
+
+    void destroy() {
+        if (m_context) {
+            OSMesaDestroyContext(m_context);
+        }
+    }
+
+#else
+    static GLADapiproc loadProc(const char*) { return nullptr; }
+
+    void create() {
+        throw exception::EnGeneException(
+            "Headless mode requires building with ENGENE_HEADLESS_EGL or ENGENE_HEADLESS_OSMESA");
+    }
+
+    void destroy() {}
+#endif
+
+    HeadlessContext() {
+        try {
+            create();
+        } catch (...) {
+            destroy();  // Release whatever was created before the failure
+            throw;
+        }
+
+        int version = gladLoadGL(loadProc);
+        if (!version) {
+            destroy();
+            throw exception::EnGeneException("Headless: failed to load OpenGL functions");
+        }
+        if (GLAD_VERSION_MAJOR(version) < 4 ||
+            (GLAD_VERSION_MAJOR(version) == 4 && GLAD_VERSION_MINOR(version) < 3)) {
+            destroy();
+            throw exception::EnGeneException("Headless: OpenGL 4.3 or newer is required, got " +
+                                             std::to_string(GLAD_VERSION_MAJOR(version)) + "." +
+                                             std::to_string(GLAD_VERSION_MINOR(version)));
+        }
+    }
+
+public:
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    /**
+     * @brief Creates a context, makes it current and loads GL functions.
+     * @throws exception::EnGeneException if no backend is compiled in or creation fails
+     */
+    static HeadlessContextPtr Make() {
+        return HeadlessContextPtr(new HeadlessContext());
+    }
+
+    ~HeadlessContext() {
+        destroy();
+    }
+
+    /** @brief Name of the compiled-in backend */
+    static const char* backendName() {
+#if defined(ENGENE_HEADLESS_EGL)
+        return "EGL surfaceless";
+#elif defined(ENGENE_HEADLESS_OSMESA)
+        return "OSMesa";
+#else
+        return "none";
+#endif
+    }
+};
+
+} // namespace headless
+
+#endif // HEADLESS_CONTEXT_H
@@ -274,33 +274,82 @@ using MaterialStackPtr = std::shared_ptr<MaterialStack>;
  * @brief Hierarchical state machine for material property management.
  *
  * Follows Meyers singleton pattern, mirroring texture::stack() and shader::stack().
- * Maintains a stack of merged material property states with efficient O(1) operations.
- * The base state (index 0) contains default PBR properties and cannot be popped.
+ * Keeps one current value per property and an undo log of the values each push
+ * replaced, so push/pop cost is proportional to the pushed material's property
+ * count and does not allocate once the log has grown to the scene's depth.
+ * The base state contains default PBR properties and cannot be popped.
  */
 class MaterialStack {
 private:
-    /// @brief Vector of merged property maps - each level contains the fully merged state.
-    /// Index 0 is the base state that can never be popped.
-    std::vector<MaterialData> m_stack;
+    /// @brief A property value replaced by a push, restored by the matching pop.
+    struct Change {
+        size_t slot;
+        PropertyVariant previous;
+        bool was_present;
+    };
+
+    /// @brief Property name -> slot index. Names are interned on first use and never removed.
+    std::unordered_map<std::string, size_t> m_slots;
+    std::vector<std::string> m_names;       ///< Slot -> property name
+    std::vector<PropertyVariant> m_current; ///< Slot -> value in the current merged state
+    std::vector<char> m_present;            ///< Slot -> whether the current state defines it
+    std::vector<PropertyVariant> m_base;    ///< Slot -> value in the base state
+    std::vector<char> m_in_base;            ///< Slot -> whether the base state defines it
+
+    std::vector<Change> m_undo;             ///< Replaced values, oldest first
+    std::vector<size_t> m_levels;           ///< Undo log size at each push
 
     /**
      * @brief Private constructor following Meyers singleton pattern.
      *
-     * Initializes with base material containing standard PBR properties at index 0.
+     * Initializes the base state with standard PBR properties.
      */
     MaterialStack() {
-        MaterialData base_state;
-        
-        base_state[Material::s_ambient_name] = glm::vec3(0.2f, 0.2f, 0.2f);
-        base_state[Material::s_diffuse_name] = glm::vec3(0.8f, 0.8f, 0.8f);
-        base_state[Material::s_specular_name] = glm::vec3(0.5f, 0.5f, 0.5f);
-        base_state[Material::s_shininess_name] = 32.0f;
-        
-        m_stack.push_back(std::move(base_state));
+        defineDefault(Material::s_ambient_name, glm::vec3(0.2f, 0.2f, 0.2f));
+        defineDefault(Material::s_diffuse_name, glm::vec3(0.8f, 0.8f, 0.8f));
+        defineDefault(Material::s_specular_name, glm::vec3(0.5f, 0.5f, 0.5f));
+        defineDefault(Material::s_shininess_name, 32.0f);
     }
 
     friend MaterialStackPtr stack();
 
+    /**
+     * @brief Returns the slot of a property, creating an undefined one on first use.
+     */
+    size_t internSlot(const std::string& name) {
+        auto it = m_slots.find(name);
+        if (it != m_slots.end()) {
+            return it->second;
+        }
+        size_t slot = m_names.size();
+        m_slots.emplace(name, slot);
+        m_names.push_back(name);
+        m_current.emplace_back();
+        m_present.push_back(0);
+        m_base.emplace_back();
+        m_in_base.push_back(0);
+        return slot;
+    }
+
+    template<typename T>
+    T getSlotValue(size_t slot, const std::string& name) const {
+        if (!m_present[slot]) {
+            std::cerr << "Warning: Material property '" << name 
+                      << "' not found in current state. Returning default value." << std::endl;
+            return T{};
+        }
+
+        const T* value_ptr = std::get_if<T>(&m_current[slot]);
+        if (value_ptr) {
+            return *value_ptr;
+        } else {
+            std::cerr << "Warning: Type mismatch for property '" << name 
+                      << "'. Requested type does not match stored type. "
+                      << "Returning default value." << std::endl;
+            return T{};
+        }
+    }
+
 public:
     MaterialStack(const MaterialStack&) = delete;
     MaterialStack& operator=(const MaterialStack&) = delete;
@@ -310,8 +359,8 @@ public:
      * @brief Pushes a material onto the stack, merging with current state.
      * @param mat A MaterialPtr to the Material to push.
      *
-     * O(1) operation - copies current state and merges new properties.
-     * Incoming properties overwrite existing keys in the merged state.
+     * Incoming properties overwrite existing keys in the merged state; the values
+     * they replace are logged so pop() can restore them.
      */
     void push(MaterialPtr mat) {
         if (!mat) {
@@ -320,41 +369,44 @@ public:
             return;
         }
 
-        if (m_stack.empty()) {
-            std::cerr << "Error: Material stack is corrupted (empty). "
-                      << "Reinitializing with base state." << std::endl;
-            m_stack.push_back(MaterialData());
-        }
-
-        MaterialData new_state = m_stack.back();
-        
         const auto& incoming_props = mat->getProperties();
         if (incoming_props.empty()) {
             std::cerr << "Warning: Pushing material with no properties. "
                       << "Stack state unchanged." << std::endl;
         }
-        
+
+        m_levels.push_back(m_undo.size());
         for (const auto& [name, value] : incoming_props) {
-            new_state[name] = value;
+            size_t slot = internSlot(name);
+            m_undo.push_back(Change{slot, m_current[slot], m_present[slot] != 0});
+            m_current[slot] = value;
+            m_present[slot] = 1;
         }
-        
-        m_stack.push_back(std::move(new_state));
     }
 
     /**
      * @brief Pops material from stack with base state protection.
      *
-     * Never allows popping index 0 (base state).
+     * Never allows popping the base state.
      * Validates stack size to prevent underflow.
      */
     void pop() {
-        if (m_stack.size() <= 1) {
+        if (m_levels.empty()) {
             std::cerr << "Warning: Cannot pop base material state from stack (size=" 
-                      << m_stack.size() << "). Base state must always remain. "
+                      << m_levels.size() + 1 << "). Base state must always remain. "
                       << "Operation ignored." << std::endl;
             return;
         }
-        m_stack.pop_back();
+
+        size_t level_start = m_levels.back();
+        m_levels.pop_back();
+        // Undo newest first, so a property pushed twice ends at its oldest value
+        while (m_undo.size() > level_start) {
+            Change& change = m_undo.back();
+            m_current[change.slot] = change.previous;
+            m_present[change.slot] = change.was_present ? 1 : 0;
+            m_undo.pop_back();
+        }
     }
 
     /**
@@ -363,29 +415,17 @@ public:
      * @param name The name of the property to retrieve.
      * @return The property value, or a default-constructed value if not found or type mismatch.
      *
-     * O(1) access to current merged state.
      * Returns default-constructed value if property not found or type mismatch.
      */
     template<typename T>
     T getValue(const std::string& name) const {
-        const auto& current_state = m_stack.back();
-        auto it = current_state.find(name);
-        
-        if (it == current_state.end()) {
+        auto it = m_slots.find(name);
+        if (it == m_slots.end()) {
             std::cerr << "Warning: Material property '" << name 
                       << "' not found in current state. Returning default value." << std::endl;
             return T{};
         }
-        
-        const T* value_ptr = std::get_if<T>(&it->second);
-        if (value_ptr) {
-            return *value_ptr;
-        } else {
-            std::cerr << "Warning: Type mismatch for property '" << name 
-                      << "'. Requested type does not match stored type. "
-                      << "Returning default value." << std::endl;
-            return T{};
-        }
+        return getSlotValue<T>(it->second, name);
     }
 
     /**
@@ -394,8 +434,8 @@ public:
      * @param name The name of the property.
      * @return A std::function that returns the current property value when called.
      *
-     * Returns std::function that captures stack reference and property name.
-     * Provider executes getValue when called, enabling dynamic uniform binding.
+     * The property name is resolved to its slot here, so calling the provider
+     * is an array read instead of a string lookup.
      * Provider includes validation and returns default value on error.
      */
     template<typename T>
@@ -404,9 +444,10 @@ public:
             std::cerr << "Warning: Creating provider for empty property name. "
                       << "Provider will always return default value." << std::endl;
         }
-        
-        return [this, name]() -> T {
-            return this->getValue<T>(name);
+
+        size_t slot = internSlot(name);
+        return [this, slot]() -> T {
+            return this->getSlotValue<T>(slot, m_names[slot]);
         };
     }
 
@@ -414,20 +455,27 @@ public:
      * @brief Defines a global default value for a custom property.
      * @param name The uniform name (e.g., "u_roughness").
      * @param defaultValue The value to use when a material doesn't explicitly set this.
-     * * Adds the property to the Base State (Index 0). 
-     * Because push() copies the previous state, this ensures the key 
-     * always exists in the map, silencing warnings and preventing state leaks.
+     *
+     * Adds the property to the base state, overwriting it if it exists.
+     * Materials pushed on top keep their own values; the default shows again
+     * once they are popped.
      */
     template<typename T>
     void defineDefault(const std::string& name, const T& defaultValue) {
-        if (m_stack.empty()) return; // Should never happen given constructor
-        
-        // Insert into the Base State (Index 0)
-        // If it already exists, this does nothing (or you can force overwrite)
-        MaterialData& base = m_stack[0];
-        
-        // We use assignment to ensure we overwrite if it exists, or insert if new
-        base[name] = defaultValue; 
+        size_t slot = internSlot(name);
+        m_base[slot] = defaultValue;
+        m_in_base[slot] = 1;
+
+        // The oldest logged change of this slot holds its base value
+        for (Change& change : m_undo) {
+            if (change.slot == slot) {
+                change.previous = defaultValue;
+                change.was_present = true;
+                return;
+            }
+        }
+        m_current[slot] = defaultValue;
+        m_present[slot] = 1;
     }
 
     /**
@@ -436,7 +484,7 @@ public:
      *
      * Uses std::visit for type-safe provider creation.
      * Integrates with shader's configureDynamicUniform system.
-     * Iterates over base state properties (index 0) and binds each to the shader.
+     * Iterates over base state properties and binds each to the shader.
      */
     void configureShaderDefaults(std::shared_ptr<shader::Shader> shader) {
         if (!shader) {
@@ -445,19 +493,12 @@ public:
             return;
         }
 
-        if (m_stack.empty()) {
-            std::cerr << "Error: Material stack is empty. Cannot configure shader defaults." << std::endl;
-            return;
-        }
+        bool any_default = false;
+        for (size_t slot = 0; slot < m_names.size(); ++slot) {
+            if (!m_in_base[slot]) continue;
+            any_default = true;
 
-        const auto& base_state = m_stack[0];
-        
-        if (base_state.empty()) {
-            std::cerr << "Warning: Base material state is empty. No properties to configure." << std::endl;
-            return;
-        }
-
-        for (const auto& [name, variant_value] : base_state) {
+            const std::string& name = m_names[slot];
             try {
                 std::visit([this, &shader, &name](auto&& value) {
                     using T = std::decay_t<decltype(value)>;
@@ -467,12 +508,16 @@ public:
                         std::cerr << "Error: Failed to configure dynamic uniform '" << name 
                                   << "': " << e.what() << std::endl;
                     }
-                }, variant_value);
+                }, m_base[slot]);
             } catch (const std::exception& e) {
                 std::cerr << "Error: Exception while processing property '" << name 
                           << "': " << e.what() << std::endl;
             }
         }
+
+        if (!any_default) {
+            std::cerr << "Warning: Base material state is empty. No properties to configure." << std::endl;
+        }
     }
 };
 
@@ -0,0 +1,393 @@
+#ifndef READBACK_H
+#define READBACK_H
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include "gl_includes.h"
+#include "error.h"
+#include "framebuffer.h"
+#include "gl_state.h"
+#include "../exceptions/framebuffer_exception.h"
+
+/**
+ * @file readback.h
+ * @brief Asynchronous framebuffer readback through a ring of pixel buffer objects
+ *
+ * glReadPixels into a PBO returns immediately; the copy runs on the GPU after
+ * the commands that produced the image. A fence marks its completion, and the
+ * bytes are only mapped once the fence has signaled, so the render thread
+ * never waits for the GPU.
+ *
+ * See README.md for usage examples.
+ */
+
+namespace framebuffer {
+
+class Readback;
+using ReadbackPtr = std::shared_ptr<Readback>;
+
+/**
+ * @struct ReadbackImage
+ * @brief Pixels of one completed capture
+ */
+struct ReadbackImage {
+    uint64_t id = 0;                    ///< Sequence number returned by capture()
+    int width = 0;                      ///< Width in pixels
+    int height = 0;                     ///< Height in pixels
+    bool depth = false;                 ///< true: one float per pixel, false: RGBA8
+    std::vector<unsigned char> pixels;  ///< Tightly packed rows, bottom row first (GL order)
+
+    /** @brief Bytes per pixel of pixels */
+    size_t bytesPerPixel() const { return depth ? sizeof(float) : 4; }
+};
+
+/**
+ * @class Readback
+ * @brief Copies attachments to CPU memory without stalling the render thread
+ *
+ * Each capture() records a glReadPixels into the next free PBO of the ring
+ * followed by a fence. poll() checks the fences without blocking; once a fence
+ * has signaled, the PBO is mapped, its bytes are copied into a recycled buffer
+ * and the callback runs on a worker thread, typically 2-3 frames after the
+ * capture. When every slot is still in flight, the capture is dropped instead
+ * of waiting, so frame time does not change while capturing at full rate.
+ *
+ * @note capture(), poll() and flush() must be called on the GL thread.
+ * @note Callbacks run on the worker thread, in capture order, and must not call GL.
+ *
+ * Usage:
+ * @code
+ * auto readback = framebuffer::Readback::Make();
+ *
+ * // In the render callback, after drawing
+ * if (frame % 10 == 0) {
+ *     readback->capture(nullptr, framebuffer::attachment::Point::Color0,
+ *         [](const framebuffer::ReadbackImage& image) {
+ *             save_thumbnail(image);  // Worker thread
+ *         });
+ * }
+ * @endcode
+ */
+class Readback {
+public:
+    using Callback = std::function<void(const ReadbackImage&)>;
+
+    /**
+     * @struct Stats
+     * @brief Lifetime counters of the readback ring
+     */
+    struct Stats {
+        uint64_t captured = 0;   ///< Copies recorded into a PBO
+        uint64_t delivered = 0;  ///< Copies handed to the worker thread
+        uint64_t dropped = 0;    ///< Captures skipped because every slot was in flight
+    };
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsizeiptr capacity = 0;
+        GLsync fence = nullptr;
+        ReadbackImage image;     ///< Header of the pending capture (pixels stay empty)
+        Callback callback;
+    };
+
+    struct Job {
+        ReadbackImage image;
+        Callback callback;
+    };
+
+    std::vector<Slot> m_slots;
+    std::deque<size_t> m_in_flight;  ///< Slot indices in capture order
+    std::deque<size_t> m_free;
+    uint64_t m_next_id = 1;
+    Stats m_stats;
+
+    // Worker thread state, guarded by m_mutex
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_work_ready;
+    std::condition_variable m_work_done;
+    std::deque<Job> m_jobs;
+    std::vector<std::vector<unsigned char>> m_spare_buffers;  ///< Recycled pixel storage
+    bool m_busy = false;
+    bool m_stop = false;
+
+    explicit Readback(int ring_size) {
+        if (ring_size < 1) {
+            throw exception::FramebufferException("Readback ring size must be at least 1");
+        }
+        m_slots.resize(static_cast<size_t>(ring_size));
+        std::vector<GLuint> ids(m_slots.size());
+        glGenBuffers(static_cast<GLsizei>(ids.size()), ids.data());
+        GL_CHECK("generate readback PBOs");
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            m_slots[i].pbo = ids[i];
+            m_free.push_back(i);
+        }
+        m_worker = std::thread(&Readback::workerLoop, this);
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_work_ready.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            if (m_jobs.empty()) {
+                return;  // Stop requested and queue drained
+            }
+            Job job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_busy = true;
+            lock.unlock();
+
+            try {
+                if (job.callback) {
+                    job.callback(job.image);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Readback callback for capture " << job.image.id
+                          << " threw: " << e.what() << std::endl;
+            }
+
+            lock.lock();
+            m_spare_buffers.push_back(std::move(job.image.pixels));
+            m_busy = false;
+            m_work_done.notify_all();
+        }
+    }
+
+    /**
+     * @brief Maps a completed slot, copies its bytes and queues the callback.
+     */
+    void retire(size_t index) {
+        Slot& slot = m_slots[index];
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        Job job;
+        job.image = slot.image;
+        job.callback = std::move(slot.callback);
+        slot.callback = nullptr;
+
+        size_t size = static_cast<size_t>(slot.image.width) * slot.image.height * slot.image.bytesPerPixel();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_spare_buffers.empty()) {
+                job.image.pixels = std::move(m_spare_buffers.back());
+                m_spare_buffers.pop_back();
+            }
+        }
+        job.image.pixels.resize(size);
+
+        gl_state::cache()->bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+        if (mapped) {
+            std::memcpy(job.image.pixels.data(), mapped, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            std::cerr << "Warning: Readback could not map the PBO of capture " << slot.image.id << std::endl;
+        }
+        gl_state::cache()->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        GL_CHECK("map readback PBO");
+
+        m_free.push_back(index);
+        if (!mapped) {
+            return;
+        }
+
+        ++m_stats.delivered;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_work_ready.notify_one();
+    }
+
+    /** @brief Framebuffer currently bound by the FramebufferStack */
+    static GLuint boundFramebufferId() {
+        if (auto top = stack()->top()) {
+            return top->getID();
+        }
+        auto target = stack()->getDefaultTarget();
+        return target ? target->getID() : 0;
+    }
+
+public:
+    Readback(const Readback&) = delete;
+    Readback& operator=(const Readback&) = delete;
+
+    /**
+     * @brief Creates a readback ring
+     * @param ring_size Number of PBOs, i.e. captures that may be in flight at once
+     * @note 3 slots cover the usual 2-3 frames of GPU latency when capturing every frame
+     */
+    static ReadbackPtr Make(int ring_size = 3) {
+        return ReadbackPtr(new Readback(ring_size));
+    }
+
+    /**
+     * @brief Discards pending captures and stops the worker once queued callbacks have run.
+     * @note Call flush() first to receive captures that are still in flight.
+     */
+    ~Readback() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_work_ready.notify_all();
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+
+        for (auto& slot : m_slots) {
+            if (slot.fence) {
+                glDeleteSync(slot.fence);
+            }
+            gl_state::cache()->onBufferDeleted(slot.pbo);
+            glDeleteBuffers(1, &slot.pbo);
+        }
+    }
+
+    /**
+     * @brief Records an asynchronous copy of an attachment
+     * @param fbo Source framebuffer, or nullptr for the default framebuffer
+     *            (the window's back buffer, or the headless default target)
+     * @param point Color0-Color7 for RGBA8 pixels, Depth or DepthStencil for float depth
+     * @param callback Receives the pixels on the worker thread
+     * @return Capture id passed back in ReadbackImage::id, or 0 if the capture was dropped
+     * @throws exception::FramebufferException if the attachment cannot be read
+     * @note Polls the ring first, so one capture() per frame is enough to keep it moving.
+     */
+    uint64_t capture(FramebufferPtr fbo, attachment::Point point, Callback callback) {
+        using attachment::Point;
+        if (point == Point::Stencil) {
+            throw exception::FramebufferException("Readback supports color and depth attachments only");
+        }
+        bool depth = point == Point::Depth || point == Point::DepthStencil;
+
+        FramebufferPtr source = fbo ? fbo : stack()->getDefaultTarget();
+        if (source) {
+            if (depth && !source->m_has_depth) {
+                throw exception::FramebufferException("Readback source has no depth attachment");
+            }
+            if (!depth && std::find(source->m_color_attachments.begin(), source->m_color_attachments.end(),
+                                    attachment::toGLAttachmentPoint(point)) == source->m_color_attachments.end()) {
+                throw exception::FramebufferException("Readback source has no such color attachment");
+            }
+        } else if (!depth && point != Point::Color0) {
+            throw exception::FramebufferException("The window framebuffer only has a Color0 attachment");
+        }
+
+        poll();
+        if (m_free.empty()) {
+            ++m_stats.dropped;
+            return 0;
+        }
+        size_t index = m_free.front();
+        m_free.pop_front();
+        Slot& slot = m_slots[index];
+
+        int width = 0, height = 0;
+        if (fbo) {
+            width = fbo->getWidth();
+            height = fbo->getHeight();
+        } else {
+            stack()->getDefaultSize(width, height);
+        }
+
+        slot.image.id = m_next_id++;
+        slot.image.width = width;
+        slot.image.height = height;
+        slot.image.depth = depth;
+        slot.callback = std::move(callback);
+
+        GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * static_cast<GLsizeiptr>(slot.image.bytesPerPixel());
+        gl_state::cache()->bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        if (size > slot.capacity) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+            slot.capacity = size;
+        }
+
+        // Only the read binding changes; FramebufferStack owns the draw binding
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, source ? source->getID() : 0);
+        if (!depth) {
+            glReadBuffer(source ? attachment::toGLAttachmentPoint(point) : GL_BACK);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        } else {
+            glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        }
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, boundFramebufferId());
+        gl_state::cache()->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        GL_CHECK("record readback");
+
+        m_in_flight.push_back(index);
+        ++m_stats.captured;
+        return slot.image.id;
+    }
+
+    /**
+     * @brief Hands every capture whose fence has signaled to the worker thread
+     * @note Never blocks; stops at the first capture the GPU has not finished.
+     */
+    void poll() {
+        while (!m_in_flight.empty()) {
+            size_t index = m_in_flight.front();
+            GLenum status = glClientWaitSync(m_slots[index].fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                break;
+            }
+            if (status == GL_WAIT_FAILED) {
+                std::cerr << "Warning: Readback fence wait failed for capture "
+                          << m_slots[index].image.id << std::endl;
+            }
+            m_in_flight.pop_front();
+            retire(index);
+        }
+    }
+
+    /**
+     * @brief Waits for every pending capture and callback to finish
+     * @note Blocks on the GPU. Meant for shutdown or the end of a headless run.
+     */
+    void flush() {
+        while (!m_in_flight.empty()) {
+            size_t index = m_in_flight.front();
+            m_in_flight.pop_front();
+            glClientWaitSync(m_slots[index].fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+            retire(index);
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_work_done.wait(lock, [this] { return m_jobs.empty() && !m_busy; });
+    }
+
+    /** @brief Number of captures recorded but not yet handed to the worker */
+    size_t pending() const {
+        return m_in_flight.size();
+    }
+
+    /** @brief Number of slots in the ring */
+    size_t ringSize() const {
+        return m_slots.size();
+    }
+
+    /** @brief Lifetime counters */
+    const Stats& getStats() const {
+        return m_stats;
+    }
+};
+
+} // namespace framebuffer
+
+#endif // READBACK_H
@@ -0,0 +1,624 @@
+#ifndef RENDER_GRAPH_H
+#define RENDER_GRAPH_H
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <climits>
+#include "gl_includes.h"
+#include "framebuffer.h"
+#include "texture.h"
+
+/**
+ * @file render_graph.h
+ * @brief Declarative multi-pass rendering with transient, aliased attachments
+ *
+ * Passes declare the attachments they read and write. On compile the graph
+ * orders passes so each runs after the passes that write what it reads,
+ * culls passes that do not contribute to an output, computes each transient
+ * attachment's lifetime, and lets attachments with disjoint lifetimes share
+ * the same GPU texture.
+ *
+ * See README.md for usage examples.
+ */
+
+namespace framebuffer {
+
+class RenderGraph;
+using RenderGraphPtr = std::shared_ptr<RenderGraph>;
+
+/**
+ * @class RenderGraph
+ * @brief Frame graph that owns, schedules and aliases its pass attachments
+ *
+ * @note Transient attachments are always textures, so a single allocation can
+ *       back attachments of several pass framebuffers.
+ * @note Passes are scheduled by their read-after-write dependencies. A read
+ *       is served by the last writer declared before the pass, or by the first
+ *       one declared after it if there is none. Independent passes keep their
+ *       declaration order.
+ */
+class RenderGraph {
+public:
+    using ResourceHandle = int;
+
+    /** @brief Handle of the default framebuffer (window). Always an output. */
+    static constexpr ResourceHandle Backbuffer = 0;
+
+    /**
+     * @struct TransientDesc
+     * @brief Description of a graph-owned attachment
+     */
+    struct TransientDesc {
+        attachment::Format format = attachment::Format::RGBA8;                    ///< Internal format
+        float scale = 1.0f;                                                       ///< Size relative to the viewport
+        int width = 0;                                                            ///< Absolute width (overrides scale when > 0)
+        int height = 0;                                                           ///< Absolute height (overrides scale when > 0)
+        attachment::TextureFilter filter = attachment::TextureFilter::Linear;     ///< Sampling filter
+        attachment::TextureWrap wrap = attachment::TextureWrap::ClampToEdge;      ///< Sampling wrap mode
+    };
+
+    /**
+     * @struct MemoryStats
+     * @brief Transient attachment memory of the last compile
+     */
+    struct MemoryStats {
+        size_t transient_resources = 0;      ///< Attachments used by surviving passes
+        size_t physical_textures = 0;        ///< Textures actually allocated for them
+        size_t bytes_without_aliasing = 0;   ///< Peak bytes if every attachment had its own texture
+        size_t bytes_with_aliasing = 0;      ///< Peak bytes with lifetime-based sharing
+    };
+
+    class Pass;
+    using PassPtr = std::shared_ptr<Pass>;
+
+    /**
+     * @class PassContext
+     * @brief Handed to a pass's execute function
+     */
+    class PassContext {
+    private:
+        const RenderGraph* m_graph;
+        int m_width;
+        int m_height;
+
+        PassContext(const RenderGraph* graph, int width, int height)
+            : m_graph(graph), m_width(width), m_height(height) {}
+        friend class RenderGraph;
+
+    public:
+        /**
+         * @brief Gets the texture currently backing a transient attachment
+         * @throws exception::FramebufferException if the handle has no texture
+         */
+        texture::TexturePtr getTexture(ResourceHandle handle) const { return m_graph->getTexture(handle); }
+
+        /** @brief Width of the pass's render target in pixels */
+        int getWidth() const { return m_width; }
+
+        /** @brief Height of the pass's render target in pixels */
+        int getHeight() const { return m_height; }
+    };
+
+    using ExecuteFunction = std::function<void(const PassContext&)>;
+
+    /**
+     * @class Pass
+     * @brief A single render pass and its declared attachment usage
+     */
+    class Pass : public std::enable_shared_from_this<Pass> {
+    private:
+        std::string m_name;
+        ExecuteFunction m_execute;
+        std::vector<ResourceHandle> m_reads;
+        std::vector<ResourceHandle> m_writes;
+        bool m_never_cull = false;
+
+        // Compile results
+        bool m_alive = false;
+        FramebufferPtr m_fbo;
+
+        Pass(const std::string& name, ExecuteFunction execute)
+            : m_name(name), m_execute(std::move(execute)) {}
+        friend class RenderGraph;
+
+    public:
+        /** @brief Declares that this pass samples the given attachment */
+        PassPtr read(ResourceHandle handle) {
+            m_reads.push_back(handle);
+            return shared_from_this();
+        }
+
+        /** @brief Declares that this pass renders into the given attachment */
+        PassPtr write(ResourceHandle handle) {
+            m_writes.push_back(handle);
+            return shared_from_this();
+        }
+
+        /** @brief Keeps the pass even if nothing reads its output (e.g. readbacks) */
+        PassPtr setNeverCull(bool never_cull = true) {
+            m_never_cull = never_cull;
+            return shared_from_this();
+        }
+
+        const std::string& getName() const { return m_name; }
+
+        /** @brief Whether the pass survived culling in the last compile */
+        bool isAlive() const { return m_alive; }
+    };
+
+private:
+    struct Resource {
+        std::string name;
+        TransientDesc desc;
+        bool is_output = false;
+        // Compile results
+        int width = 0;
+        int height = 0;
+        int first_use = INT_MAX;
+        int last_use = -1;
+        int physical = -1;
+    };
+
+    struct PhysicalTexture {
+        int width;
+        int height;
+        attachment::Format format;
+        attachment::TextureFilter filter;
+        attachment::TextureWrap wrap;
+        texture::TexturePtr texture;
+        int last_use = -1;
+
+        bool matches(const Resource& r) const {
+            return width == r.width && height == r.height && format == r.desc.format &&
+                   filter == r.desc.filter && wrap == r.desc.wrap;
+        }
+
+        size_t bytes() const {
+            return static_cast<size_t>(width) * static_cast<size_t>(height) * attachment::bytesPerPixel(format);
+        }
+    };
+
+    std::vector<Resource> m_resources;
+    std::vector<PassPtr> m_passes;
+    std::vector<int> m_order;  // Indices into m_passes, in execution order
+    std::vector<PhysicalTexture> m_physical;
+    MemoryStats m_memory_stats;
+    bool m_compiled = false;
+    int m_compiled_width = 0;
+    int m_compiled_height = 0;
+
+    RenderGraph() {
+        Resource backbuffer;
+        backbuffer.name = "Backbuffer";
+        backbuffer.is_output = true;
+        m_resources.push_back(backbuffer);
+    }
+
+    bool isValidHandle(ResourceHandle handle) const {
+        return handle >= 0 && handle < static_cast<int>(m_resources.size());
+    }
+
+    static bool isDepthFormat(attachment::Format format) {
+        return format == attachment::Format::DepthComponent16 ||
+               format == attachment::Format::DepthComponent24 ||
+               format == attachment::Format::DepthComponent32 ||
+               format == attachment::Format::DepthComponent32F;
+    }
+
+    /**
+     * @brief Orders the passes by their read-after-write dependencies (stable topological sort).
+     *
+     * Writers of an attachment keep their declaration order. A pass that
+     * reads it runs after the writer it reads from and before the next one.
+     *
+     * @throws exception::FramebufferException if a read has no writer or the dependencies form a cycle
+     */
+    void schedulePasses() {
+        const size_t count = m_passes.size();
+        std::vector<std::vector<int>> successors(count);
+        std::vector<int> pending(count, 0);
+        auto depend = [&](int before, int after) {
+            successors[before].push_back(after);
+            pending[after]++;
+        };
+
+        std::vector<std::vector<int>> writers(m_resources.size());
+        for (size_t p = 0; p < count; ++p) {
+            for (ResourceHandle w : m_passes[p]->m_writes) {
+                if (writers[w].empty() || writers[w].back() != static_cast<int>(p)) {
+                    writers[w].push_back(static_cast<int>(p));
+                }
+            }
+        }
+        for (const auto& list : writers) {
+            for (size_t i = 1; i < list.size(); ++i) {
+                depend(list[i - 1], list[i]);
+            }
+        }
+
+        for (size_t p = 0; p < count; ++p) {
+            const Pass& pass = *m_passes[p];
+            for (ResourceHandle r : pass.m_reads) {
+                if (r == Backbuffer) continue;
+                const std::vector<int>& list = writers[r];
+                if (list.empty()) {
+                    throw exception::FramebufferException(
+                        "RenderGraph pass '" + pass.m_name + "' reads '" + m_resources[r].name +
+                        "', which no pass writes");
+                }
+                if (std::find(list.begin(), list.end(), static_cast<int>(p)) != list.end()) {
+                    continue;  // Read-modify-write; ordered with the other writers
+                }
+                size_t source = 0;
+                while (source + 1 < list.size() && list[source + 1] < static_cast<int>(p)) {
+                    ++source;
+                }
+                depend(list[source], static_cast<int>(p));
+                if (source + 1 < list.size()) {
+                    depend(static_cast<int>(p), list[source + 1]);
+                }
+            }
+        }
+
+        // Kahn's algorithm, always taking the earliest declared ready pass
+        m_order.clear();
+        std::vector<bool> scheduled(count, false);
+        while (m_order.size() < count) {
+            int next = -1;
+            for (size_t p = 0; p < count; ++p) {
+                if (!scheduled[p] && pending[p] == 0) {
+                    next = static_cast<int>(p);
+                    break;
+                }
+            }
+            if (next < 0) {
+                throw exception::FramebufferException("RenderGraph passes have a circular dependency");
+            }
+            scheduled[next] = true;
+            m_order.push_back(next);
+            for (int s : successors[next]) {
+                pending[s]--;
+            }
+        }
+    }
+
+    /**
+     * @brief Marks passes that contribute to an output, walking the schedule backwards.
+     */
+    void cullPasses() {
+        std::vector<bool> needed(m_resources.size(), false);
+        for (size_t r = 0; r < m_resources.size(); ++r) {
+            needed[r] = m_resources[r].is_output;
+        }
+
+        for (auto it = m_order.rbegin(); it != m_order.rend(); ++it) {
+            Pass& pass = *m_passes[*it];
+            pass.m_alive = pass.m_never_cull;
+            for (ResourceHandle w : pass.m_writes) {
+                if (needed[w]) {
+                    pass.m_alive = true;
+                }
+            }
+            if (!pass.m_alive) {
+                continue;
+            }
+            // Earlier writers of these attachments are overwritten, unless this pass also reads them
+            for (ResourceHandle w : pass.m_writes) {
+                if (!m_resources[w].is_output) {
+                    needed[w] = false;
+                }
+            }
+            for (ResourceHandle r : pass.m_reads) {
+                needed[r] = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Computes sizes and first/last use of every transient attachment.
+     */
+    void computeLifetimes(int viewport_width, int viewport_height) {
+        for (size_t r = 1; r < m_resources.size(); ++r) {
+            Resource& res = m_resources[r];
+            res.first_use = INT_MAX;
+            res.last_use = -1;
+            res.physical = -1;
+            res.width = res.desc.width > 0 ? res.desc.width
+                      : std::max(1, static_cast<int>(viewport_width * res.desc.scale));
+            res.height = res.desc.height > 0 ? res.desc.height
+                       : std::max(1, static_cast<int>(viewport_height * res.desc.scale));
+        }
+
+        for (size_t p = 0; p < m_order.size(); ++p) {
+            const Pass& pass = *m_passes[m_order[p]];
+            if (!pass.m_alive) continue;
+
+            auto touch = [&](ResourceHandle handle) {
+                if (handle == Backbuffer) return;
+                Resource& res = m_resources[handle];
+                res.first_use = std::min(res.first_use, static_cast<int>(p));
+                res.last_use = std::max(res.last_use, static_cast<int>(p));
+            };
+            for (ResourceHandle h : pass.m_reads) touch(h);
+            for (ResourceHandle h : pass.m_writes) touch(h);
+        }
+
+        // Outputs must survive until the end of the frame
+        for (size_t r = 1; r < m_resources.size(); ++r) {
+            if (m_resources[r].is_output && m_resources[r].last_use >= 0) {
+                m_resources[r].last_use = INT_MAX;
+            }
+        }
+    }
+
+    /**
+     * @brief Assigns textures to attachments, sharing them across disjoint lifetimes.
+     *
+     * Textures from the previous compile are reused when they still match,
+     * so recompiling an unchanged graph allocates nothing.
+     */
+    void assignPhysicalTextures() {
+        std::vector<int> order;
+        for (size_t r = 1; r < m_resources.size(); ++r) {
+            if (m_resources[r].last_use >= 0) order.push_back(static_cast<int>(r));
+        }
+        std::sort(order.begin(), order.end(), [this](int a, int b) {
+            return m_resources[a].first_use < m_resources[b].first_use;
+        });
+
+        std::vector<PhysicalTexture> previous = std::move(m_physical);
+        m_physical.clear();
+        m_memory_stats = MemoryStats{};
+
+        for (int r : order) {
+            Resource& res = m_resources[r];
+            m_memory_stats.transient_resources++;
+            m_memory_stats.bytes_without_aliasing += static_cast<size_t>(res.width) * res.height *
+                                                     attachment::bytesPerPixel(res.desc.format);
+
+            for (size_t i = 0; i < m_physical.size(); ++i) {
+                if (m_physical[i].matches(res) && m_physical[i].last_use < res.first_use) {
+                    res.physical = static_cast<int>(i);
+                    m_physical[i].last_use = res.last_use;
+                    break;
+                }
+            }
+            if (res.physical >= 0) continue;
+
+            PhysicalTexture slot{res.width, res.height, res.desc.format, res.desc.filter, res.desc.wrap, nullptr, res.last_use};
+            for (auto it = previous.begin(); it != previous.end(); ++it) {
+                if (it->matches(res)) {
+                    slot.texture = it->texture;
+                    previous.erase(it);
+                    break;
+                }
+            }
+            if (!slot.texture) {
+                Framebuffer::AttachmentSpec spec(
+                    isDepthFormat(res.desc.format) ? attachment::Point::Depth : attachment::Point::Color0,
+                    res.desc.format, attachment::StorageType::Texture, res.name,
+                    res.desc.filter, res.desc.wrap);
+                slot.texture = Framebuffer::allocateAttachmentTexture(res.width, res.height, spec);
+            }
+            res.physical = static_cast<int>(m_physical.size());
+            m_physical.push_back(slot);
+        }
+
+        m_memory_stats.physical_textures = m_physical.size();
+        for (const auto& slot : m_physical) {
+            m_memory_stats.bytes_with_aliasing += slot.bytes();
+        }
+        // Textures left in 'previous' are released here
+    }
+
+    /**
+     * @brief Builds the framebuffer each surviving pass renders into.
+     */
+    void buildPassFramebuffers() {
+        for (auto& pass_ptr : m_passes) {
+            Pass& pass = *pass_ptr;
+            pass.m_fbo = nullptr;
+            if (!pass.m_alive) continue;
+
+            bool writes_backbuffer = std::find(pass.m_writes.begin(), pass.m_writes.end(), Backbuffer) != pass.m_writes.end();
+            if (writes_backbuffer) {
+                if (pass.m_writes.size() > 1) {
+                    std::cerr << "Warning: RenderGraph pass '" << pass.m_name
+                              << "' writes the backbuffer; its other writes are ignored." << std::endl;
+                }
+                continue;
+            }
+            if (pass.m_writes.empty()) continue;
+
+            std::vector<Framebuffer::SharedAttachment> attachments;
+            int color_index = 0;
+            int width = 0, height = 0;
+            bool loads_previous = false;
+            for (ResourceHandle h : pass.m_writes) {
+                const Resource& res = m_resources[h];
+                attachment::Point point;
+                if (isDepthFormat(res.desc.format)) {
+                    point = attachment::Point::Depth;
+                } else if (res.desc.format == attachment::Format::Depth24Stencil8) {
+                    point = attachment::Point::DepthStencil;
+                } else if (res.desc.format == attachment::Format::StencilIndex8) {
+                    point = attachment::Point::Stencil;
+                } else if (color_index < 8) {
+                    point = static_cast<attachment::Point>(static_cast<int>(attachment::Point::Color0) + color_index++);
+                } else {
+                    std::cerr << "Warning: RenderGraph pass '" << pass.m_name
+                              << "' writes more than 8 color attachments. Ignoring '" << res.name << "'." << std::endl;
+                    continue;
+                }
+                if (width == 0) {
+                    width = res.width;
+                    height = res.height;
+                } else if (width != res.width || height != res.height) {
+                    throw exception::FramebufferException(
+                        "RenderGraph pass '" + pass.m_name + "' writes attachments of different sizes");
+                }
+                if (std::find(pass.m_reads.begin(), pass.m_reads.end(), h) != pass.m_reads.end()) {
+                    loads_previous = true;
+                }
+                attachments.push_back({point, res.name, m_physical[res.physical].texture});
+            }
+
+            pass.m_fbo = Framebuffer::MakeFromTextures(width, height, attachments);
+            // Read-modify-write passes must keep the previous contents
+            pass.m_fbo->setClearOnBind(!loads_previous);
+        }
+    }
+
+public:
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    /** @brief Factory method */
+    static RenderGraphPtr Make() {
+        return RenderGraphPtr(new RenderGraph());
+    }
+
+    /**
+     * @brief Declares a graph-owned attachment
+     * @param name Name used for warnings and texture retrieval
+     * @param desc Format and size (relative to viewport by default)
+     * @return Handle to use in Pass::read / Pass::write
+     */
+    ResourceHandle createTransient(const std::string& name, const TransientDesc& desc) {
+        Resource res;
+        res.name = name;
+        res.desc = desc;
+        m_resources.push_back(res);
+        m_compiled = false;
+        return static_cast<ResourceHandle>(m_resources.size() - 1);
+    }
+
+    /**
+     * @brief Marks a transient attachment as an output of the graph
+     *
+     * Outputs keep their producing passes alive, are never aliased, and can
+     * be retrieved with getTexture() after execute().
+     */
+    void setOutput(ResourceHandle handle) {
+        if (!isValidHandle(handle)) {
+            std::cerr << "Warning: RenderGraph::setOutput called with invalid handle " << handle << "." << std::endl;
+            return;
+        }
+        m_resources[handle].is_output = true;
+        m_compiled = false;
+    }
+
+    /**
+     * @brief Appends a pass
+     * @param name Pass name (for warnings)
+     * @param execute Draw calls of the pass; its framebuffer is already pushed
+     * @return The pass, to chain read()/write() declarations
+     */
+    PassPtr addPass(const std::string& name, ExecuteFunction execute) {
+        PassPtr pass(new Pass(name, std::move(execute)));
+        m_passes.push_back(pass);
+        m_compiled = false;
+        return pass;
+    }
+
+    /**
+     * @brief Culls, schedules and allocates the graph for a viewport size
+     * @throws exception::FramebufferException on invalid declarations, reads
+     *         without a writer, or circular dependencies
+     */
+    void compile(int viewport_width, int viewport_height) {
+        for (const auto& pass : m_passes) {
+            for (ResourceHandle h : pass->m_reads) {
+                if (!isValidHandle(h)) throw exception::FramebufferException(
+                    "RenderGraph pass '" + pass->m_name + "' reads an invalid handle");
+            }
+            for (ResourceHandle h : pass->m_writes) {
+                if (!isValidHandle(h)) throw exception::FramebufferException(
+                    "RenderGraph pass '" + pass->m_name + "' writes an invalid handle");
+            }
+        }
+
+        schedulePasses();
+        cullPasses();
+        computeLifetimes(viewport_width, viewport_height);
+        assignPhysicalTextures();
+        buildPassFramebuffers();
+
+        m_compiled = true;
+        m_compiled_width = viewport_width;
+        m_compiled_height = viewport_height;
+    }
+
+    /**
+     * @brief Runs every surviving pass in schedule order
+     *
+     * Recompiles automatically when the graph changed or the window was resized.
+     */
+    void execute() {
+        int viewport_width = 0, viewport_height = 0;
+        stack()->getDefaultSize(viewport_width, viewport_height);
+        if (!m_compiled || viewport_width != m_compiled_width || viewport_height != m_compiled_height) {
+            compile(viewport_width, viewport_height);
+        }
+
+        for (int index : m_order) {
+            const PassPtr& pass = m_passes[index];
+            if (!pass->m_alive) continue;
+
+            int width = pass->m_fbo ? pass->m_fbo->getWidth() : viewport_width;
+            int height = pass->m_fbo ? pass->m_fbo->getHeight() : viewport_height;
+
+            framebuffer::stack()->push(pass->m_fbo);
+            if (pass->m_execute) {
+                pass->m_execute(PassContext(this, width, height));
+            }
+            framebuffer::stack()->pop();
+        }
+    }
+
+    /**
+     * @brief Gets the texture backing a transient attachment in the last compile
+     * @throws exception::FramebufferException if the attachment was culled or is the backbuffer
+     */
+    texture::TexturePtr getTexture(ResourceHandle handle) const {
+        if (!isValidHandle(handle) || handle == Backbuffer || m_resources[handle].physical < 0) {
+            throw exception::FramebufferException("RenderGraph attachment has no texture (culled or not compiled)");
+        }
+        return m_physical[m_resources[handle].physical].texture;
+    }
+
+    /** @brief Transient memory of the last compile, before and after aliasing */
+    const MemoryStats& getMemoryStats() const { return m_memory_stats; }
+
+    /** @brief Prints the memory stats and the culled passes of the last compile */
+    void printMemoryStats() const {
+        std::cout << "RenderGraph: " << m_memory_stats.transient_resources << " attachments -> "
+                  << m_memory_stats.physical_textures << " textures, "
+                  << m_memory_stats.bytes_without_aliasing / 1024 << " KiB without aliasing, "
+                  << m_memory_stats.bytes_with_aliasing / 1024 << " KiB with aliasing" << std::endl;
+        for (const auto& pass : m_passes) {
+            if (!pass->m_alive) {
+                std::cout << "  culled pass: " << pass->m_name << std::endl;
+            }
+        }
+    }
+
+    /** @brief Removes all passes and attachments and releases their textures */
+    void clear() {
+        m_passes.clear();
+        m_order.clear();
+        m_resources.resize(1);
+        m_physical.clear();
+        m_memory_stats = MemoryStats{};
+        m_compiled = false;
+    }
+};
+
+} // namespace framebuffer
+
+#endif // RENDER_GRAPH_H
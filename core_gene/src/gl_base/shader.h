@@ -18,6 +18,8 @@
 #include "gl_includes.h"
 #include "i_shader.h"
 #include "error.h"
+#include "gl_state.h"
+#include "frame_stats.h"
 #include "uniforms/uniform.h"
 #include "uniforms/pending_uniform_command.h"
 #include "uniforms/global_resource_manager.h"
@@ -142,6 +144,7 @@ private:
         for (const auto& command : m_pending_uniform_queue) {
             command.Execute(m_pid);
         }
+        stats::current().uniform_uploads += m_pending_uniform_queue.size();
         m_pending_uniform_queue.clear();
     }
     
@@ -151,6 +154,7 @@ private:
      */
     template<typename T>
     void _setUniform(GLint location, const T& value) {
+        ++stats::current().uniform_uploads;
         if constexpr (std::is_same_v<T, int>) {
             glUniform1i(location, value);
         } else if constexpr (std::is_same_v<T, float>) {
@@ -334,6 +338,7 @@ public:
     virtual ~Shader() {
         if (m_pid > 0) {
             glDeleteProgram(m_pid);
+            gl_state::cache()->onProgramDeleted(m_pid);
         }
     }
 
@@ -457,6 +462,7 @@ public:
         for (const auto& [name, uniform_ptr] : m_static_uniforms) {
             uniform_ptr->apply();
         }
+        stats::current().uniform_uploads += m_static_uniforms.size();
     }
 
     // --- Tier 3: Dynamic Uniform Configuration & Application ---
@@ -486,6 +492,7 @@ public:
         for (const auto& [name, uniform_ptr] : m_dynamic_uniforms) {
             uniform_ptr->apply();
         }
+        stats::current().uniform_uploads += m_dynamic_uniforms.size();
     }
     
     // --- Tier 4: Immediate-Mode Uniforms ---
@@ -548,7 +555,7 @@ public:
         if (m_is_dirty) {
             Bake();
         }
-        glUseProgram(m_pid);
+        gl_state::cache()->useProgram(m_pid);
         m_is_currently_active_in_GL = true; // Set active flag
         validateUniforms();
         applyStaticUniforms();  // Apply Tier 2 uniforms
@@ -622,6 +629,7 @@ public:
             // Activate the new shader (this also Bakes if dirty, and applies Tier 2 and Tier 4 uniforms)
             current_shader->UseProgram();
             last_used_shader = current_shader;
+            ++stats::current().program_switches;
         }
 
         // Apply per-draw (Tier 3) uniforms
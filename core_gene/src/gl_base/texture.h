@@ -13,6 +13,8 @@
 
 #include "gl_includes.h"
 #include "error.h"
+#include "gl_state.h"
+#include "frame_stats.h"
 
 // This implementation uses the popular stb_image library for loading images.
 // You'll need to add stb_image.h to your project and define STB_IMAGE_IMPLEMENTATION
@@ -50,7 +52,7 @@ using TextureStackPtr = std::shared_ptr<TextureStack>;
 // Helper function to load image data and configure an OpenGL texture.
 // This parallels the MakeShader function in shader.h.
 static void LoadAndConfigureTexture(GLuint tid, const std::string& filename, int& width, int& height) {
-    glBindTexture(GL_TEXTURE_2D, tid);
+    gl_state::cache()->bindTexture(GL_TEXTURE_2D, tid);
     GL_CHECK("bind texture for configuration");
 
     // Set texture wrapping and filtering options
@@ -109,7 +111,7 @@ static void LoadAndConfigureTexture(GLuint tid, const std::string& filename, int
 
     // Free the image data from CPU memory
     stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state::cache()->bindTexture(GL_TEXTURE_2D, 0);
 }
 
 
@@ -151,7 +153,7 @@ protected:
             return;
         }
 
-        glBindTexture(GL_TEXTURE_2D, m_tid);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, m_tid);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -160,7 +162,7 @@ protected:
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, 0);
     }
 public:
     static TexturePtr Make(const std::string& filename) {
@@ -187,16 +189,15 @@ public:
     }
     ~Texture() {
         glDeleteTextures(1, &m_tid);
+        gl_state::cache()->onTextureDeleted(m_tid);
     }
     
     // ITexture interface implementation
     void Bind(GLuint unit = 0) const override {
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(GL_TEXTURE_2D, m_tid);
+        gl_state::cache()->bindTexture(unit, GL_TEXTURE_2D, m_tid);
     }
     void Unbind(GLuint unit = 0) const override {
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl_state::cache()->bindTexture(unit, GL_TEXTURE_2D, 0);
     }
 
     GLuint GetTextureID() const override {
@@ -223,10 +224,10 @@ public:
      * increase rendering speed and reduce aliasing artifacts.
      */
     void generateMipmaps() {
-        glBindTexture(GL_TEXTURE_2D, m_tid);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, m_tid);
         glGenerateMipmap(GL_TEXTURE_2D);
         GL_CHECK("generate mipmaps");
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, 0);
     }
 
     /**
@@ -241,13 +242,13 @@ public:
      * @param magFilter Magnification filter (e.g., GL_LINEAR, GL_NEAREST)
      */
     void setTextureParameters(GLenum wrapS, GLenum wrapT, GLenum minFilter, GLenum magFilter) {
-        glBindTexture(GL_TEXTURE_2D, m_tid);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, m_tid);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
         GL_CHECK("set texture parameters");
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl_state::cache()->bindTexture(GL_TEXTURE_2D, 0);
     }
 };
 
@@ -256,100 +257,123 @@ public:
 class TextureStack {
 private:
     // This is the core of the state machine.
-    // It's a stack of maps. Each map represents the complete texture state
-    // (all active units) at that point in the scene graph.
-    std::vector<std::unordered_map<GLuint, ITexturePtr>> m_stack;
+    // m_state holds the complete texture state (one texture per unit) at the
+    // current point in the scene graph; every push logs the texture it replaced,
+    // so pop only has to restore that one unit. Both vectors keep their capacity,
+    // so a traversal does not allocate once they have grown to the scene's needs.
+    struct Change {
+        GLuint unit;
+        ITexturePtr previous;
+    };
+    std::vector<ITexturePtr> m_state;
+    std::vector<Change> m_undo;
+
     // This map links a sampler uniform name to a texture unit.
-    std::unordered_map<std::string, GLuint> m_sampler_to_unit_map;
+    // Entries are deactivated instead of erased, so re-registering the same
+    // sampler every frame does not allocate a new node.
+    struct SamplerBinding {
+        GLuint unit;
+        bool registered;
+    };
+    std::unordered_map<std::string, SamplerBinding> m_sampler_to_unit_map;
 
-    // This map tracks the ACTUAL state on the GPU to prevent redundant calls.
-    std::unordered_map<GLuint, ITexturePtr> m_active_gpu_state;
+    // This tracks the ACTUAL state on the GPU (per unit) to prevent redundant calls.
+    std::vector<ITexturePtr> m_active_gpu_state;
 
-    TextureStack() {
-        // Start with a base level on the stack representing the default (empty) state.
-        m_stack.push_back({});
-    }
+    TextureStack() {}
     friend TextureStackPtr stack();
 
+    void ensureUnit(GLuint unit) {
+        if (unit >= m_state.size()) {
+            m_state.resize(unit + 1);
+            m_active_gpu_state.resize(unit + 1);
+        }
+    }
+
 public:
     TextureStack(const TextureStack&) = delete;
     TextureStack& operator=(const TextureStack&) = delete;
 
+    // Returns the texture bound to the lowest active unit, if any.
     ITexturePtr top() {
-        if (m_stack.empty()) {
-            return nullptr;
-        }
-        auto& state = m_stack.back();
-        if (state.empty()) {
-            return nullptr;
+        for (const auto& texture : m_state) {
+            if (texture) {
+                return texture;
+            }
         }
-        return state.begin()->second;
+        return nullptr;
     }
 
     // The intelligent push operation.
     void push(ITexturePtr texture, GLuint unit = 0) {
-        // 1. Get the state from the previous level of the stack.
-        auto new_state = m_stack.back();
-        // 2. Modify it with the new texture.
-        new_state[unit] = texture;
-        // 3. Push the new, complete state onto our stack.
-        m_stack.push_back(new_state);
+        ensureUnit(unit);
+        // 1. Remember what this unit held, so pop() can restore it.
+        m_undo.push_back(Change{unit, m_state[unit]});
+        // 2. Modify the current state with the new texture.
+        m_state[unit] = texture;
 
         // --- Non-repeating logic is here ---
-        // 4. Only bind if the GPU state for this unit is different.
+        // 3. Only bind if the GPU state for this unit is different.
         if (m_active_gpu_state[unit] != texture) {
             texture->Bind(unit);
-            m_active_gpu_state[unit] = texture; // Update our cache
+            m_active_gpu_state[unit] = std::move(texture); // Update our cache
+            ++stats::current().texture_binds;
         }
     }
 
     // The intelligent pop operation.
     void pop() {
-        if (m_stack.size() <= 1) {
+        if (m_undo.empty()) {
             std::cerr << "Warning: Attempt to pop the base texture state." << std::endl;
             return;
         }
 
-        // 1. Remove the current state from the stack.
-        m_stack.pop_back();
-        // 2. Get the state we are restoring to.
-        const auto& state_to_restore = m_stack.back();
+        // 1. Restore the unit changed by the matching push.
+        Change& change = m_undo.back();
+        GLuint unit = change.unit;
+        m_state[unit] = std::move(change.previous);
+        m_undo.pop_back();
 
         // --- Non-repeating logic is here ---
-        // 3. Synchronize the GPU state with the state we are restoring.
-        // This is more complex: we check for changes and apply them.
-        for (auto const& [unit, tex] : m_active_gpu_state) {
-            // If the unit in the state-to-restore is different from the active one...
-            if (state_to_restore.count(unit) == 0 || state_to_restore.at(unit) != tex) {
-                // ... we need to update the binding.
-                if (state_to_restore.count(unit)) {
-                    // Restore to the previous texture
-                    state_to_restore.at(unit)->Bind(unit);
-                } else {
-                    // Or unbind if this unit is no longer used
-                    tex->Unbind(unit);
-                }
+        // 2. Synchronize the GPU state for that unit; the others did not change.
+        const ITexturePtr& restored = m_state[unit];
+        ITexturePtr& active = m_active_gpu_state[unit];
+        if (active != restored) {
+            if (restored) {
+                // Restore to the previous texture
+                restored->Bind(unit);
+            } else {
+                // Or unbind if this unit is no longer used
+                active->Unbind(unit);
             }
+            active = restored;
+            ++stats::current().texture_binds;
         }
-        // 4. Update our cache to match the new state.
-        m_active_gpu_state = state_to_restore;
     }
 
     // NEW: Called by TextureComponent during its 'apply' phase.
     void registerSamplerUnit(const std::string& sampler_name, GLuint unit) {
-        m_sampler_to_unit_map[sampler_name] = unit;
+        auto it = m_sampler_to_unit_map.find(sampler_name);
+        if (it != m_sampler_to_unit_map.end()) {
+            it->second = SamplerBinding{unit, true};
+        } else {
+            m_sampler_to_unit_map.emplace(sampler_name, SamplerBinding{unit, true});
+        }
     }
 
     // NEW: Called by TextureComponent during its 'unapply' phase.
     void unregisterSamplerUnit(const std::string& sampler_name) {
-        m_sampler_to_unit_map.erase(sampler_name);
+        auto it = m_sampler_to_unit_map.find(sampler_name);
+        if (it != m_sampler_to_unit_map.end()) {
+            it->second.registered = false;
+        }
     }
 
     // NEW: Called by the shader's uniform provider to get the current unit for a sampler.
     GLuint getUnitForSampler(const std::string& sampler_name) const {
         auto it = m_sampler_to_unit_map.find(sampler_name);
-        if (it != m_sampler_to_unit_map.end()) {
-            return it->second;
+        if (it != m_sampler_to_unit_map.end() && it->second.registered) {
+            return it->second.unit;
         }
         // Return 0 and log a warning if the sampler isn't registered.
         // Returning 0 is often a safe default.
@@ -4,11 +4,16 @@
 
 #include <memory>
 #include "gl_includes.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
 #include <vector>
 #include <iostream>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include "../utils/observer_interface.h"
+#include "../utils/simd_math.h"
 
 namespace transform {
     
@@ -18,15 +23,138 @@ using TransformPtr = std::shared_ptr<Transform>;
 class TransformStack;
 using TransformStackPtr = std::shared_ptr<TransformStack>;
 
-// Inherit from ISubject to make it observable
+class Interpolator;
+Interpolator& interpolation();
+
+/**
+ * @class Transform
+ * @brief An observable local transform, stored as a matrix or as position/rotation/scale
+ *
+ * Transform::Make() stores a glm::mat4. Changes are reported with
+ * notifyDeferred(), so observers hear about any number of changes once, at the
+ * next observer::flush(); the scene graph flushes before every world transform
+ * update.
+ *
+ * Transform::MakeTRS() stores a position, a quaternion rotation and a scale, and
+ * composes the matrix (translation * rotation * scale) the first time it is read
+ * after a change, so any number of setters between two frames cost one matrix
+ * composition. setPosition(), setRotation() and setScaling() return a plain
+ * reference and do not touch the shared_ptr reference count.
+ *
+ * An interpolated TRS transform (setInterpolated()) also keeps its values from
+ * before the current fixed update, and its matrix blends the two with the
+ * frame's alpha; see transform::Interpolator.
+ *
+ * Change a transform from one thread at a time, and not while a scene update
+ * pass is reading it; reading it from several jobs at once is safe.
+ */
 class Transform : public std::enable_shared_from_this<Transform>, public ISubject {
-    glm::mat4 matrix;
+    enum MatrixState : uint8_t {
+        MATRIX_CLEAN,       // `matrix` matches the TRS values (always, for matrix transforms)
+        MATRIX_DIRTY,       // TRS values changed since the last read
+        MATRIX_COMPOSING    // A reader is composing the matrix
+    };
+
+    mutable glm::mat4 matrix;
+    glm::vec3 m_position{0.0f};
+    glm::quat m_rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 m_scaling{1.0f};
+    bool m_trs = false;
+    mutable std::atomic<uint8_t> m_matrix_state{MATRIX_CLEAN};
+
+    // Interpolation: values before the current fixed update, and how far to blend towards the current ones
+    glm::vec3 m_previous_position{0.0f};
+    glm::quat m_previous_rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 m_previous_scaling{1.0f};
+    float m_alpha = 1.0f;
+    size_t m_interpolation_slot = NOT_INTERPOLATED;
+
+    static constexpr size_t NOT_INTERPOLATED = static_cast<size_t>(-1);
+
+    friend class Interpolator;
+
     Transform() {
         matrix = glm::mat4(1.0f);
     }
     Transform(glm::mat4 matrix) :
         matrix(matrix)
     {}
+    Transform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scaling) :
+        matrix(1.0f),
+        m_position(position),
+        m_rotation(rotation),
+        m_scaling(scaling),
+        m_trs(true),
+        m_matrix_state(MATRIX_DIRTY)
+    {
+        composeMatrix();
+    }
+
+    void composeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scaling) const {
+        const glm::mat3 basis = glm::mat3_cast(rotation);
+        matrix[0] = glm::vec4(basis[0] * scaling.x, 0.0f);
+        matrix[1] = glm::vec4(basis[1] * scaling.y, 0.0f);
+        matrix[2] = glm::vec4(basis[2] * scaling.z, 0.0f);
+        matrix[3] = glm::vec4(position, 1.0f);
+    }
+
+    void composeMatrix() const {
+        uint8_t expected = MATRIX_DIRTY;
+        if (m_matrix_state.compare_exchange_strong(expected, MATRIX_COMPOSING, std::memory_order_acquire)) {
+            if (m_alpha < 1.0f) {
+                composeMatrix(glm::mix(m_previous_position, m_position, m_alpha),
+                              glm::slerp(m_previous_rotation, m_rotation, m_alpha),
+                              glm::mix(m_previous_scaling, m_scaling, m_alpha));
+            } else {
+                composeMatrix(m_position, m_rotation, m_scaling);
+            }
+            m_matrix_state.store(MATRIX_CLEAN, std::memory_order_release);
+            return;
+        }
+        // Another job of the same pass is composing it
+        while (m_matrix_state.load(std::memory_order_acquire) != MATRIX_CLEAN) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Flags the TRS values as changed; only the first change after a read queues a notification
+    void trsChanged() {
+        if (m_matrix_state.exchange(MATRIX_DIRTY, std::memory_order_acq_rel) == MATRIX_CLEAN) {
+            notifyDeferred();
+        }
+    }
+
+    // Switches a matrix transform to TRS, keeping its current matrix (without shear or projection)
+    void ensureTRS() {
+        if (m_trs) {
+            return;
+        }
+        glm::mat3 rotation(matrix);
+        m_scaling = glm::vec3(glm::length(rotation[0]), glm::length(rotation[1]), glm::length(rotation[2]));
+        if (glm::dot(glm::cross(rotation[0], rotation[1]), rotation[2]) < 0.0f) {
+            m_scaling.x = -m_scaling.x;  // Mirrored: keep the rotation proper
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (m_scaling[i] != 0.0f) {
+                rotation[i] /= m_scaling[i];
+            }
+        }
+        m_rotation = glm::normalize(glm::quat_cast(rotation));
+        m_position = glm::vec3(matrix[3]);
+        m_trs = true;
+    }
+
+    // Switches a TRS transform back to a plain matrix before a change TRS can't express
+    inline void ensureMatrix();
+
+    static glm::quat axisRotation(float angle_degrees, float axis_x, float axis_y, float axis_z) {
+        glm::vec3 axis(axis_x, axis_y, axis_z);
+        if (glm::length(axis) > 0.0f) {
+            axis = glm::normalize(axis);
+        }
+        return glm::angleAxis(glm::radians(angle_degrees), axis);
+    }
+
     public:
         static TransformPtr Make() {
             return TransformPtr(new Transform());
@@ -36,46 +164,148 @@ class Transform : public std::enable_shared_from_this<Transform>, public ISubjec
             return TransformPtr(new Transform(matrix));
         }
 
-        ~Transform()=default;
+        /**
+         * @brief Creates a transform stored as position, rotation and scale.
+         */
+        static TransformPtr MakeTRS(
+            const glm::vec3& position = glm::vec3(0.0f),
+            const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+            const glm::vec3& scaling = glm::vec3(1.0f)
+        ) {
+            return TransformPtr(new Transform(position, rotation, scaling));
+        }
+
+        inline ~Transform();
         
+        /**
+         * @brief Returns the matrix, composing it first if TRS values changed since the last read.
+         */
         const glm::mat4& getMatrix() const {
+            if (m_matrix_state.load(std::memory_order_acquire) != MATRIX_CLEAN) {
+                composeMatrix();
+            }
             return matrix;
         }
 
-        // --- Every method that modifies the matrix must call notify() ---
+        bool isTRS() const { return m_trs; }
+
+        // --- TRS access (a matrix transform is decomposed by the first TRS setter) ---
+
+        const glm::vec3& getPosition() const { return m_position; }
+        const glm::quat& getRotation() const { return m_rotation; }
+        const glm::vec3& getScaling() const { return m_scaling; }
+
+        Transform& setPosition(const glm::vec3& position) {
+            ensureTRS();
+            m_position = position;
+            trsChanged();
+            return *this;
+        }
+
+        Transform& setRotation(const glm::quat& rotation) {
+            ensureTRS();
+            m_rotation = rotation;
+            trsChanged();
+            return *this;
+        }
+
+        Transform& setScaling(const glm::vec3& scaling) {
+            ensureTRS();
+            m_scaling = scaling;
+            trsChanged();
+            return *this;
+        }
+
+        /**
+         * @brief Renders this transform blended between fixed updates (see Interpolator).
+         * Switches a matrix transform to TRS.
+         */
+        inline Transform& setInterpolated(bool interpolated);
+
+        bool isInterpolated() const { return m_interpolation_slot != NOT_INTERPOLATED; }
+
+        /**
+         * @brief Makes the next frames show the current values without blending from the
+         * previous ones, e.g. after a teleport.
+         */
+        Transform& snap() {
+            m_previous_position = m_position;
+            m_previous_rotation = m_rotation;
+            m_previous_scaling = m_scaling;
+            if (m_alpha < 1.0f) {
+                m_alpha = 1.0f;
+                trsChanged();
+            }
+            return *this;
+        }
+
+        Transform& setTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scaling) {
+            m_trs = true;
+            m_position = position;
+            m_rotation = rotation;
+            m_scaling = scaling;
+            trsChanged();
+            return *this;
+        }
+
+        // --- Every method that modifies the matrix must call notifyDeferred() (TRS changes: trsChanged()) ---
 
         TransformPtr reset() {
+            if (m_trs) {
+                setTRS(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+                return shared_from_this();
+            }
             matrix = glm::mat4(1.0f);
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr setMatrix(glm::mat4 new_matrix) {
+            ensureMatrix();
             this->matrix = new_matrix;
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr multiply(const glm::mat4& other) {
+            ensureMatrix();
             matrix = matrix * other;
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr translate(float x, float y, float z) {
+            if (m_trs) {
+                m_position += m_rotation * (m_scaling * glm::vec3(x, y, z));
+                trsChanged();
+                return shared_from_this();
+            }
             matrix = glm::translate(matrix, glm::vec3(x, y, z));
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr setTranslate(float x, float y, float z) {
-            reset();
-            translate(x, y, z);
-            notify();
+            if (m_trs) {
+                setTRS(glm::vec3(x, y, z), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+                return shared_from_this();
+            }
+            matrix = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
+            notifyDeferred();
             return shared_from_this();
         }
         
+        /**
+         * @brief Rotates in local space. On a TRS transform the rotation is combined
+         * with the current rotation, which matches the matrix result unless the
+         * scale is non-uniform.
+         */
         TransformPtr rotate(float angle_degrees, float axis_x, float axis_y, float axis_z) {
+            if (m_trs) {
+                m_rotation = glm::normalize(m_rotation * axisRotation(angle_degrees, axis_x, axis_y, axis_z));
+                trsChanged();
+                return shared_from_this();
+            }
             // checks if axis is normalized
             float angle_radians = glm::radians(angle_degrees);
             glm::vec3 axis(axis_x, axis_y, axis_z);
@@ -84,37 +314,178 @@ class Transform : public std::enable_shared_from_this<Transform>, public ISubjec
                 axis = glm::normalize(axis);
             }
             matrix = glm::rotate(matrix, angle_radians, axis);
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr setRotate(float angle_degrees, float axis_x, float axis_y, float axis_z) {
-            reset();
-            rotate(angle_degrees, axis_x, axis_y, axis_z);
-            notify();
+            if (m_trs) {
+                setTRS(glm::vec3(0.0f), axisRotation(angle_degrees, axis_x, axis_y, axis_z), glm::vec3(1.0f));
+                return shared_from_this();
+            }
+            float angle_radians = glm::radians(angle_degrees);
+            glm::vec3 axis(axis_x, axis_y, axis_z);
+
+            if (glm::length(axis) > 0.0f) {
+                axis = glm::normalize(axis);
+            }
+            matrix = glm::rotate(glm::mat4(1.0f), angle_radians, axis);
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr scale(float x, float y, float z) {
+            if (m_trs) {
+                m_scaling = m_scaling * glm::vec3(x, y, z);
+                trsChanged();
+                return shared_from_this();
+            }
             matrix = glm::scale(matrix, glm::vec3(x, y, z));
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr setScale(float x, float y, float z) {
-            reset();
-            scale(x, y, z);
-            notify();
+            if (m_trs) {
+                setTRS(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(x, y, z));
+                return shared_from_this();
+            }
+            matrix = glm::scale(glm::mat4(1.0f), glm::vec3(x, y, z));
+            notifyDeferred();
             return shared_from_this();
         }
 
         TransformPtr orthographic(float left, float right, float bottom, float top, float near, float far) {
+            ensureMatrix();
             matrix = glm::ortho(left, right, bottom, top, near, far);
-            notify();
+            notifyDeferred();
             return shared_from_this();
         }
 };
 
+/**
+ * @class Interpolator
+ * @brief Blends interpolated transforms between the last two fixed updates
+ *
+ * EnGene::run() calls beginStep() before every fixed update and setAlpha() with
+ * the frame's alpha before rendering. A transform that moved during the last
+ * fixed update is then drawn (and its world transform computed) at
+ * mix(previous, current, alpha), with slerp for the rotation, so a 30 Hz
+ * simulation moves smoothly on a 144 Hz display. Rendering is at most one fixed
+ * step behind the simulation.
+ *
+ * Position, rotation and scale getters always return the simulation's current
+ * values; only getMatrix() is blended, and only outside fixed updates.
+ */
+class Interpolator {
+private:
+    std::vector<Transform*> m_transforms;
+    float m_alpha = 1.0f;
+
+    Interpolator() = default;
+    friend Interpolator& interpolation();
+    friend class Transform;
+
+    void add(Transform& t) {
+        t.m_interpolation_slot = m_transforms.size();
+        m_transforms.push_back(&t);
+        t.snap();
+    }
+
+    void remove(Transform& t) {
+        Transform* last = m_transforms.back();
+        m_transforms[t.m_interpolation_slot] = last;
+        last->m_interpolation_slot = t.m_interpolation_slot;
+        m_transforms.pop_back();
+        t.m_interpolation_slot = Transform::NOT_INTERPOLATED;
+        if (t.m_alpha < 1.0f) {
+            t.m_alpha = 1.0f;
+            t.trsChanged();
+        }
+    }
+
+public:
+    Interpolator(const Interpolator&) = delete;
+    Interpolator& operator=(const Interpolator&) = delete;
+
+    /**
+     * @brief Saves every interpolated transform's values as its previous state,
+     * and shows the current values while the fixed update runs.
+     */
+    void beginStep() {
+        for (Transform* t : m_transforms) {
+            t->m_previous_position = t->m_position;
+            t->m_previous_rotation = t->m_rotation;
+            t->m_previous_scaling = t->m_scaling;
+            if (t->m_alpha < 1.0f) {
+                t->m_alpha = 1.0f;
+                t->trsChanged();
+            }
+        }
+        m_alpha = 1.0f;
+    }
+
+    /**
+     * @brief Blends every transform that moved in the last fixed update by `alpha` (0 to 1).
+     * Transforms at rest are left untouched.
+     */
+    void setAlpha(float alpha) {
+        m_alpha = glm::clamp(alpha, 0.0f, 1.0f);
+        for (Transform* t : m_transforms) {
+            if (!t->m_trs || t->m_alpha == m_alpha) {
+                continue;
+            }
+            if (t->m_previous_position != t->m_position || t->m_previous_rotation != t->m_rotation ||
+                t->m_previous_scaling != t->m_scaling) {
+                t->m_alpha = m_alpha;
+                t->trsChanged();
+            }
+        }
+    }
+
+    float getAlpha() const { return m_alpha; }
+    size_t size() const { return m_transforms.size(); }
+};
+
+/**
+ * @brief Gets the registry of interpolated transforms.
+ * @note Never destroyed, so transforms held by other static objects (e.g. scene::graph()) can still unregister at exit.
+ */
+inline Interpolator& interpolation() {
+    static Interpolator* instance = new Interpolator();
+    return *instance;
+}
+
+inline Transform::~Transform() {
+    if (isInterpolated()) {
+        interpolation().remove(*this);
+    }
+}
+
+inline void Transform::ensureMatrix() {
+    if (!m_trs) {
+        return;
+    }
+    if (isInterpolated()) {
+        interpolation().remove(*this);  // Only TRS transforms can be blended
+    }
+    getMatrix();
+    m_trs = false;
+}
+
+inline Transform& Transform::setInterpolated(bool interpolated) {
+    if (interpolated == isInterpolated()) {
+        return *this;
+    }
+    if (interpolated) {
+        ensureTRS();
+        interpolation().add(*this);
+    } else {
+        interpolation().remove(*this);
+    }
+    return *this;
+}
+
 TransformStackPtr stack();
 
 class TransformStack {
@@ -134,7 +505,9 @@ public:
     ~TransformStack() = default;
 
     void push(const glm::mat4& matrix_to_apply) {
-        stack.push_back(top() * matrix_to_apply);
+        glm::mat4 combined;
+        simd::multiply(top(), matrix_to_apply, combined);
+        stack.push_back(combined);
     }
 
     void pop() {
@@ -35,9 +35,7 @@ protected:
         : ShaderResource(std::move(name), UpdateMode::ON_DEMAND, bindingPoint)
     {
         // Initial buffer creation with no data.
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer_id);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_binding_point, m_buffer_id);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        gl_state::cache()->bindBufferBase(GL_SHADER_STORAGE_BUFFER, m_binding_point, m_buffer_id);
     }
 
 public:
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "../gl_includes.h"
+#include "../gl_state.h"
 #include <memory>
 #include <string>
 
@@ -60,6 +61,7 @@ public:
     virtual ~ShaderResource() {
         if (m_buffer_id != 0) {
             glDeleteBuffers(1, &m_buffer_id);
+            gl_state::cache()->onBufferDeleted(m_buffer_id);
         }
     }
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "shader_resource.h"
+#include "../frame_stats.h"
 #include <functional>
 #include <vector>
 #include <type_traits>
@@ -40,6 +41,9 @@ protected:
     std::function<T()> m_full_provider;
     std::function<DirtyRegion(T& data)> m_partial_provider;
 
+    // CPU copy handed to the partial provider; keeps the previous update's contents
+    T m_staging{};
+
     /**
      * @brief Constructs the StructResource, allocating its GPU memory.
      * @param name A unique name for this resource.
@@ -51,12 +55,11 @@ protected:
         : ShaderResource(std::move(name), mode, bindingPoint),
           m_buffer_type(bufferType)
     {
-        glBindBuffer(m_buffer_type, m_buffer_id);
+        gl_state::cache()->bindBuffer(m_buffer_type, m_buffer_id);
         // Allocate a fixed-size block of memory on the GPU.
         glBufferData(m_buffer_type, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
         // Bind the buffer to the specified indexed binding point.
-        glBindBufferBase(m_buffer_type, m_binding_point, m_buffer_id);
-        glBindBuffer(m_buffer_type, 0);
+        gl_state::cache()->bindBufferBase(m_buffer_type, m_binding_point, m_buffer_id);
     }
 
 public:
@@ -87,7 +90,7 @@ public:
             return; // No provider set, nothing to do.
         }
         GL_CHECK("apply struct resource pre bind buffer");
-        glBindBuffer(m_buffer_type, m_buffer_id);
+        gl_state::cache()->bindBuffer(m_buffer_type, m_buffer_id);
         GL_CHECK("apply struct resource post bind buffer");
 
         if (m_full_provider) {
@@ -95,20 +98,16 @@ public:
             GL_CHECK("apply struct resource pre full update");
             glBufferSubData(m_buffer_type, 0, sizeof(T), &data);
             GL_CHECK("apply struct resource post full update");
+            stats::current().ubo_bytes += sizeof(T);
         } else if (m_partial_provider) {
-            // Use a stack-allocated buffer for efficiency if small, else heap.
-            std::vector<char> temp_buffer(sizeof(T));
-            T& typed_data = *reinterpret_cast<T*>(temp_buffer.data());
-            
-            DirtyRegion region = m_partial_provider(typed_data);
+            DirtyRegion region = m_partial_provider(m_staging);
             
             if (region.size > 0) {
                 glBufferSubData(m_buffer_type, region.offset, region.size, 
-                                temp_buffer.data() + region.offset);
+                                reinterpret_cast<const char*>(&m_staging) + region.offset);
+                stats::current().ubo_bytes += region.size;
             }
         }
-
-        glBindBuffer(m_buffer_type, 0);
     }
 };
 
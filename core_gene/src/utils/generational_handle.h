@@ -0,0 +1,153 @@
+#ifndef GENERATIONAL_HANDLE_H
+#define GENERATIONAL_HANDLE_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+/**
+ * @file generational_handle.h
+ * @brief 32-bit generational handles and the slot index allocator behind them
+ *
+ * A handle names a slot index plus the generation of the slot's occupant.
+ * Releasing a slot bumps its generation, so handles to the old occupant stop
+ * resolving even after the index is reused. Used by the scene graph's
+ * NodePool (node::NodeHandle) and by the ECS world (ecs::Entity).
+ */
+
+namespace generational {
+
+/**
+ * @struct Handle
+ * @brief 32-bit generational reference (24-bit index, 8-bit generation)
+ * @tparam Tag Distinguishes handle types, so a NodeHandle is not an Entity
+ *
+ * Generations start at 1, so a default-constructed handle (value 0) is invalid.
+ */
+template <typename Tag>
+struct Handle {
+    uint32_t value = 0;
+
+    static constexpr uint32_t INDEX_BITS = 24;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    static Handle Make(uint32_t index, uint8_t generation) {
+        return Handle{(static_cast<uint32_t>(generation) << INDEX_BITS) | index};
+    }
+
+    uint32_t index() const { return value & INDEX_MASK; }
+    uint8_t generation() const { return static_cast<uint8_t>(value >> INDEX_BITS); }
+    bool isValid() const { return value != 0; }
+
+    bool operator==(const Handle& other) const { return value == other.value; }
+    bool operator!=(const Handle& other) const { return value != other.value; }
+};
+
+/**
+ * @class IndexAllocator
+ * @brief Hands out slot indices and keeps the generation of each one
+ *
+ * Two rules keep a stale handle from resolving to an unrelated object:
+ * - Released indices are reused first-in first-out, and only while more than
+ *   MIN_FREE of them are waiting. A create/destroy loop therefore cycles
+ *   through at least MIN_FREE slots instead of hammering one.
+ * - A slot whose 8-bit generation would wrap is retired and never handed out
+ *   again. Its handles can then never match a newer occupant. This costs one
+ *   slot per 255 releases of it, which only matters for programs that churn
+ *   millions of objects.
+ *
+ * New indices are appended in order, so objects created one after the other
+ * get adjacent slots. Acquiring and releasing do not allocate once the free
+ * queue has reached its largest size.
+ */
+class IndexAllocator {
+public:
+    static constexpr uint32_t MAX_INDICES = Handle<void>::INDEX_MASK;
+    static constexpr size_t MIN_FREE = 1024;  ///< Free slots kept waiting before one is reused
+
+private:
+    std::vector<uint8_t> m_generations;  // 0 marks a retired slot
+    std::vector<uint32_t> m_free;        // FIFO: pops at m_free_head, pushes at the back
+    size_t m_free_head = 0;
+
+    uint32_t popFree() {
+        uint32_t index = m_free[m_free_head++];
+        if (m_free_head == m_free.size()) {
+            m_free.clear();
+            m_free_head = 0;
+        } else if (m_free_head >= MIN_FREE && m_free_head * 2 >= m_free.size()) {
+            m_free.erase(m_free.begin(), m_free.begin() + static_cast<std::ptrdiff_t>(m_free_head));
+            m_free_head = 0;
+        }
+        return index;
+    }
+
+public:
+    /**
+     * @brief Takes the oldest free index, or a new one equal to size().
+     * @throws std::bad_alloc when all MAX_INDICES indices are in use or retired.
+     */
+    uint32_t acquire() {
+        const size_t waiting = m_free.size() - m_free_head;
+        if (waiting > MIN_FREE || (waiting > 0 && m_generations.size() >= MAX_INDICES)) {
+            return popFree();
+        }
+        if (m_generations.size() >= MAX_INDICES) {
+            throw std::bad_alloc();
+        }
+        m_generations.push_back(1);
+        return static_cast<uint32_t>(m_generations.size() - 1);
+    }
+
+    /**
+     * @brief Bumps the generation of an index, so its handles stop matching.
+     * The index is not reusable until recycle(); on wrap it is retired instead.
+     */
+    void invalidate(uint32_t index) {
+        if (m_generations[index] != 0) {
+            m_generations[index] = static_cast<uint8_t>(m_generations[index] + 1);
+        }
+    }
+
+    /** @brief Queues an invalidated index for reuse, unless it is retired */
+    void recycle(uint32_t index) {
+        if (m_generations[index] != 0) {
+            m_free.push_back(index);
+        }
+    }
+
+    /** @brief invalidate() then recycle() */
+    void release(uint32_t index) {
+        invalidate(index);
+        recycle(index);
+    }
+
+    /**
+     * @brief Invalidates every index and queues all of them, in index order.
+     * Only valid when no index is held anymore.
+     */
+    void releaseAll() {
+        m_free.clear();
+        m_free_head = 0;
+        for (uint32_t index = 0; index < m_generations.size(); ++index) {
+            release(index);
+        }
+    }
+
+    /** @brief Current generation of an index (0 if retired) */
+    uint8_t generation(uint32_t index) const { return m_generations[index]; }
+
+    /** @brief Whether a handle's index and generation name the current occupant */
+    bool matches(uint32_t index, uint8_t generation) const {
+        return index < m_generations.size() && generation != 0 && m_generations[index] == generation;
+    }
+
+    /** @brief Indices handed out so far (in use, free or retired) */
+    size_t size() const { return m_generations.size(); }
+};
+
+} // namespace generational
+
+#endif // GENERATIONAL_HANDLE_H
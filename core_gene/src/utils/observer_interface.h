@@ -4,23 +4,44 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstddef>
 
 // Forward-declare the Subject so the Observer knows about it.
 class ISubject;
 
+namespace observer {
+class NotificationQueue;
+NotificationQueue& queue();
+}
+
 /**
  * @class IObserver
  * @brief Represents an object that listens for notifications from an ISubject.
+ *
+ * An observer remembers the subjects it is subscribed to, so a subject can
+ * drop it in constant time and it unsubscribes itself when destroyed.
  */
 class IObserver {
 public:
-    virtual ~IObserver() = default;
+    IObserver() = default;
+    IObserver(const IObserver&) {}  // Subscriptions are not copied
+    IObserver& operator=(const IObserver&) { return *this; }
+    virtual ~IObserver();
 
     /**
      * @brief The function called by an ISubject when it notifies its observers.
      * @param subject A pointer to the subject that triggered the notification.
      */
     virtual void onNotify(const ISubject* subject) = 0;
+
+private:
+    friend class ISubject;
+
+    struct Subscription {
+        ISubject* subject;
+        size_t slot;  // Index of this observer in subject->m_observers
+    };
+    std::vector<Subscription> m_subscriptions;
 };
 
 
@@ -28,42 +49,206 @@ public:
  * @class ISubject
  * @brief Represents an object that can be observed. It maintains a list of
  * IObservers and notifies them of changes.
+ *
+ * notify() calls every observer right away. notifyDeferred() only queues the
+ * subject; observer::flush() then notifies each queued subject's observers
+ * once, however many times it was changed since the last flush. Adding and
+ * removing observers take constant time; observers are not notified in any
+ * particular order.
  */
 class ISubject {
 public:
-    virtual ~ISubject() = default;
+    ISubject() = default;
+    ISubject(const ISubject&) {}  // Observers are not copied
+    ISubject& operator=(const ISubject&) { return *this; }
+    virtual ~ISubject();
 
     /**
-     * @brief Subscribes an observer to receive notifications.
+     * @brief Subscribes an observer to receive notifications. Subscribing twice has no effect.
      */
     void addObserver(IObserver* observer) {
-        if (observer) {
-            m_observers.push_back(observer);
+        if (!observer || findSubscription(observer) != NO_INDEX) {
+            return;
         }
+        observer->m_subscriptions.push_back({this, m_observers.size()});
+        m_observers.push_back({observer, observer->m_subscriptions.size() - 1});
     }
 
     /**
      * @brief Unsubscribes an observer from receiving notifications.
      */
     void removeObserver(IObserver* observer) {
-        m_observers.erase(
-            std::remove(m_observers.begin(), m_observers.end(), observer),
-            m_observers.end()
-        );
+        if (!observer) {
+            return;
+        }
+        const size_t subscription = findSubscription(observer);
+        if (subscription != NO_INDEX) {
+            unlink(observer, observer->m_subscriptions[subscription].slot);
+        }
     }
 
+    bool hasObservers() const { return !m_observers.empty(); }
+
 protected:
     /**
      * @brief Notifies all registered observers by calling their onNotify method.
+     * Observers may unsubscribe while being notified.
      */
     void notify() {
-        for (IObserver* observer : m_observers) {
-            observer->onNotify(this);
+        for (size_t i = m_observers.size(); i-- > 0;) {
+            if (i < m_observers.size()) {
+                m_observers[i].observer->onNotify(this);
+            }
         }
     }
 
+    /**
+     * @brief Queues one notification for the next observer::flush().
+     * Does nothing if the subject is already queued or has no observers.
+     */
+    inline void notifyDeferred();
+
 private:
-    std::vector<IObserver*> m_observers;
+    friend class IObserver;
+    friend class observer::NotificationQueue;
+
+    using Subscription = IObserver::Subscription;
+
+    static constexpr size_t NO_INDEX = static_cast<size_t>(-1);
+
+    struct Link {
+        IObserver* observer;
+        size_t slot;  // Index of this subject in observer->m_subscriptions
+    };
+    std::vector<Link> m_observers;
+    size_t m_queue_index = NO_INDEX;
+
+    // Index into observer->m_subscriptions, or NO_INDEX; an observer watches only a few subjects
+    size_t findSubscription(const IObserver* observer) const {
+        const auto& subscriptions = observer->m_subscriptions;
+        for (size_t i = 0; i < subscriptions.size(); ++i) {
+            if (subscriptions[i].subject == this) {
+                return i;
+            }
+        }
+        return NO_INDEX;
+    }
+
+    // Removes m_observers[slot] and its back link, moving the last entry of each list into the hole
+    void unlink(IObserver* observer, size_t slot) {
+        const size_t subscription = m_observers[slot].slot;
+        auto& subscriptions = observer->m_subscriptions;
+        if (subscription + 1 != subscriptions.size()) {
+            subscriptions[subscription] = subscriptions.back();
+            const Subscription& moved = subscriptions[subscription];
+            moved.subject->m_observers[moved.slot].slot = subscription;
+        }
+        subscriptions.pop_back();
+
+        if (slot + 1 != m_observers.size()) {
+            m_observers[slot] = m_observers.back();
+            m_observers[slot].observer->m_subscriptions[m_observers[slot].slot].slot = slot;
+        }
+        m_observers.pop_back();
+    }
 };
 
+namespace observer {
+
+/**
+ * @class NotificationQueue
+ * @brief Subjects with a pending notifyDeferred(), in the order they were first changed
+ *
+ * Used from the thread that changes the subjects (usually the main thread).
+ */
+class NotificationQueue {
+private:
+    std::vector<ISubject*> m_pending;  // Destroyed subjects leave a nullptr
+    size_t m_cursor = 0;
+    bool m_flushing = false;
+
+    friend class ::ISubject;
+
+    void push(ISubject& subject) {
+        subject.m_queue_index = m_pending.size();
+        m_pending.push_back(&subject);
+    }
+
+    void cancel(ISubject& subject) {
+        m_pending[subject.m_queue_index] = nullptr;
+        subject.m_queue_index = ISubject::NO_INDEX;
+    }
+
+public:
+    /**
+     * @brief Notifies the observers of every queued subject, once per subject.
+     * Subjects changed by an observer during the flush are notified in the same flush.
+     */
+    void flush() {
+        if (m_cursor == m_pending.size()) {
+            return;
+        }
+        const bool outermost = !m_flushing;
+        m_flushing = true;
+        while (m_cursor < m_pending.size()) {
+            ISubject* subject = m_pending[m_cursor++];
+            if (subject) {
+                subject->m_queue_index = ISubject::NO_INDEX;
+                subject->notify();
+            }
+        }
+        // A flush started from an observer leaves the cleanup to the outermost one
+        if (outermost) {
+            m_pending.clear();
+            m_cursor = 0;
+            m_flushing = false;
+        }
+    }
+
+    size_t pending() const { return m_pending.size() - m_cursor; }
+};
+
+/**
+ * @brief Gets the queue of deferred notifications.
+ * @note Never destroyed, so subjects owned by other static objects can still cancel() at exit.
+ */
+inline NotificationQueue& queue() {
+    static NotificationQueue* instance = new NotificationQueue();
+    return *instance;
+}
+
+/**
+ * @brief Delivers every pending notifyDeferred() notification.
+ *
+ * scene::updateWorldTransforms() and ObservedTransformComponent::getWorldTransform()
+ * call this first, so transform changes are always seen before world matrices are read.
+ */
+inline void flush() {
+    queue().flush();
+}
+
+} // namespace observer
+
+inline void ISubject::notifyDeferred() {
+    if (m_queue_index == NO_INDEX && !m_observers.empty()) {
+        observer::queue().push(*this);
+    }
+}
+
+inline ISubject::~ISubject() {
+    if (m_queue_index != NO_INDEX) {
+        observer::queue().cancel(*this);
+    }
+    while (!m_observers.empty()) {
+        unlink(m_observers.back().observer, m_observers.size() - 1);
+    }
+}
+
+inline IObserver::~IObserver() {
+    while (!m_subscriptions.empty()) {
+        const Subscription& last = m_subscriptions.back();
+        last.subject->unlink(this, last.slot);
+    }
+}
+
 #endif // OBSERVER_INTERFACES_H
@@ -0,0 +1,447 @@
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+/**
+ * @file simd_math.h
+ * @brief SSE2/AVX2/NEON kernels for the mat4 and vec4 math on per-node and per-entity paths
+ *
+ * Single operations (multiply(), transform(), affineInverse(), normalMatrix())
+ * are inline and use the instruction set the translation unit is compiled for:
+ * SSE2 on every x86-64 target, NEON on ARM64, glm otherwise. They have no call
+ * overhead, so TransformStack::push() and the world transform passes use them
+ * directly.
+ *
+ * Batched operations over arrays pick a kernel once, at first use, from the
+ * CPU's features: AVX2+FMA when the CPU has it (even if the program was not
+ * built with -mavx2), then SSE2 or NEON, then glm.
+ *
+ * All matrices are glm's column-major layout and need no particular alignment.
+ */
+
+/**
+ * @brief Set to 0 to use plain glm for everything (default 1).
+ */
+#ifndef ENGENE_SIMD
+    #define ENGENE_SIMD 1
+#endif
+
+#if ENGENE_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define ENGENE_SIMD_SSE2 1
+    #include <emmintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #include <immintrin.h>
+        #define ENGENE_SIMD_AVX2 1
+        #define ENGENE_SIMD_AVX2_TARGET __attribute__((target("avx2,fma")))
+    #elif defined(_MSC_VER)
+        #include <immintrin.h>
+        #include <intrin.h>
+        #define ENGENE_SIMD_AVX2 1
+        #define ENGENE_SIMD_AVX2_TARGET
+    #endif
+#elif ENGENE_SIMD && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64))
+    #define ENGENE_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace simd {
+
+/**
+ * @struct CpuFeatures
+ * @brief Instruction sets the running CPU (and OS) supports
+ */
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;  ///< AVX2 and FMA, with the OS saving the YMM registers
+    bool neon = false;
+};
+
+/**
+ * @brief Detects the CPU's features once.
+ */
+inline const CpuFeatures& cpu() {
+    static const CpuFeatures features = [] {
+        CpuFeatures f;
+#if defined(ENGENE_SIMD_SSE2)
+        f.sse2 = true;
+    #if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        f.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    #elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        f.avx2 = fma && os_saves_ymm && (info[1] & (1 << 5)) != 0;
+    #endif
+#elif defined(ENGENE_SIMD_NEON)
+        f.neon = true;
+#endif
+        return f;
+    }();
+    return features;
+}
+
+namespace detail {
+
+inline float* data(glm::mat4& m) { return &m[0][0]; }
+inline const float* data(const glm::mat4& m) { return &m[0][0]; }
+inline float* data(glm::vec4& v) { return &v[0]; }
+inline const float* data(const glm::vec4& v) { return &v[0]; }
+
+#if defined(ENGENE_SIMD_SSE2)
+
+template <int Lane>
+inline __m128 splat(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+}
+
+// a0..a3 * (x, y, z, w) of v
+inline __m128 combine(__m128 a0, __m128 a1, __m128 a2, __m128 a3, __m128 v) {
+    __m128 r = _mm_mul_ps(a0, splat<0>(v));
+    r = _mm_add_ps(r, _mm_mul_ps(a1, splat<1>(v)));
+    r = _mm_add_ps(r, _mm_mul_ps(a2, splat<2>(v)));
+    return _mm_add_ps(r, _mm_mul_ps(a3, splat<3>(v)));
+}
+
+inline __m128 cross3(__m128 a, __m128 b) {
+    const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+inline __m128 dot3(__m128 a, __m128 b) {
+    const __m128 p = _mm_mul_ps(a, b);
+    return _mm_add_ps(_mm_add_ps(splat<0>(p), splat<1>(p)), splat<2>(p));
+}
+
+#elif defined(ENGENE_SIMD_NEON)
+
+inline float32x4_t combine(float32x4_t a0, float32x4_t a1, float32x4_t a2, float32x4_t a3, float32x4_t v) {
+    float32x4_t r = vmulq_n_f32(a0, vgetq_lane_f32(v, 0));
+    r = vmlaq_n_f32(r, a1, vgetq_lane_f32(v, 1));
+    r = vmlaq_n_f32(r, a2, vgetq_lane_f32(v, 2));
+    return vmlaq_n_f32(r, a3, vgetq_lane_f32(v, 3));
+}
+
+#endif
+
+/**
+ * @brief Rows of the inverse of m's upper 3x3: (c1 x c2, c2 x c0, c0 x c1) / det.
+ */
+inline void cofactorRows(const glm::mat4& m, glm::vec3 rows[3]) {
+    const glm::vec3 c0(m[0]);
+    const glm::vec3 c1(m[1]);
+    const glm::vec3 c2(m[2]);
+    rows[0] = glm::cross(c1, c2);
+    rows[1] = glm::cross(c2, c0);
+    rows[2] = glm::cross(c0, c1);
+    const float inv_det = 1.0f / glm::dot(c0, rows[0]);
+    rows[0] *= inv_det;
+    rows[1] *= inv_det;
+    rows[2] *= inv_det;
+}
+
+} // namespace detail
+
+// --- Single operations (compile-time instruction set) ---
+
+/**
+ * @brief out = a * b. `out` may be `a` or `b`.
+ */
+inline void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#if defined(ENGENE_SIMD_SSE2)
+    const float* pa = detail::data(a);
+    const float* pb = detail::data(b);
+    const __m128 a0 = _mm_loadu_ps(pa), a1 = _mm_loadu_ps(pa + 4), a2 = _mm_loadu_ps(pa + 8), a3 = _mm_loadu_ps(pa + 12);
+    const __m128 b0 = _mm_loadu_ps(pb), b1 = _mm_loadu_ps(pb + 4), b2 = _mm_loadu_ps(pb + 8), b3 = _mm_loadu_ps(pb + 12);
+    float* po = detail::data(out);
+    _mm_storeu_ps(po, detail::combine(a0, a1, a2, a3, b0));
+    _mm_storeu_ps(po + 4, detail::combine(a0, a1, a2, a3, b1));
+    _mm_storeu_ps(po + 8, detail::combine(a0, a1, a2, a3, b2));
+    _mm_storeu_ps(po + 12, detail::combine(a0, a1, a2, a3, b3));
+#elif defined(ENGENE_SIMD_NEON)
+    const float* pa = detail::data(a);
+    const float* pb = detail::data(b);
+    const float32x4_t a0 = vld1q_f32(pa), a1 = vld1q_f32(pa + 4), a2 = vld1q_f32(pa + 8), a3 = vld1q_f32(pa + 12);
+    const float32x4_t b0 = vld1q_f32(pb), b1 = vld1q_f32(pb + 4), b2 = vld1q_f32(pb + 8), b3 = vld1q_f32(pb + 12);
+    float* po = detail::data(out);
+    vst1q_f32(po, detail::combine(a0, a1, a2, a3, b0));
+    vst1q_f32(po + 4, detail::combine(a0, a1, a2, a3, b1));
+    vst1q_f32(po + 8, detail::combine(a0, a1, a2, a3, b2));
+    vst1q_f32(po + 12, detail::combine(a0, a1, a2, a3, b3));
+#else
+    out = a * b;
+#endif
+}
+
+inline glm::mat4 multiply(const glm::mat4& a, const glm::mat4& b) {
+    glm::mat4 out;
+    multiply(a, b, out);
+    return out;
+}
+
+/**
+ * @brief m * v.
+ */
+inline glm::vec4 transform(const glm::mat4& m, const glm::vec4& v) {
+#if defined(ENGENE_SIMD_SSE2)
+    const float* pm = detail::data(m);
+    glm::vec4 out;
+    _mm_storeu_ps(detail::data(out), detail::combine(_mm_loadu_ps(pm), _mm_loadu_ps(pm + 4), _mm_loadu_ps(pm + 8),
+                                                     _mm_loadu_ps(pm + 12), _mm_loadu_ps(detail::data(v))));
+    return out;
+#elif defined(ENGENE_SIMD_NEON)
+    const float* pm = detail::data(m);
+    glm::vec4 out;
+    vst1q_f32(detail::data(out), detail::combine(vld1q_f32(pm), vld1q_f32(pm + 4), vld1q_f32(pm + 8),
+                                                 vld1q_f32(pm + 12), vld1q_f32(detail::data(v))));
+    return out;
+#else
+    return m * v;
+#endif
+}
+
+/**
+ * @brief m * (p, 1), without the projective divide.
+ */
+inline glm::vec3 transformPoint(const glm::mat4& m, const glm::vec3& p) {
+    return glm::vec3(transform(m, glm::vec4(p, 1.0f)));
+}
+
+/**
+ * @brief m * (d, 0): rotates and scales a direction, ignoring translation.
+ */
+inline glm::vec3 transformDirection(const glm::mat4& m, const glm::vec3& d) {
+    return glm::vec3(transform(m, glm::vec4(d, 0.0f)));
+}
+
+/**
+ * @brief Inverse of an affine matrix (bottom row 0, 0, 0, 1), such as a model or view matrix.
+ * Cheaper than glm::inverse(); wrong for projections.
+ */
+inline glm::mat4 affineInverse(const glm::mat4& m) {
+#if defined(ENGENE_SIMD_SSE2)
+    const float* pm = detail::data(m);
+    const __m128 c0 = _mm_loadu_ps(pm), c1 = _mm_loadu_ps(pm + 4), c2 = _mm_loadu_ps(pm + 8), c3 = _mm_loadu_ps(pm + 12);
+    __m128 r0 = detail::cross3(c1, c2);
+    __m128 r1 = detail::cross3(c2, c0);
+    __m128 r2 = detail::cross3(c0, c1);
+    const __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), detail::dot3(c0, r0));
+    r0 = _mm_mul_ps(r0, inv_det);
+    r1 = _mm_mul_ps(r1, inv_det);
+    r2 = _mm_mul_ps(r2, inv_det);
+    __m128 r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);  // Rows of the 3x3 inverse -> columns, with w = 0
+
+    // -(R^-1 * t), then w = 1
+    __m128 t = detail::combine(r0, r1, r2, _mm_setzero_ps(), c3);
+    t = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), t);
+
+    glm::mat4 out;
+    float* po = detail::data(out);
+    _mm_storeu_ps(po, r0);
+    _mm_storeu_ps(po + 4, r1);
+    _mm_storeu_ps(po + 8, r2);
+    _mm_storeu_ps(po + 12, t);
+    return out;
+#else
+    glm::vec3 rows[3];
+    detail::cofactorRows(m, rows);
+    glm::mat4 out(1.0f);
+    for (int column = 0; column < 3; ++column) {
+        out[column] = glm::vec4(rows[0][column], rows[1][column], rows[2][column], 0.0f);
+    }
+    const glm::vec3 t(m[3]);
+    out[3] = glm::vec4(-glm::dot(rows[0], t), -glm::dot(rows[1], t), -glm::dot(rows[2], t), 1.0f);
+    return out;
+#endif
+}
+
+/**
+ * @brief transpose(inverse(mat3(m))): transforms normals by the model matrix m.
+ */
+inline glm::mat3 normalMatrix(const glm::mat4& m) {
+    // The inverse-transpose's columns are the cofactor rows of the inverse
+#if defined(ENGENE_SIMD_SSE2)
+    const float* pm = detail::data(m);
+    const __m128 c0 = _mm_loadu_ps(pm), c1 = _mm_loadu_ps(pm + 4), c2 = _mm_loadu_ps(pm + 8);
+    const __m128 r0 = detail::cross3(c1, c2);
+    const __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), detail::dot3(c0, r0));
+    float columns[3][4];
+    _mm_storeu_ps(columns[0], _mm_mul_ps(r0, inv_det));
+    _mm_storeu_ps(columns[1], _mm_mul_ps(detail::cross3(c2, c0), inv_det));
+    _mm_storeu_ps(columns[2], _mm_mul_ps(detail::cross3(c0, c1), inv_det));
+    return glm::mat3(glm::vec3(columns[0][0], columns[0][1], columns[0][2]),
+                     glm::vec3(columns[1][0], columns[1][1], columns[1][2]),
+                     glm::vec3(columns[2][0], columns[2][1], columns[2][2]));
+#else
+    glm::vec3 rows[3];
+    detail::cofactorRows(m, rows);
+    return glm::mat3(rows[0], rows[1], rows[2]);
+#endif
+}
+
+// --- Batched operations (runtime dispatch) ---
+
+namespace detail {
+
+struct Kernels {
+    const char* name;
+    void (*multiply)(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count);
+    void (*transform)(const glm::mat4& m, const glm::vec4* in, glm::vec4* out, size_t count);
+    void (*transformPoints)(const glm::mat4& m, const glm::vec3* in, glm::vec3* out, size_t count);
+};
+
+inline void multiplyScalar(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a * b[i];
+    }
+}
+
+inline void transformScalar(const glm::mat4& m, const glm::vec4* in, glm::vec4* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = m * in[i];
+    }
+}
+
+inline void transformPointsScalar(const glm::mat4& m, const glm::vec3* in, glm::vec3* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = glm::vec3(m * glm::vec4(in[i], 1.0f));
+    }
+}
+
+#if defined(ENGENE_SIMD_SSE2) || defined(ENGENE_SIMD_NEON)
+
+inline void multiplyVector(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        simd::multiply(a, b[i], out[i]);
+    }
+}
+
+inline void transformVector(const glm::mat4& m, const glm::vec4* in, glm::vec4* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = simd::transform(m, in[i]);
+    }
+}
+
+inline void transformPointsVector(const glm::mat4& m, const glm::vec3* in, glm::vec3* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = simd::transformPoint(m, in[i]);
+    }
+}
+
+#endif
+
+#if defined(ENGENE_SIMD_AVX2)
+
+// Both 128-bit lanes hold the same column of `a`; each lane works on one column of b[i]
+ENGENE_SIMD_AVX2_TARGET
+inline void multiplyAvx2(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+    const float* pa = data(a);
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa));
+    const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 4));
+    const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 8));
+    const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 12));
+    for (size_t i = 0; i < count; ++i) {
+        const float* pb = data(b[i]);
+        const __m256 b01 = _mm256_loadu_ps(pb);
+        const __m256 b23 = _mm256_loadu_ps(pb + 8);
+
+        __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+        r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55), r01);
+        r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xAA), r01);
+        r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, 0xFF), r01);
+
+        __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+        r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55), r23);
+        r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xAA), r23);
+        r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, 0xFF), r23);
+
+        float* po = data(out[i]);
+        _mm256_storeu_ps(po, r01);
+        _mm256_storeu_ps(po + 8, r23);
+    }
+}
+
+// Two vectors per iteration, one per 128-bit lane
+ENGENE_SIMD_AVX2_TARGET
+inline void transformAvx2(const glm::mat4& m, const glm::vec4* in, glm::vec4* out, size_t count) {
+    const float* pm = data(m);
+    const __m256 m0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pm));
+    const __m256 m1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pm + 4));
+    const __m256 m2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pm + 8));
+    const __m256 m3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pm + 12));
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m256 v = _mm256_loadu_ps(data(in[i]));
+        __m256 r = _mm256_mul_ps(m0, _mm256_permute_ps(v, 0x00));
+        r = _mm256_fmadd_ps(m1, _mm256_permute_ps(v, 0x55), r);
+        r = _mm256_fmadd_ps(m2, _mm256_permute_ps(v, 0xAA), r);
+        r = _mm256_fmadd_ps(m3, _mm256_permute_ps(v, 0xFF), r);
+        _mm256_storeu_ps(data(out[i]), r);
+    }
+    for (; i < count; ++i) {
+        out[i] = simd::transform(m, in[i]);
+    }
+}
+
+#endif
+
+inline const Kernels& kernels() {
+    static const Kernels selected = [] {
+#if defined(ENGENE_SIMD_AVX2)
+        if (cpu().avx2) {
+            return Kernels{"avx2", &multiplyAvx2, &transformAvx2, &transformPointsVector};
+        }
+#endif
+#if defined(ENGENE_SIMD_SSE2)
+        return Kernels{"sse2", &multiplyVector, &transformVector, &transformPointsVector};
+#elif defined(ENGENE_SIMD_NEON)
+        return Kernels{"neon", &multiplyVector, &transformVector, &transformPointsVector};
+#else
+        return Kernels{"scalar", &multiplyScalar, &transformScalar, &transformPointsScalar};
+#endif
+    }();
+    return selected;
+}
+
+} // namespace detail
+
+/**
+ * @brief Name of the kernels the batched operations use: "avx2", "sse2", "neon" or "scalar".
+ */
+inline const char* kernelName() {
+    return detail::kernels().name;
+}
+
+/**
+ * @brief out[i] = a * b[i]. `out` may be `b`.
+ */
+inline void multiply(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) {
+    detail::kernels().multiply(a, b, out, count);
+}
+
+/**
+ * @brief out[i] = m * in[i]. `out` may be `in`.
+ */
+inline void transform(const glm::mat4& m, const glm::vec4* in, glm::vec4* out, size_t count) {
+    detail::kernels().transform(m, in, out, count);
+}
+
+/**
+ * @brief out[i] = m * (in[i], 1), e.g. bounding box corners or vertex positions for culling.
+ * `out` may be `in`.
+ */
+inline void transformPoints(const glm::mat4& m, const glm::vec3* in, glm::vec3* out, size_t count) {
+    detail::kernels().transformPoints(m, in, out, count);
+}
+
+} // namespace simd
+
+#endif // SIMD_MATH_H